@@ -0,0 +1,115 @@
+#ifndef FIXED_VECTOR_HPP
+#define FIXED_VECTOR_HPP
+
+#include <array>
+#include <vector>
+#include "../Maze/MazeGeometry.hpp"
+
+namespace Mazemouse {
+
+/**
+ * @brief Owns the slots of a fixed vector.
+ *
+ * The compile-time sized storage keeps the slots inline.
+ */
+template <typename T, int N>
+struct FixedVectorStorage {
+    std::array<T, N> slots{};
+
+    constexpr FixedVectorStorage() = default;
+
+    constexpr explicit FixedVectorStorage(int /* capacity */) {}
+
+    [[nodiscard]] static constexpr int capacity() { return N; }
+};
+
+/**
+ * @brief Runtime-sized storage of a fixed vector, allocated once on
+ * construction.
+ */
+template <typename T>
+struct FixedVectorStorage<T, DYNAMIC_SIZE> {
+    std::vector<T> slots{};
+
+    FixedVectorStorage() = default;
+
+    explicit FixedVectorStorage(const int capacity) : slots(capacity) {}
+
+    [[nodiscard]] int capacity() const {
+        return static_cast<int>(slots.size());
+    }
+};
+
+/**
+ * @brief A sequence with a fixed capacity and the interface of a
+ * `std::vector`.
+ *
+ * The vector never allocates after construction, and copying it into a
+ * vector of the same capacity does not allocate either. Growing it beyond its
+ * capacity, or reading from an empty one, is undefined; callers bound the
+ * number of items, e.g. by the number of cells of the maze.
+ *
+ * @tparam T The item type.
+ * @tparam N The capacity, or `DYNAMIC_SIZE` to choose it at runtime.
+ */
+template <typename T, int N>
+class FixedVector : FixedVectorStorage<T, N> {
+ public:
+    using FixedVectorStorage<T, N>::FixedVectorStorage;
+    using FixedVectorStorage<T, N>::capacity;
+
+    [[nodiscard]] constexpr bool empty() const { return size_ == 0; }
+
+    [[nodiscard]] constexpr int size() const { return size_; }
+
+    [[nodiscard]] constexpr T& operator[](const int i) {
+        return this->slots[i];
+    }
+
+    [[nodiscard]] constexpr const T& operator[](const int i) const {
+        return this->slots[i];
+    }
+
+    [[nodiscard]] constexpr T& back() { return this->slots[size_ - 1]; }
+
+    [[nodiscard]] constexpr const T& back() const {
+        return this->slots[size_ - 1];
+    }
+
+    [[nodiscard]] constexpr T* begin() { return this->slots.data(); }
+
+    [[nodiscard]] constexpr T* end() { return this->slots.data() + size_; }
+
+    [[nodiscard]] constexpr const T* begin() const {
+        return this->slots.data();
+    }
+
+    [[nodiscard]] constexpr const T* end() const {
+        return this->slots.data() + size_;
+    }
+
+    /**
+     * @brief Appends an item, which must fit within the capacity.
+     */
+    constexpr void push_back(const T& item) { this->slots[size_++] = item; }
+
+    /**
+     * @brief Removes the last item; the vector must not be empty.
+     */
+    constexpr void pop_back() { --size_; }
+
+    /**
+     * @brief Changes the number of items. New items keep whatever the slots
+     * held before.
+     */
+    constexpr void resize(const int size) { size_ = size; }
+
+    constexpr void clear() { size_ = 0; }
+
+ private:
+    int size_{ 0 };
+};
+
+}  // namespace Mazemouse
+
+#endif
@@ -0,0 +1,213 @@
+#ifndef INDEXED_HEAP_HPP
+#define INDEXED_HEAP_HPP
+
+#include <array>
+#include <vector>
+#include "../Maze/MazeGeometry.hpp"
+
+namespace Mazemouse {
+
+/**
+ * @brief Owns the arrays of an indexed heap.
+ *
+ * The compile-time sized storage keeps the arrays inline.
+ */
+template <typename K, int N>
+struct IndexedHeapStorage {
+    /**
+     * The items in heap order.
+     */
+    std::array<int, N> heap{};
+
+    /**
+     * The position of every item in `heap`, or -1 if it is not in the heap.
+     */
+    std::array<int, N> positions{};
+
+    /**
+     * The key of every item.
+     */
+    std::array<K, N> keys{};
+
+    constexpr IndexedHeapStorage() { positions.fill(-1); }
+
+    constexpr explicit IndexedHeapStorage(int /* capacity */) :
+        IndexedHeapStorage() {}
+
+    [[nodiscard]] static constexpr int capacity() { return N; }
+};
+
+/**
+ * @brief Runtime-sized storage of an indexed heap, allocated once on
+ * construction.
+ */
+template <typename K>
+struct IndexedHeapStorage<K, DYNAMIC_SIZE> {
+    std::vector<int> heap{};
+
+    std::vector<int> positions{};
+
+    std::vector<K> keys{};
+
+    IndexedHeapStorage() = default;
+
+    explicit IndexedHeapStorage(const int capacity) :
+        heap(capacity), positions(capacity, -1), keys(capacity) {}
+
+    [[nodiscard]] int capacity() const {
+        return static_cast<int>(heap.size());
+    }
+};
+
+/**
+ * @brief A binary min-heap of the items 0 to capacity - 1, each with a key.
+ *
+ * Unlike `std::priority_queue`, every item knows its position in the heap,
+ * so the key of a queued item can be changed in O(log n) instead of queueing
+ * a duplicate. This bounds the heap by its capacity, so it never allocates
+ * after construction. Items with equal keys are popped in an unspecified but
+ * deterministic order.
+ *
+ * @tparam K The key type.
+ * @tparam N The capacity, or `DYNAMIC_SIZE` to choose it at runtime.
+ */
+template <typename K, int N>
+class IndexedHeap : IndexedHeapStorage<K, N> {
+ public:
+    using IndexedHeapStorage<K, N>::IndexedHeapStorage;
+    using IndexedHeapStorage<K, N>::capacity;
+
+    [[nodiscard]] constexpr bool empty() const { return size_ == 0; }
+
+    [[nodiscard]] constexpr int size() const { return size_; }
+
+    [[nodiscard]] constexpr bool contains(const int item) const {
+        return this->positions[item] >= 0;
+    }
+
+    /**
+     * @brief Returns the key an item was last pushed with.
+     */
+    [[nodiscard]] constexpr K keyOf(const int item) const {
+        return this->keys[item];
+    }
+
+    /**
+     * @brief Returns the item with the smallest key; the heap must not be
+     * empty.
+     */
+    [[nodiscard]] constexpr int top() const { return this->heap[0]; }
+
+    /**
+     * @brief Inserts an item, or changes its key if it is already queued.
+     */
+    constexpr void push(int item, K key);
+
+    /**
+     * @brief Removes and returns the item with the smallest key; the heap
+     * must not be empty.
+     */
+    constexpr int pop();
+
+    /**
+     * @brief Removes all items in O(size).
+     */
+    constexpr void clear();
+
+ private:
+    int size_{ 0 };
+
+    constexpr void place(int position, int item);
+
+    constexpr void siftUp(int position);
+
+    constexpr void siftDown(int position);
+};
+
+template <typename K, int N>
+constexpr void IndexedHeap<K, N>::push(const int item, const K key) {
+    if (!contains(item)) {
+        this->keys[item] = key;
+        place(size_++, item);
+        siftUp(size_ - 1);
+        return;
+    }
+
+    const K old_key = this->keys[item];
+    this->keys[item] = key;
+    if (key < old_key) {
+        siftUp(this->positions[item]);
+    } else {
+        siftDown(this->positions[item]);
+    }
+}
+
+template <typename K, int N>
+constexpr int IndexedHeap<K, N>::pop() {
+    const int item = this->heap[0];
+    this->positions[item] = -1;
+
+    if (--size_ > 0) {
+        place(0, this->heap[size_]);
+        siftDown(0);
+    }
+
+    return item;
+}
+
+template <typename K, int N>
+constexpr void IndexedHeap<K, N>::clear() {
+    for (int i = 0; i < size_; ++i) {
+        this->positions[this->heap[i]] = -1;
+    }
+    size_ = 0;
+}
+
+template <typename K, int N>
+constexpr void IndexedHeap<K, N>::place(const int position, const int item) {
+    this->heap[position] = item;
+    this->positions[item] = position;
+}
+
+template <typename K, int N>
+constexpr void IndexedHeap<K, N>::siftUp(int position) {
+    const int item = this->heap[position];
+    const K key = this->keys[item];
+
+    while (position > 0) {
+        const int parent = (position - 1) / 2;
+        if (!(key < this->keys[this->heap[parent]])) {
+            break;
+        }
+        place(position, this->heap[parent]);
+        position = parent;
+    }
+    place(position, item);
+}
+
+template <typename K, int N>
+constexpr void IndexedHeap<K, N>::siftDown(int position) {
+    const int item = this->heap[position];
+    const K key = this->keys[item];
+
+    while (true) {
+        int child = 2 * position + 1;
+        if (child >= size_) {
+            break;
+        }
+        if (child + 1 < size_ &&
+            this->keys[this->heap[child + 1]] < this->keys[this->heap[child]]) {
+            ++child;
+        }
+        if (!(this->keys[this->heap[child]] < key)) {
+            break;
+        }
+        place(position, this->heap[child]);
+        position = child;
+    }
+    place(position, item);
+}
+
+}  // namespace Mazemouse
+
+#endif
@@ -0,0 +1,119 @@
+#ifndef PACKED_DIRS_HPP
+#define PACKED_DIRS_HPP
+
+#include <array>
+#include <cstdint>
+#include <vector>
+#include "../Maze/Dir4.hpp"
+#include "../Maze/MazeGeometry.hpp"
+
+namespace Mazemouse {
+
+/**
+ * @brief Owns the bytes of a packed direction sequence.
+ *
+ * The compile-time sized storage keeps the bytes inline.
+ */
+template <int N>
+struct PackedDirsStorage {
+    std::array<std::uint8_t, (N + 3) / 4> bytes{};
+
+    constexpr PackedDirsStorage() = default;
+
+    constexpr explicit PackedDirsStorage(int /* capacity */) {}
+
+    [[nodiscard]] static constexpr int capacity() { return N; }
+};
+
+/**
+ * @brief Runtime-sized storage of a packed direction sequence, allocated
+ * once on construction.
+ */
+template <>
+struct PackedDirsStorage<DYNAMIC_SIZE> {
+    std::vector<std::uint8_t> bytes{};
+
+    PackedDirsStorage() = default;
+
+    explicit PackedDirsStorage(const int capacity) :
+        bytes((capacity + 3) / 4), capacity_(capacity) {}
+
+    [[nodiscard]] int capacity() const { return capacity_; }
+
+ private:
+    int capacity_{ 0 };
+};
+
+/**
+ * @brief A sequence of directions with a fixed capacity, packed into 2 bits
+ * per direction.
+ *
+ * It offers the stack and indexing operations of a `std::vector<Dir4>`, but
+ * items are read by value and written with `set()`. Like `FixedVector`, it
+ * never allocates after construction, and growing it beyond its capacity is
+ * undefined.
+ *
+ * @tparam N The capacity, or `DYNAMIC_SIZE` to choose it at runtime.
+ */
+template <int N>
+class PackedDirs : PackedDirsStorage<N> {
+ public:
+    using PackedDirsStorage<N>::PackedDirsStorage;
+    using PackedDirsStorage<N>::capacity;
+
+    [[nodiscard]] constexpr bool empty() const { return size_ == 0; }
+
+    [[nodiscard]] constexpr int size() const { return size_; }
+
+    [[nodiscard]] constexpr Dir4 operator[](const int i) const {
+        return static_cast<Dir4>(this->bytes[i / 4] >> i % 4 * 2 & 3);
+    }
+
+    constexpr void set(const int i, const Dir4 dir) {
+        auto& byte = this->bytes[i / 4];
+        const int shift = i % 4 * 2;
+        byte = static_cast<std::uint8_t>(
+            (byte & ~(3 << shift)) | static_cast<int>(dir) << shift);
+    }
+
+    [[nodiscard]] constexpr Dir4 back() const { return (*this)[size_ - 1]; }
+
+    /**
+     * @brief Appends a direction, which must fit within the capacity.
+     */
+    constexpr void push_back(const Dir4 dir) { set(size_++, dir); }
+
+    /**
+     * @brief Removes the last direction; the sequence must not be empty.
+     */
+    constexpr void pop_back() { --size_; }
+
+    /**
+     * @brief Changes the number of directions. New directions keep whatever
+     * the slots held before.
+     */
+    constexpr void resize(const int size) { size_ = size; }
+
+    constexpr void clear() { size_ = 0; }
+
+    /**
+     * @brief Reverses the order of the directions.
+     */
+    constexpr void reverse();
+
+ private:
+    int size_{ 0 };
+};
+
+template <int N>
+constexpr void PackedDirs<N>::reverse() {
+    for (int i = 0, j = size_ - 1; i < j; ++i, --j) {
+        const auto dir = (*this)[i];
+        set(i, (*this)[j]);
+        set(j, dir);
+    }
+}
+
+}  // namespace Mazemouse
+
+#endif
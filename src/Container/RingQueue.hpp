@@ -0,0 +1,103 @@
+#ifndef RING_QUEUE_HPP
+#define RING_QUEUE_HPP
+
+#include <array>
+#include <vector>
+#include "../Maze/MazeGeometry.hpp"
+
+namespace Mazemouse {
+
+/**
+ * @brief Owns the slots of a ring queue.
+ *
+ * The compile-time sized storage keeps the slots inline.
+ */
+template <typename T, int N>
+struct RingQueueStorage {
+    std::array<T, N> slots{};
+
+    constexpr RingQueueStorage() = default;
+
+    constexpr explicit RingQueueStorage(int /* capacity */) {}
+
+    [[nodiscard]] static constexpr int capacity() { return N; }
+};
+
+/**
+ * @brief Runtime-sized storage of a ring queue, allocated once on
+ * construction.
+ */
+template <typename T>
+struct RingQueueStorage<T, DYNAMIC_SIZE> {
+    std::vector<T> slots{};
+
+    RingQueueStorage() = default;
+
+    explicit RingQueueStorage(const int capacity) : slots(capacity) {}
+
+    [[nodiscard]] int capacity() const {
+        return static_cast<int>(slots.size());
+    }
+};
+
+/**
+ * @brief A first-in-first-out queue with a fixed capacity.
+ *
+ * The queue never allocates after construction, which makes it suitable for
+ * the per-cycle planning code of a mouse. Pushing into a full queue or popping
+ * from an empty one is undefined; callers bound the number of queued items,
+ * e.g. by queueing every cell at most once.
+ *
+ * @tparam T The item type.
+ * @tparam N The capacity, or `DYNAMIC_SIZE` to choose it at runtime.
+ */
+template <typename T, int N>
+class RingQueue : RingQueueStorage<T, N> {
+ public:
+    using RingQueueStorage<T, N>::RingQueueStorage;
+    using RingQueueStorage<T, N>::capacity;
+
+    [[nodiscard]] constexpr bool empty() const { return size_ == 0; }
+
+    [[nodiscard]] constexpr int size() const { return size_; }
+
+    /**
+     * @brief Appends an item to the back of the queue, which must not be full.
+     */
+    constexpr void push(const T& item) {
+        int tail = head_ + size_;
+        if (tail >= capacity()) {
+            tail -= capacity();
+        }
+        this->slots[tail] = item;
+        ++size_;
+    }
+
+    /**
+     * @brief Removes and returns the item at the front of the queue, which
+     * must not be empty.
+     */
+    constexpr T pop() {
+        const T item = this->slots[head_];
+        if (++head_ == capacity()) {
+            head_ = 0;
+        }
+        --size_;
+
+        return item;
+    }
+
+    constexpr void clear() {
+        head_ = 0;
+        size_ = 0;
+    }
+
+ private:
+    int head_{ 0 };
+
+    int size_{ 0 };
+};
+
+}  // namespace Mazemouse
+
+#endif
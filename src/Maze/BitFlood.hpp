@@ -0,0 +1,355 @@
+#ifndef BIT_FLOOD_HPP
+#define BIT_FLOOD_HPP
+
+#include <cstdint>
+#include <utility>
+#include "WallBitboard.hpp"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define MAZEMOUSE_AVX2
+#include <immintrin.h>
+#endif
+
+namespace Mazemouse {
+
+/**
+ * @brief Which edges a flood treats as open.
+ */
+enum class WallView : int {
+    // Only the edges known to be open
+    Pessimistic,
+
+    // Every edge not known to have a wall
+    Optimistic
+};
+
+/**
+ * @brief Checks if the CPU running the program supports AVX2. The result is
+ * computed once.
+ */
+inline bool hasAvx2() {
+#ifdef MAZEMOUSE_AVX2
+    static const bool supported = __builtin_cpu_supports("avx2");
+    return supported;
+#else
+    return false;
+#endif
+}
+
+/**
+ * @brief A breadth-first search over a `WallBitboard` that advances a whole
+ * wavefront of cells per step.
+ *
+ * The frontier is a bit plane. One step moves it to all four neighbours at
+ * once with masked shifts over the open planes: right is `(F & east) << 1`,
+ * left is `(F >> 1) & east`, down is `(F & south) << width` and up is
+ * `(F >> width) & south`. The border edges are never open, so the shifts by
+ * one never wrap around a row. A maze with n cells takes about n / 64 word
+ * operations per step instead of one queue operation per cell.
+ *
+ * Planes of exactly four words, which covers the 16x16 competition maze, run
+ * on a 256-bit AVX2 kernel when the CPU supports it; all other planes use the
+ * portable 64-bit kernel. The scratch planes are allocated once on
+ * construction, so a flood never allocates.
+ *
+ * @tparam S The size of the maze, or `DYNAMIC_SIZE`.
+ */
+template <int S>
+class BitFlood {
+ public:
+    using Plane = typename WallBitboard<S>::Plane;
+
+    BitFlood()
+        requires(S != DYNAMIC_SIZE)
+        : BitFlood(MazeGeometry<S>{}) {}
+
+    explicit BitFlood(const MazeGeometry<S>& geometry);
+
+    /**
+     * @brief Floods from the source cells and reports every wavefront.
+     *
+     * @param walls The walls to flood through.
+     * @param view Whether unknown edges are open.
+     * @param sources The cells at distance 0.
+     * @param onLevel Called with every distance and the plane of the cells at
+     * that distance, in increasing order of distance.
+     * @return The number of cells reached, including the sources.
+     */
+    template <typename F>
+    int run(
+        const WallBitboard<S>& walls, WallView view, const Plane& sources,
+        F&& onLevel);
+
+    /**
+     * @brief Writes the distance of every cell from the nearest source cell;
+     * unreached cells get `numCells()`.
+     *
+     * @param distanceOf A callable mapping a cell index to a reference to an
+     * integer wide enough for `numCells()`.
+     */
+    template <typename D>
+    void distances(
+        const WallBitboard<S>& walls, WallView view, const Plane& sources,
+        D&& distanceOf);
+
+ private:
+    MazeGeometry<S> geometry_;
+
+    Plane east_;
+
+    Plane south_;
+
+    Plane frontier_;
+
+    Plane visited_;
+
+    Plane next_;
+
+    /**
+     * The frontier masked by `east_` and `south_`, before it is shifted.
+     */
+    Plane masked_east_;
+
+    Plane masked_south_;
+
+    /**
+     * @brief Advances `frontier_` by one step and marks it visited.
+     *
+     * @return False if no new cell was reached.
+     */
+    bool stepWords();
+
+#ifdef MAZEMOUSE_AVX2
+    /**
+     * @brief Runs the whole flood from `frontier_` with the planes held in
+     * registers, storing every wavefront into `frontier_` for `onLevel`.
+     */
+    template <typename F>
+    __attribute__((target("avx2"))) void runAvx2(F& onLevel);
+
+    __attribute__((target("avx2"))) static __m256i loadAvx2(
+        const Plane& plane);
+
+    /**
+     * @brief Shifts the 256 bits of `v` towards higher indices by `n < 64`
+     * bits.
+     */
+    __attribute__((target("avx2"))) static __m256i shiftUpAvx2(
+        __m256i v, int n);
+
+    /**
+     * @brief Shifts the 256 bits of `v` towards lower indices by `n < 64`
+     * bits.
+     */
+    __attribute__((target("avx2"))) static __m256i shiftDownAvx2(
+        __m256i v, int n);
+#endif
+
+    /**
+     * @brief Returns word `w` of the bits shifted towards higher indices.
+     */
+    template <typename W>
+    static std::uint64_t shiftedUp(const W& words, int w, int shift);
+
+    /**
+     * @brief Returns word `w` of the bits shifted towards lower indices.
+     */
+    template <typename W>
+    static std::uint64_t shiftedDown(const W& words, int w, int shift);
+};
+
+template <int S>
+BitFlood<S>::BitFlood(const MazeGeometry<S>& geometry) :
+    geometry_(geometry), east_(geometry.numCells()),
+    south_(geometry.numCells()), frontier_(geometry.numCells()),
+    visited_(geometry.numCells()), next_(geometry.numCells()),
+    masked_east_(geometry.numCells()), masked_south_(geometry.numCells()) {}
+
+template <int S>
+template <typename F>
+int BitFlood<S>::run(
+    const WallBitboard<S>& walls, const WallView view, const Plane& sources,
+    F&& onLevel) {
+    const int num_words = static_cast<int>(east_.words.size());
+    const int tail_bits = geometry_.numCells() % Plane::WORD_BITS;
+    for (int w = 0; w < num_words; ++w) {
+        east_.words[w] = walls.eastOpen.words[w];
+        south_.words[w] = walls.southOpen.words[w];
+        if (view == WallView::Optimistic) {
+            east_.words[w] |= ~walls.eastKnown.words[w];
+            south_.words[w] |= ~walls.southKnown.words[w];
+        }
+    }
+    if (tail_bits != 0) {
+        const auto mask = (std::uint64_t{ 1 } << tail_bits) - 1;
+        east_.words[num_words - 1] &= mask;
+        south_.words[num_words - 1] &= mask;
+    }
+
+    frontier_ = sources;
+    visited_ = sources;
+
+#ifdef MAZEMOUSE_AVX2
+    if constexpr (S != DYNAMIC_SIZE) {
+        if (Plane::NUM_WORDS == 4 && hasAvx2()) {
+            runAvx2(onLevel);
+            return visited_.count();
+        }
+    }
+#endif
+
+    for (int distance = 0;; ++distance) {
+        onLevel(distance, static_cast<const Plane&>(frontier_));
+        if (!stepWords()) {
+            return visited_.count();
+        }
+    }
+}
+
+template <int S>
+template <typename D>
+void BitFlood<S>::distances(
+    const WallBitboard<S>& walls, const WallView view, const Plane& sources,
+    D&& distanceOf) {
+    const int unreachable = geometry_.numCells();
+    for (int i = 0; i < unreachable; ++i) {
+        distanceOf(i) = unreachable;
+    }
+
+    run(walls, view, sources, [&](const int distance, const Plane& level) {
+        level.forEach([&](const int i) { distanceOf(i) = distance; });
+    });
+}
+
+template <int S>
+bool BitFlood<S>::stepWords() {
+    const auto& f = frontier_.words;
+    const auto& east = east_.words;
+    const auto& south = south_.words;
+    const int num_words = static_cast<int>(f.size());
+    const int row = geometry_.width();
+
+    for (int w = 0; w < num_words; ++w) {
+        masked_east_.words[w] = f[w] & east[w];
+        masked_south_.words[w] = f[w] & south[w];
+    }
+
+    bool grown = false;
+    for (int w = 0; w < num_words; ++w) {
+        const auto next = shiftedUp(masked_east_.words, w, 1) |
+                          (shiftedDown(f, w, 1) & east[w]) |
+                          shiftedUp(masked_south_.words, w, row) |
+                          (shiftedDown(f, w, row) & south[w]);
+        next_.words[w] = next & ~visited_.words[w];
+        grown |= next_.words[w] != 0;
+    }
+
+    std::swap(frontier_, next_);
+    visited_ |= frontier_;
+
+    return grown;
+}
+
+#ifdef MAZEMOUSE_AVX2
+template <int S>
+template <typename F>
+__attribute__((target("avx2"))) void BitFlood<S>::runAvx2(F& onLevel) {
+    const auto east = loadAvx2(east_);
+    const auto south = loadAvx2(south_);
+    auto frontier = loadAvx2(frontier_);
+    auto visited = frontier;
+
+    for (int distance = 0;; ++distance) {
+        onLevel(distance, static_cast<const Plane&>(frontier_));
+
+        auto next = _mm256_or_si256(
+            shiftUpAvx2(_mm256_and_si256(frontier, east), 1),
+            _mm256_and_si256(shiftDownAvx2(frontier, 1), east));
+        next = _mm256_or_si256(
+            next, shiftUpAvx2(_mm256_and_si256(frontier, south), S));
+        next = _mm256_or_si256(
+            next, _mm256_and_si256(shiftDownAvx2(frontier, S), south));
+        frontier = _mm256_andnot_si256(visited, next);
+        if (_mm256_testz_si256(frontier, frontier)) {
+            break;
+        }
+
+        visited = _mm256_or_si256(visited, frontier);
+        _mm256_storeu_si256(
+            reinterpret_cast<__m256i*>(frontier_.words.data()), frontier);
+    }
+
+    _mm256_storeu_si256(
+        reinterpret_cast<__m256i*>(visited_.words.data()), visited);
+}
+
+template <int S>
+__attribute__((target("avx2"))) __m256i BitFlood<S>::loadAvx2(
+    const Plane& plane) {
+    return _mm256_loadu_si256(
+        reinterpret_cast<const __m256i*>(plane.words.data()));
+}
+
+template <int S>
+__attribute__((target("avx2"))) __m256i BitFlood<S>::shiftUpAvx2(
+    const __m256i v, const int n) {
+    // Move the bits leaving every lane into the lane above
+    auto carry = _mm256_srli_epi64(v, 64 - n);
+    carry = _mm256_permute4x64_epi64(carry, _MM_SHUFFLE(2, 1, 0, 3));
+    carry = _mm256_blend_epi32(carry, _mm256_setzero_si256(), 0x03);
+
+    return _mm256_or_si256(_mm256_slli_epi64(v, n), carry);
+}
+
+template <int S>
+__attribute__((target("avx2"))) __m256i BitFlood<S>::shiftDownAvx2(
+    const __m256i v, const int n) {
+    // Move the bits leaving every lane into the lane below
+    auto carry = _mm256_slli_epi64(v, 64 - n);
+    carry = _mm256_permute4x64_epi64(carry, _MM_SHUFFLE(0, 3, 2, 1));
+    carry = _mm256_blend_epi32(carry, _mm256_setzero_si256(), 0xC0);
+
+    return _mm256_or_si256(_mm256_srli_epi64(v, n), carry);
+}
+#endif
+
+template <int S>
+template <typename W>
+std::uint64_t BitFlood<S>::shiftedUp(
+    const W& words, const int w, const int shift) {
+    const int src = w - shift / Plane::WORD_BITS;
+    const int bits = shift % Plane::WORD_BITS;
+    if (src < 0) {
+        return 0;
+    }
+
+    auto word = words[src] << bits;
+    if (bits != 0 && src > 0) {
+        word |= words[src - 1] >> (Plane::WORD_BITS - bits);
+    }
+
+    return word;
+}
+
+template <int S>
+template <typename W>
+std::uint64_t BitFlood<S>::shiftedDown(
+    const W& words, const int w, const int shift) {
+    const int num_words = static_cast<int>(words.size());
+    const int src = w + shift / Plane::WORD_BITS;
+    const int bits = shift % Plane::WORD_BITS;
+    if (src >= num_words) {
+        return 0;
+    }
+
+    auto word = words[src] >> bits;
+    if (bits != 0 && src + 1 < num_words) {
+        word |= words[src + 1] << (Plane::WORD_BITS - bits);
+    }
+
+    return word;
+}
+
+}  // namespace Mazemouse
+
+#endif
@@ -0,0 +1,316 @@
+#ifndef BIT_PLANE_HPP
+#define BIT_PLANE_HPP
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <vector>
+#include "MazeGeometry.hpp"
+
+namespace Mazemouse {
+
+/**
+ * @brief Owns the words of a bit plane.
+ *
+ * The compile-time sized storage keeps the words inline.
+ */
+template <int N>
+struct BitPlaneStorage {
+    static constexpr int WORD_BITS = 64;
+    static constexpr int NUM_WORDS = (N + WORD_BITS - 1) / WORD_BITS;
+
+    /**
+     * The packed bits. Bit `i` lives in `words[i / 64]` at position `i % 64`.
+     */
+    std::array<std::uint64_t, NUM_WORDS> words{};
+
+    constexpr BitPlaneStorage() = default;
+
+    constexpr explicit BitPlaneStorage(int /* size */) {}
+
+    /**
+     * Returns the number of bits in the plane.
+     */
+    [[nodiscard]] static constexpr int size() { return N; }
+};
+
+/**
+ * @brief Runtime-sized storage of a bit plane.
+ */
+template <>
+struct BitPlaneStorage<DYNAMIC_SIZE> {
+    static constexpr int WORD_BITS = 64;
+
+    std::vector<std::uint64_t> words{};
+
+    BitPlaneStorage() = default;
+
+    explicit BitPlaneStorage(const int size) :
+        words((size + WORD_BITS - 1) / WORD_BITS), size_(size) {}
+
+    [[nodiscard]] int size() const { return size_; }
+
+ private:
+    int size_{ 0 };
+};
+
+/**
+ * @brief A set of bits packed into 64-bit words.
+ *
+ * A bit plane stores one bit per cell of a maze, where bit `i` corresponds to
+ * the cell whose index is `i` (see `MazeGeometry::cellIndex`). All word-wide
+ * operations keep the unused high bits of the last word cleared, so the
+ * planes can be compared and counted directly. Both operands of a binary
+ * operation must have the same size.
+ *
+ * @tparam N The number of bits in the plane, or `DYNAMIC_SIZE` to choose it
+ * at runtime.
+ */
+template <int N>
+struct BitPlane : BitPlaneStorage<N> {
+    using BitPlaneStorage<N>::BitPlaneStorage;
+    using BitPlaneStorage<N>::WORD_BITS;
+
+    /**
+     * Returns a plane with all bits set.
+     *
+     * @param size The number of bits; only used by runtime-sized planes.
+     */
+    [[nodiscard]] static constexpr BitPlane filled(int size = N);
+
+    [[nodiscard]] constexpr bool test(int index) const;
+
+    constexpr void set(int index);
+
+    constexpr void reset(int index);
+
+    constexpr void assign(int index, bool value);
+
+    /**
+     * Returns true if any bit is set.
+     */
+    [[nodiscard]] constexpr bool any() const;
+
+    /**
+     * Returns the number of set bits.
+     */
+    [[nodiscard]] constexpr int count() const;
+
+    /**
+     * @brief Calls the given function with the index of every set bit, in
+     * ascending order.
+     *
+     * @param fn A callable taking an `int` bit index.
+     */
+    template <typename F>
+    constexpr void forEach(F&& fn) const;
+
+    constexpr BitPlane& operator&=(const BitPlane& other);
+
+    constexpr BitPlane& operator|=(const BitPlane& other);
+
+    constexpr BitPlane& operator^=(const BitPlane& other);
+
+    /**
+     * Shifts every bit towards higher indices by the given amount; bits
+     * shifted past the end of the plane are discarded.
+     */
+    constexpr BitPlane& operator<<=(int shift);
+
+    /**
+     * Shifts every bit towards lower indices by the given amount.
+     */
+    constexpr BitPlane& operator>>=(int shift);
+
+ private:
+    [[nodiscard]] constexpr int numWords() const {
+        return static_cast<int>(this->words.size());
+    }
+
+    constexpr void clearPadding();
+};
+
+template <int N>
+constexpr BitPlane<N> BitPlane<N>::filled(const int size) {
+    BitPlane plane(size);
+    std::fill(plane.words.begin(), plane.words.end(), ~std::uint64_t{ 0 });
+    plane.clearPadding();
+
+    return plane;
+}
+
+template <int N>
+constexpr bool BitPlane<N>::test(const int index) const {
+    return (this->words[index / WORD_BITS] >> (index % WORD_BITS)) & 1;
+}
+
+template <int N>
+constexpr void BitPlane<N>::set(const int index) {
+    this->words[index / WORD_BITS] |= std::uint64_t{ 1 }
+                                      << (index % WORD_BITS);
+}
+
+template <int N>
+constexpr void BitPlane<N>::reset(const int index) {
+    this->words[index / WORD_BITS] &=
+        ~(std::uint64_t{ 1 } << (index % WORD_BITS));
+}
+
+template <int N>
+constexpr void BitPlane<N>::assign(const int index, const bool value) {
+    const auto mask = std::uint64_t{ 1 } << (index % WORD_BITS);
+    auto& word = this->words[index / WORD_BITS];
+    word = (word & ~mask) | (-static_cast<std::uint64_t>(value) & mask);
+}
+
+template <int N>
+constexpr bool BitPlane<N>::any() const {
+    for (const auto word : this->words) {
+        if (word != 0) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+template <int N>
+constexpr int BitPlane<N>::count() const {
+    int total = 0;
+    for (const auto word : this->words) {
+        total += std::popcount(word);
+    }
+
+    return total;
+}
+
+template <int N>
+template <typename F>
+constexpr void BitPlane<N>::forEach(F&& fn) const {
+    for (int w = 0; w < numWords(); ++w) {
+        auto word = this->words[w];
+        while (word != 0) {
+            fn(w * WORD_BITS + std::countr_zero(word));
+            word &= word - 1;
+        }
+    }
+}
+
+template <int N>
+constexpr BitPlane<N>& BitPlane<N>::operator&=(const BitPlane& other) {
+    for (int w = 0; w < numWords(); ++w) {
+        this->words[w] &= other.words[w];
+    }
+
+    return *this;
+}
+
+template <int N>
+constexpr BitPlane<N>& BitPlane<N>::operator|=(const BitPlane& other) {
+    for (int w = 0; w < numWords(); ++w) {
+        this->words[w] |= other.words[w];
+    }
+
+    return *this;
+}
+
+template <int N>
+constexpr BitPlane<N>& BitPlane<N>::operator^=(const BitPlane& other) {
+    for (int w = 0; w < numWords(); ++w) {
+        this->words[w] ^= other.words[w];
+    }
+
+    return *this;
+}
+
+template <int N>
+constexpr BitPlane<N>& BitPlane<N>::operator<<=(const int shift) {
+    const int word_shift = shift / WORD_BITS;
+    const int bit_shift = shift % WORD_BITS;
+
+    for (int w = numWords() - 1; w >= 0; --w) {
+        const int src = w - word_shift;
+        std::uint64_t value = 0;
+        if (src >= 0) {
+            value = this->words[src] << bit_shift;
+            if (bit_shift != 0 && src > 0) {
+                value |= this->words[src - 1] >> (WORD_BITS - bit_shift);
+            }
+        }
+        this->words[w] = value;
+    }
+    clearPadding();
+
+    return *this;
+}
+
+template <int N>
+constexpr BitPlane<N>& BitPlane<N>::operator>>=(const int shift) {
+    const int word_shift = shift / WORD_BITS;
+    const int bit_shift = shift % WORD_BITS;
+
+    for (int w = 0; w < numWords(); ++w) {
+        const int src = w + word_shift;
+        std::uint64_t value = 0;
+        if (src < numWords()) {
+            value = this->words[src] >> bit_shift;
+            if (bit_shift != 0 && src + 1 < numWords()) {
+                value |= this->words[src + 1] << (WORD_BITS - bit_shift);
+            }
+        }
+        this->words[w] = value;
+    }
+
+    return *this;
+}
+
+template <int N>
+constexpr void BitPlane<N>::clearPadding() {
+    const int tail_bits = this->size() % WORD_BITS;
+    if (tail_bits != 0) {
+        this->words[numWords() - 1] &= (std::uint64_t{ 1 } << tail_bits) - 1;
+    }
+}
+
+template <int N>
+constexpr BitPlane<N> operator&(BitPlane<N> plane1, const BitPlane<N>& plane2) {
+    return plane1 &= plane2;
+}
+
+template <int N>
+constexpr BitPlane<N> operator|(BitPlane<N> plane1, const BitPlane<N>& plane2) {
+    return plane1 |= plane2;
+}
+
+template <int N>
+constexpr BitPlane<N> operator^(BitPlane<N> plane1, const BitPlane<N>& plane2) {
+    return plane1 ^= plane2;
+}
+
+/**
+ * @brief Complements a plane; the unused padding bits stay cleared.
+ */
+template <int N>
+constexpr BitPlane<N> operator~(const BitPlane<N>& plane) {
+    return plane ^ BitPlane<N>::filled(plane.size());
+}
+
+template <int N>
+constexpr BitPlane<N> operator<<(BitPlane<N> plane, const int shift) {
+    return plane <<= shift;
+}
+
+template <int N>
+constexpr BitPlane<N> operator>>(BitPlane<N> plane, const int shift) {
+    return plane >>= shift;
+}
+
+template <int N>
+constexpr bool operator==(const BitPlane<N>& plane1, const BitPlane<N>& plane2) {
+    return plane1.words == plane2.words;
+}
+
+}  // namespace Mazemouse
+
+#endif
@@ -1,14 +1,16 @@
 #ifndef DIRECTION_HPP
 #define DIRECTION_HPP
 
+#include <cstdint>
+#include <stdexcept>
 #include "Vector2.hpp"
 
 namespace Mazemouse {
 
 /**
- * Represents four primary directions.
+ * Represents four primary directions, stored in one byte.
  */
-enum class Dir4 : int { Up, Right, Down, Left };
+enum class Dir4 : std::uint8_t { Up, Right, Down, Left };
 
 /**
  * @brief Converts a direction to its corresponding vector.
@@ -23,7 +25,7 @@ enum class Dir4 : int { Up, Right, Down, Left };
  * @param dir The direction to be converted.
  * @return A vector representing the direction as a vector.
  */
-inline Vector2 get_vector(const Dir4 dir) {
+constexpr Vector2 get_vector(const Dir4 dir) {
     switch (dir) {
         case Dir4::Up:
             return { 0, -1 };
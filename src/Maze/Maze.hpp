@@ -1,9 +1,13 @@
 #ifndef MAZE_HPP
 #define MAZE_HPP
 
+#include <cstddef>
+#include <memory>
 #include <stdexcept>
 #include <string>
+#include <utility>
 #include "Dir4.hpp"
+#include "MazeGeometry.hpp"
 #include "Vector2.hpp"
 
 namespace Mazemouse {
@@ -14,13 +18,20 @@ namespace Mazemouse {
 struct Cell {};
 
 /**
- * Represents a base class for an edge between cells in the maze.
+ * Represents a base class for an edge between cells in the maze. Both flags
+ * share one byte.
  */
 struct Edge {
     /**
      * Indicates whether this edge is blocked by a wall.
      */
-    mutable bool hasWall{ true };
+    mutable bool hasWall : 1 { true };
+
+    /**
+     * Indicates whether a mouse has seen this edge; `hasWall` of an unknown
+     * edge is only a guess.
+     */
+    mutable bool isKnown : 1 { false };
 };
 
 template <typename C>
@@ -30,14 +41,19 @@ template <typename E>
 concept DerivedFromEdge = std::is_base_of_v<Edge, E>;
 
 /**
- * Represents a generic square maze with cells and edges.
+ * An edge type for a maze that only needs its cells, such as the memory of a
+ * mouse that keeps its walls in a `WallBitboard`. A compile-time sized maze
+ * of `NoEdge` stores no edges, so its edges must not be accessed.
+ */
+struct NoEdge : Edge {};
+
+/**
+ * @brief Owns the cells and edges of a maze.
  *
- * @tparam S The size of the maze (number of cells along one dimension).
- * @tparam C A type derived from Cell, representing each cell in the maze.
- * @tparam E A type derived from Edge, representing each edge between cells.
+ * The compile-time sized storage keeps both arrays inline.
  */
 template <int S, DerivedFromCell C, DerivedFromEdge E>
-struct Maze {
+struct MazeStorage : MazeGeometry<S> {
     /**
      * Array of cells in the maze.
      */
@@ -45,17 +61,83 @@ struct Maze {
 
     /**
      * Array of edges in the maze. The first half corresponds to vertical edges,
-     * and the second half corresponds to horizontal edges.
+     * and the second half corresponds to horizontal edges. The last slot is
+     * the border edge sentinel.
      */
-    E edges[(S - 1) * S * 2];
+    E edges[(S - 1) * S * 2 + 1];
+};
 
+/**
+ * @brief Compile-time sized storage of a maze of `NoEdge`: the cells only.
+ */
+template <int S, DerivedFromCell C>
+    requires(S != DYNAMIC_SIZE)
+struct MazeStorage<S, C, NoEdge> : MazeGeometry<S> {
     /**
-     * Returns the index of the cell at the given coordinates.
-     *
-     * @param coord The coordinates of the cell.
-     * @return The index of the cell in the `cells` array.
+     * Array of cells in the maze.
      */
-    [[nodiscard]] static int cellIndex(const Vector2& coord);
+    C cells[S * S];
+};
+
+/**
+ * @brief Runtime-sized storage of a maze.
+ *
+ * The cells and the edges share a single contiguous allocation; `cells` and
+ * `edges` point into it.
+ */
+template <DerivedFromCell C, DerivedFromEdge E>
+struct MazeStorage<DYNAMIC_SIZE, C, E> : MazeGeometry<DYNAMIC_SIZE> {
+    static_assert(
+        alignof(C) <= __STDCPP_DEFAULT_NEW_ALIGNMENT__ &&
+        alignof(E) <= __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+
+    /**
+     * Array of cells in the maze.
+     */
+    C* cells{ nullptr };
+
+    /**
+     * Array of edges in the maze, laid out as in the compile-time storage,
+     * including the border edge sentinel.
+     */
+    E* edges{ nullptr };
+
+    MazeStorage(int width, int height);
+
+    MazeStorage(const MazeStorage& other);
+
+    MazeStorage(MazeStorage&& other) noexcept;
+
+    MazeStorage& operator=(const MazeStorage& other);
+
+    MazeStorage& operator=(MazeStorage&& other) noexcept;
+
+    ~MazeStorage();
+
+ private:
+    std::unique_ptr<std::byte[]> buffer_;
+
+    /**
+     * Returns the byte offset of the edge array inside the buffer.
+     */
+    [[nodiscard]] std::size_t edgesOffset() const;
+
+    void allocate();
+
+    void destroy();
+};
+
+/**
+ * Represents a generic maze with cells and edges.
+ *
+ * @tparam S The size of the maze (number of cells along one dimension), or
+ * `DYNAMIC_SIZE` to choose the width and height at runtime.
+ * @tparam C A type derived from Cell, representing each cell in the maze.
+ * @tparam E A type derived from Edge, representing each edge between cells.
+ */
+template <int S, DerivedFromCell C, DerivedFromEdge E>
+struct Maze : MazeStorage<S, C, E> {
+    using MazeStorage<S, C, E>::MazeStorage;
 
     /**
      * Returns a reference to the cell at the given coordinates.
@@ -66,92 +148,189 @@ struct Maze {
     [[nodiscard]] C& cell(const Vector2& coord);
 
     /**
-     * Returns the index of the edge at the given coordinates and direction.
+     * Returns a const reference to the edge at the given coordinates and
+     * direction.
      *
      * @param coord The coordinates of the starting cell of the edge.
      * @param dir The direction of the edge.
-     * @return The index of the edge in the `edges` array.
+     * @return A const reference to the edge.
+     * @throws std::invalid_argument if the coordinates are out of bounds.
      */
-    [[nodiscard]] static int edgeIndex(const Vector2& coord, Dir4 dir);
+    [[nodiscard]] const E& edge(const Vector2& coord, Dir4 dir) const;
 
     /**
-     * Returns a const reference to the edge at the given coordinates and
-     * direction.
+     * Checks if the edge at the given coordinates and direction is open.
      *
      * @param coord The coordinates of the starting cell of the edge.
      * @param dir The direction of the edge.
-     * @return A const reference to the edge.
-     * @throws std::invalid_argument if the coordinates are out of bounds.
+     * @return True if the edge is open (i.e., no wall), false otherwise.
      */
-    [[nodiscard]] const E& edge(const Vector2& coord, Dir4 dir) const;
+    [[nodiscard]] bool isOpen(const Vector2& coord, Dir4 dir) const;
 
     /**
-     * Checks if the given coordinates and direction are within the maze bounds.
+     * Returns a reference to the cell with the given index, without bounds
+     * checking.
      *
-     * @param coord The coordinates of the cell.
-     * @param dir The direction to check.
-     * @return True if the coordinates and direction are within bounds, false
-     * otherwise.
+     * @param index The index of the cell.
+     * @return A reference to the cell.
      */
-    [[nodiscard]] static bool withinBounds(const Vector2& coord, Dir4 dir);
+    [[nodiscard]] C& cellAt(int index);
+
+    [[nodiscard]] const C& cellAt(int index) const;
 
     /**
-     * Checks if the edge at the given coordinates and direction is open.
+     * @brief Returns the edge of a cell in the given direction, without bounds
+     * checking.
      *
-     * @param coord The coordinates of the starting cell of the edge.
+     * Edges on the border of the maze resolve to the border edge sentinel,
+     * which always has a wall and must not be modified.
+     *
+     * @param index The index of the cell.
+     * @param dir The direction of the edge.
+     * @return A const reference to the edge.
+     */
+    [[nodiscard]] const E& edgeAt(int index, Dir4 dir) const;
+
+    /**
+     * Checks if the edge of a cell in the given direction is open, without
+     * bounds checking or branching.
+     *
+     * @param index The index of the cell.
      * @param dir The direction of the edge.
      * @return True if the edge is open (i.e., no wall), false otherwise.
      */
-    [[nodiscard]] bool isOpen(const Vector2& coord, Dir4 dir) const;
+    [[nodiscard]] bool isOpenAt(int index, Dir4 dir) const;
 };
 
-template <int S, DerivedFromCell C, DerivedFromEdge E>
-int Maze<S, C, E>::cellIndex(const Vector2& coord) {
-    return S * coord.y + coord.x;
+/**
+ * @brief Throws the exception reported by the checked edge accessors.
+ *
+ * The coordinates are only formatted into the message in debug builds.
+ */
+[[noreturn]] inline void throwEdgeOutOfRange(
+    [[maybe_unused]] const Vector2& coord, [[maybe_unused]] const Dir4 dir) {
+#ifdef NDEBUG
+    throw std::invalid_argument("Maze::edge(): coord is out of range");
+#else
+    throw std::invalid_argument(
+        "Maze::edge(): coord is out of range: (" + std::to_string(coord.x) +
+        ", " + std::to_string(coord.y) + ") " +
+        std::to_string(static_cast<int>(dir)));
+#endif
 }
 
-template <int S, DerivedFromCell C, DerivedFromEdge E>
-C& Maze<S, C, E>::cell(const Vector2& coord) {
-    return cells[cellIndex(coord)];
+template <DerivedFromCell C, DerivedFromEdge E>
+MazeStorage<DYNAMIC_SIZE, C, E>::MazeStorage(const int width, const int height) :
+    MazeGeometry(width, height) {
+    allocate();
+    std::uninitialized_value_construct_n(cells, numCells());
+    std::uninitialized_value_construct_n(edges, numEdges() + 1);
+}
+
+template <DerivedFromCell C, DerivedFromEdge E>
+MazeStorage<DYNAMIC_SIZE, C, E>::MazeStorage(const MazeStorage& other) :
+    MazeGeometry(other) {
+    allocate();
+    std::uninitialized_copy_n(other.cells, numCells(), cells);
+    std::uninitialized_copy_n(other.edges, numEdges() + 1, edges);
+}
+
+template <DerivedFromCell C, DerivedFromEdge E>
+MazeStorage<DYNAMIC_SIZE, C, E>::MazeStorage(MazeStorage&& other) noexcept :
+    MazeGeometry(other), cells(std::exchange(other.cells, nullptr)),
+    edges(std::exchange(other.edges, nullptr)),
+    buffer_(std::move(other.buffer_)) {}
+
+template <DerivedFromCell C, DerivedFromEdge E>
+MazeStorage<DYNAMIC_SIZE, C, E>& MazeStorage<DYNAMIC_SIZE, C, E>::operator=(
+    const MazeStorage& other) {
+    if (this != &other) {
+        MazeStorage copy(other);
+        *this = std::move(copy);
+    }
+
+    return *this;
+}
+
+template <DerivedFromCell C, DerivedFromEdge E>
+MazeStorage<DYNAMIC_SIZE, C, E>& MazeStorage<DYNAMIC_SIZE, C, E>::operator=(
+    MazeStorage&& other) noexcept {
+    if (this != &other) {
+        destroy();
+        MazeGeometry::operator=(other);
+        cells = std::exchange(other.cells, nullptr);
+        edges = std::exchange(other.edges, nullptr);
+        buffer_ = std::move(other.buffer_);
+    }
+
+    return *this;
+}
+
+template <DerivedFromCell C, DerivedFromEdge E>
+MazeStorage<DYNAMIC_SIZE, C, E>::~MazeStorage() {
+    destroy();
+}
+
+template <DerivedFromCell C, DerivedFromEdge E>
+std::size_t MazeStorage<DYNAMIC_SIZE, C, E>::edgesOffset() const {
+    const auto cells_bytes = sizeof(C) * numCells();
+    return (cells_bytes + alignof(E) - 1) / alignof(E) * alignof(E);
+}
+
+template <DerivedFromCell C, DerivedFromEdge E>
+void MazeStorage<DYNAMIC_SIZE, C, E>::allocate() {
+    buffer_ = std::make_unique_for_overwrite<std::byte[]>(
+        edgesOffset() + sizeof(E) * (numEdges() + 1));
+    cells = reinterpret_cast<C*>(buffer_.get());
+    edges = reinterpret_cast<E*>(buffer_.get() + edgesOffset());
+}
+
+template <DerivedFromCell C, DerivedFromEdge E>
+void MazeStorage<DYNAMIC_SIZE, C, E>::destroy() {
+    if (buffer_ != nullptr) {
+        std::destroy_n(cells, numCells());
+        std::destroy_n(edges, numEdges() + 1);
+    }
 }
 
 template <int S, DerivedFromCell C, DerivedFromEdge E>
-int Maze<S, C, E>::edgeIndex(const Vector2& coord, Dir4 dir) {
-    const auto dirInt = static_cast<int>(dir);
-    return dirInt % 2 == 0 ? (S - 1) * coord.x + coord.y - (dirInt == 0)
-                           : (S - 1) * (S + coord.y) + coord.x - (dirInt == 3);
+C& Maze<S, C, E>::cell(const Vector2& coord) {
+    return this->cells[this->cellIndex(coord)];
 }
 
 template <int S, DerivedFromCell C, DerivedFromEdge E>
 const E& Maze<S, C, E>::edge(const Vector2& coord, const Dir4 dir) const {
-    if (!withinBounds(coord, dir)) {
-        throw std::invalid_argument(
-            "Maze::edge(): coord is out of range: (" + std::to_string(coord.x) +
-            ", " + std::to_string(coord.y) + ") " +
-            std::to_string(static_cast<int>(dir)));
+    if (!this->withinBounds(coord, dir)) {
+        throwEdgeOutOfRange(coord, dir);
     }
 
-    return edges[edgeIndex(coord, dir)];
+    return this->edges[this->edgeIndex(coord, dir)];
 }
 
 template <int S, DerivedFromCell C, DerivedFromEdge E>
-bool Maze<S, C, E>::withinBounds(const Vector2& coord, const Dir4 dir) {
-    switch (dir) {
-        case Dir4::Up:
-            return coord.y > 0;
-        case Dir4::Right:
-            return coord.x < S - 1;
-        case Dir4::Down:
-            return coord.y < S - 1;
-        case Dir4::Left:
-            return coord.x > 0;
-    }
-    return false;
+bool Maze<S, C, E>::isOpen(const Vector2& coord, const Dir4 dir) const {
+    return this->withinBounds(coord, dir) &&
+           !this->edges[this->edgeIndex(coord, dir)].hasWall;
 }
 
 template <int S, DerivedFromCell C, DerivedFromEdge E>
-bool Maze<S, C, E>::isOpen(const Vector2& coord, const Dir4 dir) const {
-    return withinBounds(coord, dir) && !edge(coord, dir).hasWall;
+C& Maze<S, C, E>::cellAt(const int index) {
+    return this->cells[index];
+}
+
+template <int S, DerivedFromCell C, DerivedFromEdge E>
+const C& Maze<S, C, E>::cellAt(const int index) const {
+    return this->cells[index];
+}
+
+template <int S, DerivedFromCell C, DerivedFromEdge E>
+const E& Maze<S, C, E>::edgeAt(const int index, const Dir4 dir) const {
+    return this->edges[this->edgeIndexOf(index, dir)];
+}
+
+template <int S, DerivedFromCell C, DerivedFromEdge E>
+bool Maze<S, C, E>::isOpenAt(const int index, const Dir4 dir) const {
+    return !edgeAt(index, dir).hasWall;
 }
 
 }  // namespace Mazemouse
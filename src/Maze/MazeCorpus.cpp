@@ -0,0 +1,270 @@
+#include "MazeCorpus.hpp"
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+#include <fcntl.h>
+#include <iterator>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace Mazemouse {
+
+// The headers are read and written as they lie in memory
+static_assert(std::endian::native == std::endian::little);
+
+namespace {
+
+/**
+ * @brief Returns whether the text of a wall between two posts draws a wall.
+ */
+bool isWallText(const std::string& line, const std::size_t begin,
+                const std::size_t length) {
+    for (auto i = begin; i < begin + length && i < line.size(); ++i) {
+        if (line[i] != ' ') {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+}  // namespace
+
+std::size_t mazeRecordSize(const int maxWidth, const int maxHeight) {
+    const MazeGeometry<DYNAMIC_SIZE> geometry(maxWidth, maxHeight);
+    const std::size_t size =
+        sizeof(MazeRecordHeader) + (geometry.numEdges() + 7) / 8;
+
+    return (size + MAZE_CORPUS_ALIGNMENT - 1) / MAZE_CORPUS_ALIGNMENT *
+           MAZE_CORPUS_ALIGNMENT;
+}
+
+MazeView::MazeView(const std::byte* record) :
+    header_(reinterpret_cast<const MazeRecordHeader*>(record)),
+    walls_(reinterpret_cast<const std::uint8_t*>(
+        record + sizeof(MazeRecordHeader))),
+    geometry_(header_->width, header_->height) {}
+
+MazeGoal MazeView::getGoal() const {
+    return { { header_->goalX, header_->goalY },
+             { header_->goalWidth, header_->goalHeight } };
+}
+
+MazeCorpus::MazeCorpus(const std::string& path) {
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::invalid_argument("MazeCorpus(): cannot open " + path);
+    }
+    struct stat status{};
+    if (::fstat(fd, &status) != 0 ||
+        static_cast<std::size_t>(status.st_size) < sizeof(MazeCorpusHeader)) {
+        ::close(fd);
+        throw std::invalid_argument("MazeCorpus(): not a corpus: " + path);
+    }
+
+    file_size_ = static_cast<std::size_t>(status.st_size);
+    void* const data =
+        ::mmap(nullptr, file_size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (data == MAP_FAILED) {
+        throw std::invalid_argument("MazeCorpus(): cannot map " + path);
+    }
+    data_ = static_cast<const std::byte*>(data);
+
+    const auto& header = getHeader();
+    num_mazes_ = header.numMazes;
+    record_size_ = header.recordSize;
+    const bool valid =
+        std::memcmp(header.magic, MAZE_CORPUS_MAGIC, sizeof(header.magic)) ==
+            0 &&
+        header.version == MAZE_CORPUS_VERSION && header.maxWidth >= 2 &&
+        header.maxHeight >= 2 &&
+        record_size_ >= mazeRecordSize(header.maxWidth, header.maxHeight) &&
+        record_size_ % MAZE_CORPUS_ALIGNMENT == 0 &&
+        num_mazes_ <=
+            (file_size_ - sizeof(MazeCorpusHeader)) / record_size_;
+    if (!valid) {
+        ::munmap(const_cast<std::byte*>(data_), file_size_);
+        throw std::invalid_argument(
+            "MazeCorpus(): not a corpus of version " +
+            std::to_string(MAZE_CORPUS_VERSION) + ": " + path);
+    }
+}
+
+MazeCorpus::~MazeCorpus() {
+    ::munmap(const_cast<std::byte*>(data_), file_size_);
+}
+
+MazeView MazeCorpus::at(const std::size_t i) const {
+    if (i >= num_mazes_) {
+        throw std::invalid_argument("MazeCorpus::at(): index out of range");
+    }
+
+    const auto& header = getHeader();
+    const auto& record = *reinterpret_cast<const MazeRecordHeader*>(
+        data_ + sizeof(MazeCorpusHeader) + i * record_size_);
+    if (record.width < 2 || record.width > header.maxWidth ||
+        record.height < 2 || record.height > header.maxHeight) {
+        throw std::invalid_argument(
+            "MazeCorpus::at(): record " + std::to_string(i) +
+            " has an invalid size");
+    }
+
+    return (*this)[i];
+}
+
+MazeCorpusWriter::MazeCorpusWriter(
+    const std::string& path, const int maxWidth, const int maxHeight) :
+    file_(path, std::ios::binary | std::ios::trunc), max_width_(maxWidth),
+    max_height_(maxHeight), record_(mazeRecordSize(maxWidth, maxHeight)) {
+    if (!file_) {
+        throw std::invalid_argument(
+            "MazeCorpusWriter(): cannot create " + path);
+    }
+
+    MazeCorpusHeader header{};
+    std::memcpy(header.magic, MAZE_CORPUS_MAGIC, sizeof(header.magic));
+    header.version = MAZE_CORPUS_VERSION;
+    header.recordSize = static_cast<std::uint32_t>(record_.size());
+    header.maxWidth = static_cast<std::uint16_t>(maxWidth);
+    header.maxHeight = static_cast<std::uint16_t>(maxHeight);
+    file_.write(reinterpret_cast<const char*>(&header), sizeof(header));
+}
+
+MazeCorpusWriter::~MazeCorpusWriter() {
+    if (file_.is_open()) {
+        try {
+            close();
+        } catch (const std::invalid_argument&) {
+            // A destructor must not throw; call close() to see the error
+        }
+    }
+}
+
+void MazeCorpusWriter::close() {
+    const auto num_mazes = static_cast<std::uint64_t>(num_mazes_);
+    file_.seekp(offsetof(MazeCorpusHeader, numMazes));
+    file_.write(
+        reinterpret_cast<const char*>(&num_mazes), sizeof(num_mazes));
+    file_.close();
+    if (!file_) {
+        throw std::invalid_argument(
+            "MazeCorpusWriter::close(): writing the corpus failed");
+    }
+}
+
+void MazeCorpusWriter::writeRecord(const MazeRecordHeader& header) {
+    std::memcpy(record_.data(), &header, sizeof(header));
+    file_.write(
+        reinterpret_cast<const char*>(record_.data()),
+        static_cast<std::streamsize>(record_.size()));
+    ++num_mazes_;
+}
+
+ImportedMaze importTextMaze(std::istream& is) {
+    std::vector<std::string> lines;
+    for (std::string line; std::getline(is, line);) {
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        lines.push_back(line);
+    }
+    while (!lines.empty() &&
+           lines.back().find_first_not_of(' ') == std::string::npos) {
+        lines.pop_back();
+    }
+    if (lines.size() < 5 || lines.size() % 2 == 0 || lines[0].size() < 9) {
+        throw std::invalid_argument("importTextMaze(): not a maze");
+    }
+
+    const int width = static_cast<int>((lines[0].size() - 1) / 4);
+    const int height = static_cast<int>((lines.size() - 1) / 2);
+
+    // Post lines end at the last post and cell lines reach it, so a truncated
+    // or mangled line fails rather than reading as missing walls
+    const std::size_t line_length = 4 * static_cast<std::size_t>(width) + 1;
+    for (std::size_t i = 0; i < lines.size(); ++i) {
+        if (i % 2 == 0 ? lines[i].size() != line_length
+                       : lines[i].size() < line_length) {
+            throw std::invalid_argument(
+                "importTextMaze(): line " + std::to_string(i + 1) +
+                " does not end at the last post");
+        }
+    }
+
+    ImportedMaze imported{ { width, height } };
+    auto& maze = imported.maze;
+
+    Vector2 goal_min{ width, height }, goal_max{ -1, -1 };
+    for (int y = 0; y < height; ++y) {
+        const auto& cell_line = lines[2 * y + 1];
+        for (int x = 0; x < width; ++x) {
+            if (x < width - 1) {
+                maze.edge({ x, y }, Dir4::Right).hasWall =
+                    isWallText(cell_line, 4 * x + 4, 1);
+            }
+            if (y < height - 1) {
+                maze.edge({ x, y }, Dir4::Down).hasWall =
+                    isWallText(lines[2 * y + 2], 4 * x + 1, 3);
+            }
+
+            const auto mark = cell_line.substr(4 * x + 1, 3);
+            if (mark.find('G') != std::string::npos) {
+                goal_min = { std::min(goal_min.x, x), std::min(goal_min.y, y) };
+                goal_max = { std::max(goal_max.x, x), std::max(goal_max.y, y) };
+            }
+        }
+    }
+
+    imported.goal = goal_max.x < 0
+                        ? centerGoal(width, height)
+                        : MazeGoal{ goal_min,
+                                    { goal_max.x - goal_min.x + 1,
+                                      goal_max.y - goal_min.y + 1 } };
+
+    return imported;
+}
+
+ImportedMaze importMazMaze(std::istream& is) {
+    const std::vector<unsigned char> cells(
+        (std::istreambuf_iterator<char>(is)),
+        std::istreambuf_iterator<char>());
+    const int size =
+        static_cast<int>(std::lround(std::sqrt(double(cells.size()))));
+    if (size < 2 || static_cast<std::size_t>(size * size) != cells.size()) {
+        throw std::invalid_argument("importMazMaze(): not a square maze");
+    }
+
+    constexpr unsigned char EAST_WALL = 2, SOUTH_WALL = 4;
+    ImportedMaze imported{ { size, size }, centerGoal(size, size) };
+    auto& maze = imported.maze;
+    for (int x = 0; x < size; ++x) {
+        for (int y = 0; y < size; ++y) {
+            // The file counts rows from the bottom; the maze from the top
+            const auto walls = cells[x * size + (size - 1 - y)];
+            if (x < size - 1) {
+                maze.edge({ x, y }, Dir4::Right).hasWall = walls & EAST_WALL;
+            }
+            if (y < size - 1) {
+                maze.edge({ x, y }, Dir4::Down).hasWall = walls & SOUTH_WALL;
+            }
+        }
+    }
+
+    return imported;
+}
+
+ImportedMaze importMazeFile(const std::string& path) {
+    const bool binary =
+        path.size() >= 4 && path.compare(path.size() - 4, 4, ".maz") == 0;
+    std::ifstream file(path, binary ? std::ios::binary : std::ios::in);
+    if (!file) {
+        throw std::invalid_argument("importMazeFile(): cannot open " + path);
+    }
+
+    return binary ? importMazMaze(file) : importTextMaze(file);
+}
+
+}  // namespace Mazemouse
@@ -0,0 +1,372 @@
+#ifndef MAZE_CORPUS_HPP
+#define MAZE_CORPUS_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <istream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "Maze.hpp"
+
+namespace Mazemouse {
+
+/**
+ * The first bytes of every maze corpus file.
+ */
+constexpr char MAZE_CORPUS_MAGIC[8] = {
+    'M', 'Z', 'C', 'O', 'R', 'P', 'U', 'S',
+};
+
+constexpr std::uint32_t MAZE_CORPUS_VERSION = 1;
+
+/**
+ * Records are padded to a multiple of this many bytes, so that the header of
+ * every record is aligned.
+ */
+constexpr std::size_t MAZE_CORPUS_ALIGNMENT = 8;
+
+/**
+ * @brief The header at the start of a maze corpus file.
+ *
+ * A corpus file is this header followed by `numMazes` records of
+ * `recordSize` bytes each. A record is a `MazeRecordHeader` followed by the
+ * wall bits of the maze: bit `i` (bit `i % 8` of byte `i / 8`) is set if edge
+ * `i` of `Maze::edges` is open. All integers are little-endian.
+ */
+struct MazeCorpusHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t recordSize;
+    std::uint64_t numMazes;
+
+    /**
+     * The largest maze a record has room for.
+     */
+    std::uint16_t maxWidth;
+    std::uint16_t maxHeight;
+    std::uint32_t reserved;
+};
+
+static_assert(sizeof(MazeCorpusHeader) == 32);
+
+/**
+ * @brief The metadata of one maze in a corpus.
+ */
+struct MazeRecordHeader {
+    std::uint16_t width;
+    std::uint16_t height;
+
+    /**
+     * The top-left cell and the size of the goal area.
+     */
+    std::uint16_t goalX;
+    std::uint16_t goalY;
+    std::uint16_t goalWidth;
+    std::uint16_t goalHeight;
+
+    /**
+     * The seed the maze was generated with, or 0 for an imported maze.
+     */
+    std::uint32_t seed;
+};
+
+static_assert(sizeof(MazeRecordHeader) == 16);
+
+/**
+ * @brief The goal area of a maze: a rectangle of cells.
+ */
+struct MazeGoal {
+    Vector2 position{ 0, 0 };
+
+    Vector2 size{ 2, 2 };
+};
+
+/**
+ * @brief Returns the goal in the centre of a maze: the four centre cells.
+ */
+inline MazeGoal centerGoal(const int width, const int height) {
+    return { { width / 2 - 1, height / 2 - 1 }, { 2, 2 } };
+}
+
+/**
+ * @brief Returns the size of a record with room for a maze of the given
+ * size.
+ */
+std::size_t mazeRecordSize(int maxWidth, int maxHeight);
+
+/**
+ * @brief A read-only view of one maze of a corpus.
+ *
+ * The view reads the walls straight from the record, so taking one copies
+ * nothing. `writeTo()` copies the walls into a `Maze` for a mouse to run in.
+ */
+class MazeView {
+ public:
+    /**
+     * @param record The first byte of the record, aligned to
+     * `MAZE_CORPUS_ALIGNMENT`.
+     */
+    explicit MazeView(const std::byte* record);
+
+    [[nodiscard]] const MazeGeometry<DYNAMIC_SIZE>& getGeometry() const {
+        return geometry_;
+    }
+
+    [[nodiscard]] int width() const { return geometry_.width(); }
+
+    [[nodiscard]] int height() const { return geometry_.height(); }
+
+    [[nodiscard]] MazeGoal getGoal() const;
+
+    [[nodiscard]] std::uint32_t getSeed() const { return header_->seed; }
+
+    /**
+     * @brief Checks if edge `i` of `Maze::edges` is open.
+     */
+    [[nodiscard]] bool isOpen(const int edge) const {
+        return (walls_[edge / 8] >> (edge % 8)) & 1;
+    }
+
+    /**
+     * @brief Checks if the edge of a cell in the given direction is open.
+     * Edges on the border of the maze are never open.
+     */
+    [[nodiscard]] bool isOpenAt(const int index, const Dir4 dir) const {
+        const int edge = geometry_.edgeIndexOf(index, dir);
+        return edge != geometry_.borderEdge() && isOpen(edge);
+    }
+
+    /**
+     * @brief Copies the walls into a maze of the same size.
+     *
+     * @throws std::invalid_argument if the sizes of the mazes differ.
+     */
+    template <int S, DerivedFromCell C, DerivedFromEdge E>
+    void writeTo(const Maze<S, C, E>& maze) const;
+
+ private:
+    const MazeRecordHeader* header_;
+
+    const std::uint8_t* walls_;
+
+    MazeGeometry<DYNAMIC_SIZE> geometry_;
+};
+
+template <int S, DerivedFromCell C, DerivedFromEdge E>
+void MazeView::writeTo(const Maze<S, C, E>& maze) const {
+    if (maze.width() != width() || maze.height() != height()) {
+        throw std::invalid_argument("MazeView::writeTo(): size mismatch");
+    }
+
+    for (int i = 0; i < geometry_.numEdges(); ++i) {
+        maze.edges[i].hasWall = !isOpen(i);
+    }
+}
+
+/**
+ * @brief A maze corpus file, memory-mapped.
+ *
+ * Opening a corpus maps the file and checks its header; nothing is parsed,
+ * so it takes the same time however many mazes the corpus holds. The records
+ * are paged in as their views are read.
+ */
+class MazeCorpus {
+ public:
+    /**
+     * @brief Maps a corpus file.
+     *
+     * @throws std::invalid_argument if the file cannot be opened or is not a
+     * corpus of this version.
+     */
+    explicit MazeCorpus(const std::string& path);
+
+    MazeCorpus(const MazeCorpus&) = delete;
+
+    MazeCorpus& operator=(const MazeCorpus&) = delete;
+
+    ~MazeCorpus();
+
+    [[nodiscard]] const MazeCorpusHeader& getHeader() const {
+        return *reinterpret_cast<const MazeCorpusHeader*>(data_);
+    }
+
+    [[nodiscard]] std::size_t size() const { return num_mazes_; }
+
+    /**
+     * @brief Returns a view of maze `i`, which must be in range.
+     */
+    [[nodiscard]] MazeView operator[](const std::size_t i) const {
+        return MazeView(
+            data_ + sizeof(MazeCorpusHeader) + i * record_size_);
+    }
+
+    /**
+     * @brief Returns a view of maze `i`.
+     *
+     * @throws std::invalid_argument if `i` is out of range.
+     */
+    [[nodiscard]] MazeView at(std::size_t i) const;
+
+ private:
+    const std::byte* data_{ nullptr };
+
+    std::size_t file_size_{ 0 };
+
+    std::size_t num_mazes_{ 0 };
+
+    std::size_t record_size_{ 0 };
+};
+
+/**
+ * @brief Streams mazes into a new corpus file.
+ *
+ * Every maze is written as soon as it is added, so a corpus of any size is
+ * written with the memory of one record. The number of mazes is patched into
+ * the header by `close()`.
+ */
+class MazeCorpusWriter {
+ public:
+    /**
+     * @brief Creates a corpus file, replacing any existing one.
+     *
+     * @param maxWidth The largest width of a maze in the corpus.
+     * @param maxHeight The largest height of a maze in the corpus.
+     * @throws std::invalid_argument if the file cannot be created.
+     */
+    MazeCorpusWriter(const std::string& path, int maxWidth, int maxHeight);
+
+    MazeCorpusWriter(const MazeCorpusWriter&) = delete;
+
+    MazeCorpusWriter& operator=(const MazeCorpusWriter&) = delete;
+
+    /**
+     * @brief Closes the file if `close()` has not been called.
+     */
+    ~MazeCorpusWriter();
+
+    /**
+     * @brief Appends a maze.
+     *
+     * @param goal The goal area of the maze.
+     * @param seed The seed the maze was generated with, or 0.
+     * @throws std::invalid_argument if the maze is larger than the corpus
+     * allows.
+     */
+    template <int S, DerivedFromCell C, DerivedFromEdge E>
+    void write(
+        const Maze<S, C, E>& maze, const MazeGoal& goal,
+        std::uint32_t seed = 0);
+
+    /**
+     * @brief Appends a maze with its goal in the centre.
+     */
+    template <int S, DerivedFromCell C, DerivedFromEdge E>
+    void write(const Maze<S, C, E>& maze, const std::uint32_t seed = 0) {
+        write(maze, centerGoal(maze.width(), maze.height()), seed);
+    }
+
+    [[nodiscard]] std::size_t size() const { return num_mazes_; }
+
+    /**
+     * @brief Writes the number of mazes into the header and closes the file.
+     *
+     * @throws std::invalid_argument if writing the file failed.
+     */
+    void close();
+
+ private:
+    std::ofstream file_;
+
+    int max_width_;
+
+    int max_height_;
+
+    std::size_t num_mazes_{ 0 };
+
+    /**
+     * The record being written, reused for every maze.
+     */
+    std::vector<std::byte> record_;
+
+    void writeRecord(const MazeRecordHeader& header);
+};
+
+template <int S, DerivedFromCell C, DerivedFromEdge E>
+void MazeCorpusWriter::write(
+    const Maze<S, C, E>& maze, const MazeGoal& goal,
+    const std::uint32_t seed) {
+    if (maze.width() > max_width_ || maze.height() > max_height_) {
+        throw std::invalid_argument(
+            "MazeCorpusWriter::write(): the maze is larger than the corpus "
+            "allows");
+    }
+
+    std::fill(record_.begin(), record_.end(), std::byte{ 0 });
+    auto* const walls = reinterpret_cast<std::uint8_t*>(
+        record_.data() + sizeof(MazeRecordHeader));
+    for (int i = 0; i < maze.numEdges(); ++i) {
+        if (!maze.edges[i].hasWall) {
+            walls[i / 8] |= static_cast<std::uint8_t>(1 << (i % 8));
+        }
+    }
+
+    writeRecord({
+        static_cast<std::uint16_t>(maze.width()),
+        static_cast<std::uint16_t>(maze.height()),
+        static_cast<std::uint16_t>(goal.position.x),
+        static_cast<std::uint16_t>(goal.position.y),
+        static_cast<std::uint16_t>(goal.size.x),
+        static_cast<std::uint16_t>(goal.size.y),
+        seed,
+    });
+}
+
+/**
+ * @brief A maze read from a text or `.maz` file.
+ */
+struct ImportedMaze {
+    Maze<DYNAMIC_SIZE, Cell, Edge> maze;
+
+    MazeGoal goal{};
+};
+
+/**
+ * @brief Reads a maze drawn in text, as in the common maze file collections:
+ *
+ *     o---o---o
+ *     | S     |
+ *     o   o---o
+ *
+ * Every cell is three characters wide between two posts (`o`, `+` or `.`).
+ * A wall is any character other than a space between two posts. The cells
+ * marked `G` are the goal; without marks, the goal is the centre.
+ *
+ * @throws std::invalid_argument if the text is not a maze, or a line of
+ * posts does not end at the last post or a line of cells ends before it.
+ */
+ImportedMaze importTextMaze(std::istream& is);
+
+/**
+ * @brief Reads a maze in the classic binary `.maz` format: one byte per cell
+ * of a square maze (256 bytes for 16x16), column by column from the
+ * bottom-left corner, with the walls in bits 0 to 3 (north, east, south,
+ * west). The goal is the centre.
+ *
+ * @throws std::invalid_argument if the data is not a square maze.
+ */
+ImportedMaze importMazMaze(std::istream& is);
+
+/**
+ * @brief Reads a maze file, choosing the format by its extension: `.maz` is
+ * binary, anything else is text.
+ *
+ * @throws std::invalid_argument if the file cannot be opened or read.
+ */
+ImportedMaze importMazeFile(const std::string& path);
+
+}  // namespace Mazemouse
+
+#endif
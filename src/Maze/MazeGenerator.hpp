@@ -0,0 +1,560 @@
+#ifndef MAZE_GENERATOR_HPP
+#define MAZE_GENERATOR_HPP
+
+#include <algorithm>
+#include <array>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "../Container/FixedVector.hpp"
+#include "../Simulation/ThreadPool.hpp"
+#include "BitPlane.hpp"
+#include "Maze.hpp"
+
+namespace Mazemouse {
+
+/**
+ * The percentage of the remaining interior walls a competition maze removes
+ * to open loops.
+ */
+constexpr int COMPETITION_LOOP_PERCENT = 10;
+
+/**
+ * @brief The algorithm that carves the paths of a maze.
+ */
+enum class MazeAlgorithm {
+    /**
+     * A randomized depth-first search (recursive backtracker): long winding
+     * corridors with few branches.
+     */
+    DepthFirst,
+
+    /**
+     * Randomized Prim's algorithm: many short dead ends.
+     */
+    Prim,
+
+    /**
+     * Randomized Kruskal's algorithm: many short dead ends, evenly spread.
+     */
+    Kruskal,
+
+    /**
+     * Wilson's algorithm: a uniform spanning tree, unbiased among all perfect
+     * mazes.
+     */
+    Wilson,
+
+    /**
+     * A depth-first maze with loops, a goal room in the centre with a single
+     * entrance, and a start cell that only opens forward, as in micromouse
+     * competitions.
+     */
+    Competition,
+};
+
+/**
+ * @brief Returns the command-line name of an algorithm.
+ */
+inline std::string getMazeAlgorithmName(const MazeAlgorithm algorithm) {
+    switch (algorithm) {
+        case MazeAlgorithm::DepthFirst:
+            return "dfs";
+        case MazeAlgorithm::Prim:
+            return "prim";
+        case MazeAlgorithm::Kruskal:
+            return "kruskal";
+        case MazeAlgorithm::Wilson:
+            return "wilson";
+        case MazeAlgorithm::Competition:
+            return "competition";
+    }
+
+    return "unknown";
+}
+
+/**
+ * @brief Returns the algorithm with the given command-line name.
+ *
+ * @throws std::invalid_argument if no algorithm has the name.
+ */
+inline MazeAlgorithm parseMazeAlgorithm(const std::string& name) {
+    for (const auto algorithm :
+         { MazeAlgorithm::DepthFirst, MazeAlgorithm::Prim,
+           MazeAlgorithm::Kruskal, MazeAlgorithm::Wilson,
+           MazeAlgorithm::Competition }) {
+        if (getMazeAlgorithmName(algorithm) == name) {
+            return algorithm;
+        }
+    }
+
+    throw std::invalid_argument("unknown maze algorithm " + name);
+}
+
+/**
+ * @brief Returns the index of the cell a mouse starts from: the bottom-left
+ * corner.
+ */
+template <int S, DerivedFromCell C, DerivedFromEdge E>
+int startingCellIndex(const Maze<S, C, E>& maze) {
+    return maze.cellIndex({ 0, maze.height() - 1 });
+}
+
+/**
+ * @brief Returns the four centre cells of a maze: top-left, bottom-left,
+ * bottom-right and top-right.
+ */
+template <int S, DerivedFromCell C, DerivedFromEdge E>
+std::array<Vector2, 4> centerCells(const Maze<S, C, E>& maze) {
+    const int half_width = maze.width() / 2, half_height = maze.height() / 2;
+
+    return {
+        Vector2(half_width - 1, half_height - 1),
+        Vector2(half_width - 1, half_height),
+        Vector2(half_width, half_height),
+        Vector2(half_width, half_height - 1),
+    };
+}
+
+/**
+ * @brief Carves a perfect maze with a randomized depth-first search from the
+ * starting cell.
+ */
+template <int S, DerivedFromCell C, DerivedFromEdge E>
+void carveDepthFirst(const Maze<S, C, E>& maze, std::mt19937& rng) {
+    const int width = maze.width(), height = maze.height();
+
+    constexpr int N = S == DYNAMIC_SIZE ? DYNAMIC_SIZE : S * S;
+    BitPlane<N> visited(width * height);
+    FixedVector<Vector2, N> cell_stack(width * height);
+    Vector2 current = maze.cellCoord(startingCellIndex(maze));
+    cell_stack.push_back(current);
+    visited.set(current.y * width + current.x);
+
+    while (!cell_stack.empty()) {
+        current = cell_stack.back();
+
+        // Get possible directions
+        FixedVector<Dir4, 4> possible_dirs;
+        for (int i = 0; i < 4; i++) {
+            auto dir = static_cast<Dir4>(i);
+            const auto [x, y] = current + get_vector(static_cast<Dir4>(i));
+
+            // Check if the next cell is within bounds
+            if (x >= 0 && x < width && y >= 0 && y < height) {
+                if (!visited.test(y * width + x)) {
+                    possible_dirs.push_back(dir);
+                }
+            }
+        }
+
+        if (!possible_dirs.empty()) {
+            std::uniform_int_distribution dist(0, possible_dirs.size() - 1);
+            const Dir4 chosenDir = possible_dirs[dist(rng)];
+            maze.edge(current, chosenDir).hasWall = false;
+
+            Vector2 next = current + get_vector(chosenDir);
+            visited.set(next.y * width + next.x);
+            cell_stack.push_back(next);
+        } else {
+            cell_stack.pop_back();
+        }
+    }
+}
+
+/**
+ * @brief Carves a perfect maze with randomized Prim's algorithm: the maze
+ * grows from the starting cell by joining a random frontier cell to a random
+ * visited neighbour.
+ */
+template <int S, DerivedFromCell C, DerivedFromEdge E>
+void carvePrim(const Maze<S, C, E>& maze, std::mt19937& rng) {
+    const int num_cells = maze.numCells();
+
+    constexpr int N = S == DYNAMIC_SIZE ? DYNAMIC_SIZE : S * S;
+    BitPlane<N> visited(num_cells);
+    BitPlane<N> in_frontier(num_cells);
+    FixedVector<int, N> frontier(num_cells);
+
+    const auto visit = [&](const int index) {
+        visited.set(index);
+        for (int i = 0; i < 4; ++i) {
+            const int next = maze.neighbourIndex(index, static_cast<Dir4>(i));
+            if (next != NO_NEIGHBOUR && !visited.test(next) &&
+                !in_frontier.test(next)) {
+                in_frontier.set(next);
+                frontier.push_back(next);
+            }
+        }
+    };
+    visit(startingCellIndex(maze));
+
+    while (!frontier.empty()) {
+        // Take a random frontier cell out by swapping it with the last one
+        std::uniform_int_distribution pick(0, frontier.size() - 1);
+        const int chosen = pick(rng);
+        const int index = frontier[chosen];
+        frontier[chosen] = frontier.back();
+        frontier.pop_back();
+
+        FixedVector<Dir4, 4> visited_dirs;
+        for (int i = 0; i < 4; ++i) {
+            const auto dir = static_cast<Dir4>(i);
+            const int next = maze.neighbourIndex(index, dir);
+            if (next != NO_NEIGHBOUR && visited.test(next)) {
+                visited_dirs.push_back(dir);
+            }
+        }
+        std::uniform_int_distribution dist(0, visited_dirs.size() - 1);
+        maze.edgeAt(index, visited_dirs[dist(rng)]).hasWall = false;
+        visit(index);
+    }
+}
+
+/**
+ * @brief Carves a perfect maze with randomized Kruskal's algorithm: every
+ * interior wall, in random order, is removed if the cells on its two sides
+ * are not connected yet.
+ */
+template <int S, DerivedFromCell C, DerivedFromEdge E>
+void carveKruskal(const Maze<S, C, E>& maze, std::mt19937& rng) {
+    const int num_cells = maze.numCells();
+
+    constexpr int N = S == DYNAMIC_SIZE ? DYNAMIC_SIZE : S * S;
+    constexpr int M = S == DYNAMIC_SIZE ? DYNAMIC_SIZE : 2 * S * S;
+
+    // Every wall is a cell and its right (even) or bottom (odd) side
+    FixedVector<int, M> walls(2 * num_cells);
+    for (int index = 0; index < num_cells; ++index) {
+        if (maze.neighbourIndex(index, Dir4::Right) != NO_NEIGHBOUR) {
+            walls.push_back(2 * index);
+        }
+        if (maze.neighbourIndex(index, Dir4::Down) != NO_NEIGHBOUR) {
+            walls.push_back(2 * index + 1);
+        }
+    }
+    std::shuffle(walls.begin(), walls.end(), rng);
+
+    // A disjoint-set forest of the connected cells
+    FixedVector<int, N> parent(num_cells);
+    parent.resize(num_cells);
+    for (int index = 0; index < num_cells; ++index) {
+        parent[index] = index;
+    }
+    const auto find = [&](int index) {
+        while (parent[index] != index) {
+            parent[index] = parent[parent[index]];
+            index = parent[index];
+        }
+        return index;
+    };
+
+    for (const int wall : walls) {
+        const int index = wall / 2;
+        const auto dir = wall % 2 == 0 ? Dir4::Right : Dir4::Down;
+        const int root = find(index);
+        const int next_root = find(maze.neighbourIndex(index, dir));
+        if (root != next_root) {
+            parent[next_root] = root;
+            maze.edgeAt(index, dir).hasWall = false;
+        }
+    }
+}
+
+/**
+ * @brief Carves a perfect maze with Wilson's algorithm: from every cell not
+ * in the maze yet, a random walk runs until it hits the maze, and the walk
+ * with its loops erased is carved.
+ */
+template <int S, DerivedFromCell C, DerivedFromEdge E>
+void carveWilson(const Maze<S, C, E>& maze, std::mt19937& rng) {
+    const int num_cells = maze.numCells();
+
+    constexpr int N = S == DYNAMIC_SIZE ? DYNAMIC_SIZE : S * S;
+    BitPlane<N> in_maze(num_cells);
+    // The direction the walk last left every cell in; revisiting a cell
+    // overwrites it, which erases the loop
+    FixedVector<Dir4, N> exits(num_cells);
+    exits.resize(num_cells);
+    in_maze.set(startingCellIndex(maze));
+
+    for (int start = 0; start < num_cells; ++start) {
+        int index = start;
+        while (!in_maze.test(index)) {
+            FixedVector<Dir4, 4> dirs;
+            for (int i = 0; i < 4; ++i) {
+                const auto dir = static_cast<Dir4>(i);
+                if (maze.neighbourIndex(index, dir) != NO_NEIGHBOUR) {
+                    dirs.push_back(dir);
+                }
+            }
+            std::uniform_int_distribution dist(0, dirs.size() - 1);
+            exits[index] = dirs[dist(rng)];
+            index = maze.neighbourIndex(index, exits[index]);
+        }
+
+        index = start;
+        while (!in_maze.test(index)) {
+            maze.edgeAt(index, exits[index]).hasWall = false;
+            in_maze.set(index);
+            index = maze.neighbourIndex(index, exits[index]);
+        }
+    }
+}
+
+/**
+ * @brief Makes every cell reachable from the starting cell.
+ *
+ * A breadth-first search floods the cells reachable from the starting cell.
+ * Whenever it runs out, the wall between the first unreached cell and a
+ * reached neighbour is removed, and the flood continues from there. It is
+ * iterative and its storage is sized by the maze, so it works on mazes of
+ * any size.
+ *
+ * @param can_open Returns whether the wall of a cell in a direction may be
+ * removed.
+ * @return True if every cell is reachable; false if `can_open` walls some
+ * cells off.
+ */
+template <int S, DerivedFromCell C, DerivedFromEdge E, typename F>
+bool connectUnreachedCells(const Maze<S, C, E>& maze, F&& can_open) {
+    const int num_cells = maze.numCells();
+
+    constexpr int N = S == DYNAMIC_SIZE ? DYNAMIC_SIZE : S * S;
+    BitPlane<N> reached(num_cells);
+    FixedVector<int, N> queue(num_cells);
+    const int starting_index = startingCellIndex(maze);
+    reached.set(starting_index);
+    queue.push_back(starting_index);
+
+    int head = 0;
+    while (true) {
+        while (head < queue.size()) {
+            const int index = queue[head++];
+            for (int i = 0; i < 4; ++i) {
+                const auto dir = static_cast<Dir4>(i);
+                const int next = maze.neighbourIndex(index, dir);
+                if (next != NO_NEIGHBOUR && !reached.test(next) &&
+                    maze.isOpenAt(index, dir)) {
+                    reached.set(next);
+                    queue.push_back(next);
+                }
+            }
+        }
+        if (queue.size() == num_cells) {
+            return true;
+        }
+
+        bool opened = false;
+        for (int index = 0; index < num_cells && !opened; ++index) {
+            if (reached.test(index)) {
+                continue;
+            }
+            for (int i = 0; i < 4; ++i) {
+                const auto dir = static_cast<Dir4>(i);
+                const int next = maze.neighbourIndex(index, dir);
+                if (next != NO_NEIGHBOUR && reached.test(next) &&
+                    can_open(index, dir)) {
+                    maze.edgeAt(index, dir).hasWall = false;
+                    reached.set(index);
+                    queue.push_back(index);
+                    opened = true;
+                    break;
+                }
+            }
+        }
+        if (!opened) {
+            return false;
+        }
+    }
+}
+
+/**
+ * @brief Removes the walls between the four centre cells.
+ */
+template <int S, DerivedFromCell C, DerivedFromEdge E>
+void connectCenterCells(const Maze<S, C, E>& maze) {
+    auto dir = Dir4::Down;
+    for (const auto& centerCell : centerCells(maze)) {
+        maze.edge(centerCell, dir).hasWall = false;
+        dir = dir + Dir4::Left;
+    }
+}
+
+/**
+ * @brief Carves a competition maze: a depth-first maze with
+ * `COMPETITION_LOOP_PERCENT` of its walls removed, a walled goal room in the
+ * centre with one random entrance, and a starting cell that only opens up.
+ *
+ * A maze too small to have cells around the goal room, such as 2x2, has no
+ * room walls. A maze so narrow that the room cuts cells off, such as 2x4,
+ * gets more entrances.
+ */
+template <int S, DerivedFromCell C, DerivedFromEdge E>
+void carveCompetition(const Maze<S, C, E>& maze, std::mt19937& rng) {
+    carveDepthFirst(maze, rng);
+    connectCenterCells(maze);
+
+    // The walls that must stay: the goal room and the right of the start
+    const auto centers = centerCells(maze);
+    const auto is_center = [&](const int index) {
+        return std::find(
+                   centers.begin(), centers.end(), maze.cellCoord(index)) !=
+               centers.end();
+    };
+    FixedVector<int, 9> kept_walls;
+    for (const auto& center : centers) {
+        const int index = maze.cellIndex(center);
+        for (int i = 0; i < 4; ++i) {
+            const auto dir = static_cast<Dir4>(i);
+            const int next = maze.neighbourIndex(index, dir);
+            if (next != NO_NEIGHBOUR && !is_center(next)) {
+                kept_walls.push_back(maze.edgeIndexOf(index, dir));
+            }
+        }
+    }
+    const int num_room_walls = kept_walls.size();
+    const int starting_index = startingCellIndex(maze);
+    const int start_wall = maze.edgeIndexOf(starting_index, Dir4::Right);
+    if (!is_center(starting_index)) {
+        kept_walls.push_back(start_wall);
+    }
+    const auto is_kept = [&](const int edge) {
+        return std::find(kept_walls.begin(), kept_walls.end(), edge) !=
+               kept_walls.end();
+    };
+
+    std::uniform_int_distribution percent(0, 99);
+    for (int edge = 0; edge < maze.numEdges(); ++edge) {
+        if (maze.edges[edge].hasWall && !is_kept(edge) &&
+            percent(rng) < COMPETITION_LOOP_PERCENT) {
+            maze.edges[edge].hasWall = false;
+        }
+    }
+
+    for (const int edge : kept_walls) {
+        maze.edges[edge].hasWall = true;
+    }
+    if (num_room_walls > 0) {
+        std::uniform_int_distribution entrance(0, num_room_walls - 1);
+        maze.edges[kept_walls[entrance(rng)]].hasWall = false;
+    }
+
+    // Closing the walls may have cut cells off the start
+    const bool connected =
+        connectUnreachedCells(maze, [&](const int index, const Dir4 dir) {
+            return !is_kept(maze.edgeIndexOf(index, dir));
+        });
+    if (!connected &&
+        !connectUnreachedCells(maze, [&](const int index, const Dir4 dir) {
+            return maze.edgeIndexOf(index, dir) != start_wall;
+        })) {
+        throw std::logic_error(
+            "carveCompetition(): some cells cannot be reached");
+    }
+}
+
+/**
+ * @brief Carves the paths of a maze with the given algorithm.
+ *
+ * Every cell ends up reachable from the starting cell in the bottom-left
+ * corner, and the four centre cells are connected to each other. The same
+ * seed and algorithm always produce the same maze.
+ *
+ * The working storage is sized by the maze, and kept inline for compile-time
+ * sized mazes, so carving does not allocate per step.
+ *
+ * @param maze The maze to carve; all of its edges should have walls.
+ * @param seed The seed of the random number generator.
+ * @param algorithm The algorithm that carves the paths.
+ */
+template <int S, DerivedFromCell C, DerivedFromEdge E>
+void generateMaze(
+    const Maze<S, C, E>& maze, const int seed,
+    const MazeAlgorithm algorithm) {
+    std::mt19937 rng(seed);
+    switch (algorithm) {
+        case MazeAlgorithm::DepthFirst:
+            carveDepthFirst(maze, rng);
+            break;
+        case MazeAlgorithm::Prim:
+            carvePrim(maze, rng);
+            break;
+        case MazeAlgorithm::Kruskal:
+            carveKruskal(maze, rng);
+            break;
+        case MazeAlgorithm::Wilson:
+            carveWilson(maze, rng);
+            break;
+        case MazeAlgorithm::Competition:
+            carveCompetition(maze, rng);
+            return;
+    }
+
+    // Perfect mazes already connect every cell; this only guards the
+    // invariant
+    connectUnreachedCells(maze, [](int, Dir4) { return true; });
+    connectCenterCells(maze);
+}
+
+/**
+ * @brief Carves the paths of a maze with a randomized depth-first search.
+ *
+ * @param maze The maze to carve; all of its edges should have walls.
+ * @param seed The seed of the random number generator.
+ */
+template <int S, DerivedFromCell C, DerivedFromEdge E>
+void carvePaths(const Maze<S, C, E>& maze, const int seed) {
+    generateMaze(maze, seed, MazeAlgorithm::DepthFirst);
+}
+
+/**
+ * @brief Carves many mazes in parallel on a thread pool, maze `i` from
+ * `seeds[i]`.
+ *
+ * Every maze has a random number generator of its own, seeded only by its
+ * seed, so a maze does not depend on the other seeds, the number of threads,
+ * or the order the mazes are carved in.
+ *
+ * @param mazes The mazes to carve; all of their edges should have walls.
+ * @param seeds The seed of every maze.
+ * @param pool The pool that carves the mazes.
+ * @param algorithm The algorithm that carves the paths.
+ * @throws std::invalid_argument if there is not one seed per maze.
+ * @throws The first exception thrown while carving a maze, once every other
+ * maze is done.
+ */
+template <int S, DerivedFromCell C, DerivedFromEdge E>
+void generateBatch(
+    const std::vector<Maze<S, C, E>>& mazes, const std::vector<int>& seeds,
+    ThreadPool& pool,
+    const MazeAlgorithm algorithm = MazeAlgorithm::DepthFirst) {
+    if (mazes.size() != seeds.size()) {
+        throw std::invalid_argument(
+            "generateBatch(): there must be one seed per maze");
+    }
+
+    pool.parallelFor(static_cast<int>(mazes.size()), [&](const int i) {
+        generateMaze(mazes[i], seeds[i], algorithm);
+    });
+}
+
+/**
+ * @brief Carves many mazes in parallel on a thread pool of its own; see
+ * `generateBatch(mazes, seeds, pool, algorithm)`.
+ *
+ * @param numThreads The number of threads; 0 uses one per hardware thread.
+ */
+template <int S, DerivedFromCell C, DerivedFromEdge E>
+void generateBatch(
+    const std::vector<Maze<S, C, E>>& mazes, const std::vector<int>& seeds,
+    const unsigned numThreads = 0,
+    const MazeAlgorithm algorithm = MazeAlgorithm::DepthFirst) {
+    ThreadPool pool(numThreads);
+    generateBatch(mazes, seeds, pool, algorithm);
+}
+
+}  // namespace Mazemouse
+
+#endif
@@ -0,0 +1,273 @@
+#ifndef MAZE_GEOMETRY_HPP
+#define MAZE_GEOMETRY_HPP
+
+#include <array>
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
+#include "Dir4.hpp"
+#include "Vector2.hpp"
+
+namespace Mazemouse {
+
+/**
+ * Size template argument that selects the runtime-sized specialisation of a
+ * maze type. The width and height are then passed to the constructor.
+ */
+constexpr int DYNAMIC_SIZE = 0;
+
+/**
+ * Neighbour index returned for a direction that leaves the maze.
+ */
+constexpr int NO_NEIGHBOUR = -1;
+
+/**
+ * @brief Describes the dimensions of a maze and the layout of its cells and
+ * edges.
+ *
+ * Cells are stored row by row, so the index of the cell at (x, y) is
+ * `width * y + x`. Edges are stored in two halves: the first half holds the
+ * edges between vertically adjacent cells (column by column), and the second
+ * half holds the edges between horizontally adjacent cells (row by row).
+ * Storage reserves one extra slot after the real edges for the border edge,
+ * a sentinel that always has a wall; the unchecked accessors map every edge
+ * on the border of the maze to it so that wall lookups need no bounds check.
+ *
+ * @tparam S The size of a square maze, or `DYNAMIC_SIZE` for a maze whose
+ * width and height are chosen at runtime.
+ */
+template <int S>
+struct MazeGeometry {
+    static_assert(S > 1, "A maze must have at least two cells per side");
+
+    constexpr MazeGeometry() = default;
+
+    [[nodiscard]] static constexpr int width() { return S; }
+
+    [[nodiscard]] static constexpr int height() { return S; }
+
+    [[nodiscard]] static constexpr int numCells() { return S * S; }
+
+    [[nodiscard]] static constexpr int numEdges() { return (S - 1) * S * 2; }
+
+    /**
+     * Returns the index of the border edge sentinel.
+     */
+    [[nodiscard]] static constexpr int borderEdge() { return numEdges(); }
+
+    /**
+     * Returns the index of the cell at the given coordinates.
+     */
+    [[nodiscard]] static constexpr int cellIndex(const Vector2& coord) {
+        return S * coord.y + coord.x;
+    }
+
+    /**
+     * Returns the coordinates of the cell with the given index.
+     */
+    [[nodiscard]] static constexpr Vector2 cellCoord(const int index) {
+        return { index % S, index / S };
+    }
+
+    /**
+     * Returns the index of the edge at the given coordinates and direction.
+     */
+    [[nodiscard]] static constexpr int edgeIndex(
+        const Vector2& coord, const Dir4 dir) {
+        const auto dirInt = static_cast<int>(dir);
+        return dirInt % 2 == 0
+                   ? (S - 1) * coord.x + coord.y - (dirInt == 0)
+                   : (S - 1) * (S + coord.y) + coord.x - (dirInt == 3);
+    }
+
+    /**
+     * Checks if the given coordinates and direction are within the maze
+     * bounds.
+     */
+    [[nodiscard]] static constexpr bool withinBounds(
+        const Vector2& coord, const Dir4 dir) {
+        switch (dir) {
+            case Dir4::Up:
+                return coord.y > 0;
+            case Dir4::Right:
+                return coord.x < S - 1;
+            case Dir4::Down:
+                return coord.y < S - 1;
+            case Dir4::Left:
+                return coord.x > 0;
+        }
+        return false;
+    }
+
+    /**
+     * @brief Returns the index of the neighbouring cell in the given direction
+     * without bounds checking.
+     *
+     * @param index The index of the cell.
+     * @param dir The direction of the neighbour.
+     * @return The index of the neighbour, or `NO_NEIGHBOUR` if the direction
+     * leaves the maze.
+     */
+    [[nodiscard]] static constexpr int neighbourIndex(int index, Dir4 dir);
+
+    /**
+     * @brief Returns the index of the edge of a cell in the given direction
+     * without bounds checking.
+     *
+     * @param index The index of the cell.
+     * @param dir The direction of the edge.
+     * @return The index of the edge, or `borderEdge()` if the edge lies on the
+     * border of the maze.
+     */
+    [[nodiscard]] static constexpr int edgeIndexOf(int index, Dir4 dir);
+};
+
+/**
+ * Smallest integer type able to hold every cell and edge index of a maze.
+ */
+template <int S>
+using MazeIndex =
+    std::conditional_t<(S * S * 2 < INT16_MAX), std::int16_t, std::int32_t>;
+
+/**
+ * Table type holding one index per cell and direction.
+ */
+template <int S>
+using MazeIndexTable = std::array<std::array<MazeIndex<S>, 4>, S * S>;
+
+template <int S>
+constexpr MazeIndexTable<S> makeNeighbourTable() {
+    MazeIndexTable<S> table{};
+    for (int index = 0; index < S * S; ++index) {
+        const auto coord = MazeGeometry<S>::cellCoord(index);
+        for (int d = 0; d < 4; ++d) {
+            const auto dir = static_cast<Dir4>(d);
+            table[index][d] = static_cast<MazeIndex<S>>(
+                MazeGeometry<S>::withinBounds(coord, dir)
+                    ? MazeGeometry<S>::cellIndex(coord + get_vector(dir))
+                    : NO_NEIGHBOUR);
+        }
+    }
+
+    return table;
+}
+
+template <int S>
+constexpr MazeIndexTable<S> makeEdgeTable() {
+    MazeIndexTable<S> table{};
+    for (int index = 0; index < S * S; ++index) {
+        const auto coord = MazeGeometry<S>::cellCoord(index);
+        for (int d = 0; d < 4; ++d) {
+            const auto dir = static_cast<Dir4>(d);
+            table[index][d] = static_cast<MazeIndex<S>>(
+                MazeGeometry<S>::withinBounds(coord, dir)
+                    ? MazeGeometry<S>::edgeIndex(coord, dir)
+                    : MazeGeometry<S>::borderEdge());
+        }
+    }
+
+    return table;
+}
+
+/**
+ * Precomputed neighbour indices of every cell, indexed by cell and direction.
+ */
+template <int S>
+inline constexpr auto NEIGHBOUR_TABLE = makeNeighbourTable<S>();
+
+/**
+ * Precomputed edge indices of every cell, indexed by cell and direction.
+ */
+template <int S>
+inline constexpr auto EDGE_TABLE = makeEdgeTable<S>();
+
+template <int S>
+constexpr int MazeGeometry<S>::neighbourIndex(const int index, const Dir4 dir) {
+    return NEIGHBOUR_TABLE<S>[index][static_cast<int>(dir)];
+}
+
+template <int S>
+constexpr int MazeGeometry<S>::edgeIndexOf(const int index, const Dir4 dir) {
+    return EDGE_TABLE<S>[index][static_cast<int>(dir)];
+}
+
+/**
+ * @brief Runtime-sized maze geometry. The maze may be non-square.
+ */
+template <>
+struct MazeGeometry<DYNAMIC_SIZE> {
+    /**
+     * @param width The number of cells along the x-axis.
+     * @param height The number of cells along the y-axis.
+     * @throws std::invalid_argument if either dimension is less than 2.
+     */
+    MazeGeometry(const int width, const int height) :
+        width_(width), height_(height) {
+        if (width < 2 || height < 2) {
+            throw std::invalid_argument(
+                "MazeGeometry(): a maze must have at least two cells per side");
+        }
+    }
+
+    [[nodiscard]] int width() const { return width_; }
+
+    [[nodiscard]] int height() const { return height_; }
+
+    [[nodiscard]] int numCells() const { return width_ * height_; }
+
+    [[nodiscard]] int numEdges() const {
+        return width_ * (height_ - 1) + (width_ - 1) * height_;
+    }
+
+    [[nodiscard]] int borderEdge() const { return numEdges(); }
+
+    [[nodiscard]] int cellIndex(const Vector2& coord) const {
+        return width_ * coord.y + coord.x;
+    }
+
+    [[nodiscard]] Vector2 cellCoord(const int index) const {
+        return { index % width_, index / width_ };
+    }
+
+    [[nodiscard]] int edgeIndex(const Vector2& coord, const Dir4 dir) const {
+        const auto dirInt = static_cast<int>(dir);
+        return dirInt % 2 == 0 ? (height_ - 1) * coord.x + coord.y -
+                                     (dirInt == 0)
+                               : width_ * (height_ - 1) + (width_ - 1) * coord.y +
+                                     coord.x - (dirInt == 3);
+    }
+
+    [[nodiscard]] bool withinBounds(const Vector2& coord, const Dir4 dir) const {
+        switch (dir) {
+            case Dir4::Up:
+                return coord.y > 0;
+            case Dir4::Right:
+                return coord.x < width_ - 1;
+            case Dir4::Down:
+                return coord.y < height_ - 1;
+            case Dir4::Left:
+                return coord.x > 0;
+        }
+        return false;
+    }
+
+    [[nodiscard]] int neighbourIndex(const int index, const Dir4 dir) const {
+        const auto coord = cellCoord(index);
+        return withinBounds(coord, dir) ? cellIndex(coord + get_vector(dir))
+                                        : NO_NEIGHBOUR;
+    }
+
+    [[nodiscard]] int edgeIndexOf(const int index, const Dir4 dir) const {
+        const auto coord = cellCoord(index);
+        return withinBounds(coord, dir) ? edgeIndex(coord, dir) : borderEdge();
+    }
+
+ private:
+    int width_;
+
+    int height_;
+};
+
+}  // namespace Mazemouse
+
+#endif
@@ -0,0 +1,419 @@
+#ifndef WALL_BITBOARD_HPP
+#define WALL_BITBOARD_HPP
+
+#include <stdexcept>
+#include "BitPlane.hpp"
+#include "Maze.hpp"
+
+namespace Mazemouse {
+
+/**
+ * @brief Bit-packed wall storage for a maze.
+ *
+ * Instead of one `Edge` object per wall, the walls are kept in two bit planes
+ * with one bit per cell: `eastOpen` holds the edge on the right side of every
+ * cell and `southOpen` holds the edge below every cell. The edges above and
+ * to the left of a cell are the south and east edges of its neighbours, so a
+ * wall lookup is a single shift-and-mask. A set bit means the edge is open; a
+ * cleared bit means it is blocked by a wall. Edges on the border of the maze
+ * are always blocked.
+ *
+ * A mouse does not know every edge of the maze, so two more planes,
+ * `eastKnown` and `southKnown`, record which edges have been seen. An open
+ * edge is always known, and the border edges are known walls. Unknown edges
+ * read as blocked through `isOpen()`, which is the pessimistic view of the
+ * maze; the `mayBeOpen()` family reads them as open, which is the optimistic
+ * view. Both views are bitwise operations over the same planes.
+ *
+ * @tparam S The size of the maze (number of cells along one dimension), or
+ * `DYNAMIC_SIZE` to choose the width and height at runtime.
+ */
+template <int S>
+struct WallBitboard : MazeGeometry<S> {
+    using Plane = BitPlane<S == DYNAMIC_SIZE ? DYNAMIC_SIZE : S * S>;
+
+    /**
+     * Bit `i` is set if cell `i` is open towards `Dir4::Right`.
+     */
+    Plane eastOpen{};
+
+    /**
+     * Bit `i` is set if cell `i` is open towards `Dir4::Down`.
+     */
+    Plane southOpen{};
+
+    /**
+     * Bit `i` is set if the edge of cell `i` towards `Dir4::Right` is known.
+     */
+    Plane eastKnown{};
+
+    /**
+     * Bit `i` is set if the edge of cell `i` towards `Dir4::Down` is known.
+     */
+    Plane southKnown{};
+
+    WallBitboard()
+        requires(S != DYNAMIC_SIZE)
+        : WallBitboard(MazeGeometry<S>{}) {}
+
+    /**
+     * @brief Creates a bitboard where every edge is a known wall.
+     *
+     * @param geometry The dimensions of the maze.
+     */
+    explicit WallBitboard(const MazeGeometry<S>& geometry) :
+        MazeGeometry<S>(geometry), eastOpen(geometry.numCells()),
+        southOpen(geometry.numCells()),
+        eastKnown(Plane::filled(geometry.numCells())),
+        southKnown(Plane::filled(geometry.numCells())) {}
+
+    /**
+     * @brief Creates a bitboard where every edge except the border is
+     * unknown.
+     *
+     * @param geometry The dimensions of the maze.
+     */
+    [[nodiscard]] static WallBitboard unknown(const MazeGeometry<S>& geometry);
+
+    /**
+     * @brief Creates a bitboard where every edge except the border is open.
+     *
+     * @param geometry The dimensions of the maze.
+     */
+    [[nodiscard]] static WallBitboard allOpen(const MazeGeometry<S>& geometry);
+
+    /**
+     * @brief Creates a bitboard from the walls of the given maze.
+     *
+     * @param maze The maze to copy the walls from.
+     * @return A bitboard with the same open edges as the maze, where every
+     * edge is known.
+     */
+    template <DerivedFromCell C, DerivedFromEdge E>
+    [[nodiscard]] static WallBitboard fromMaze(const Maze<S, C, E>& maze);
+
+    /**
+     * @brief Writes the walls of this bitboard into the given maze.
+     *
+     * @param maze The maze whose `hasWall` and `isKnown` properties are
+     * overwritten.
+     */
+    template <DerivedFromCell C, DerivedFromEdge E>
+    void writeTo(const Maze<S, C, E>& maze) const;
+
+    /**
+     * @brief Checks if the edge of a cell in the given direction is open.
+     *
+     * Edges on the border of the maze are always reported as blocked.
+     *
+     * @param index The index of the cell.
+     * @param dir The direction of the edge.
+     * @return True if the edge is open, false otherwise.
+     */
+    [[nodiscard]] constexpr bool isOpen(int index, Dir4 dir) const;
+
+    [[nodiscard]] constexpr bool isOpen(const Vector2& coord, Dir4 dir) const {
+        return isOpen(this->cellIndex(coord), dir);
+    }
+
+    /**
+     * @brief Checks if the edge of a cell in the given direction is known.
+     *
+     * Edges on the border of the maze are always reported as known.
+     *
+     * @param index The index of the cell.
+     * @param dir The direction of the edge.
+     */
+    [[nodiscard]] constexpr bool isKnown(int index, Dir4 dir) const;
+
+    /**
+     * @brief Checks if the edge of a cell in the given direction is open or
+     * unknown.
+     *
+     * @param index The index of the cell.
+     * @param dir The direction of the edge.
+     * @return False only if the edge is known to be blocked.
+     */
+    [[nodiscard]] constexpr bool mayBeOpen(int index, Dir4 dir) const;
+
+    /**
+     * @brief Opens or closes the edge of a cell in the given direction.
+     *
+     * @param coord The coordinates of the cell.
+     * @param dir The direction of the edge.
+     * @param open True to remove the wall, false to put it back.
+     * @throws std::invalid_argument if the edge is on the border of the maze.
+     */
+    void setOpen(const Vector2& coord, Dir4 dir, bool open);
+
+    /**
+     * @brief Opens or closes the edge of a cell in the given direction
+     * without bounds checking, and marks it as known.
+     *
+     * The edge must not lie on the border of the maze.
+     *
+     * @param index The index of the cell.
+     * @param dir The direction of the edge.
+     * @param open True to remove the wall, false to put it back.
+     */
+    constexpr void setOpenAt(int index, Dir4 dir, bool open);
+
+    /**
+     * @brief Returns the open directions of a cell as a 4-bit mask.
+     *
+     * Bit `d` of the result is set if the cell is open towards
+     * `static_cast<Dir4>(d)`.
+     *
+     * @param index The index of the cell.
+     */
+    [[nodiscard]] constexpr int openMask(int index) const;
+
+    /**
+     * @brief Returns the directions of a cell that are open or unknown as a
+     * 4-bit mask, in the same layout as `openMask()`.
+     *
+     * @param index The index of the cell.
+     */
+    [[nodiscard]] constexpr int mayBeOpenMask(int index) const;
+
+    /**
+     * @brief Returns the set of all cells that are open towards the given
+     * direction.
+     *
+     * @param dir The direction to query.
+     * @return A plane where bit `i` is set if cell `i` is open towards `dir`.
+     */
+    [[nodiscard]] constexpr Plane openTowards(Dir4 dir) const;
+
+    /**
+     * @brief Returns the set of all cells that are open or unknown towards
+     * the given direction.
+     *
+     * @param dir The direction to query.
+     * @return A plane where bit `i` is set unless cell `i` is known to be
+     * blocked towards `dir`.
+     */
+    [[nodiscard]] constexpr Plane mayBeOpenTowards(Dir4 dir) const;
+
+    /**
+     * @brief Returns the optimistic view of this bitboard, where every
+     * unknown edge is open and every edge is known.
+     */
+    [[nodiscard]] WallBitboard optimistic() const;
+
+    /**
+     * @brief Returns the pessimistic view of this bitboard, where every
+     * unknown edge is blocked and every edge is known.
+     */
+    [[nodiscard]] WallBitboard pessimistic() const;
+};
+
+template <int S>
+WallBitboard<S> WallBitboard<S>::allOpen(const MazeGeometry<S>& geometry) {
+    WallBitboard bitboard(geometry);
+    for (int y = 0; y < geometry.height(); ++y) {
+        for (int x = 0; x < geometry.width(); ++x) {
+            const auto index = geometry.cellIndex({ x, y });
+            bitboard.eastOpen.assign(index, x < geometry.width() - 1);
+            bitboard.southOpen.assign(index, y < geometry.height() - 1);
+        }
+    }
+
+    return bitboard;
+}
+
+template <int S>
+WallBitboard<S> WallBitboard<S>::unknown(const MazeGeometry<S>& geometry) {
+    WallBitboard bitboard(geometry);
+    for (int y = 0; y < geometry.height(); ++y) {
+        for (int x = 0; x < geometry.width(); ++x) {
+            const auto index = geometry.cellIndex({ x, y });
+            bitboard.eastKnown.assign(index, x == geometry.width() - 1);
+            bitboard.southKnown.assign(index, y == geometry.height() - 1);
+        }
+    }
+
+    return bitboard;
+}
+
+template <int S>
+template <DerivedFromCell C, DerivedFromEdge E>
+WallBitboard<S> WallBitboard<S>::fromMaze(const Maze<S, C, E>& maze) {
+    WallBitboard bitboard(maze);
+    for (int y = 0; y < maze.height(); ++y) {
+        for (int x = 0; x < maze.width(); ++x) {
+            const auto index = maze.cellIndex({ x, y });
+            bitboard.eastOpen.assign(index, maze.isOpen({ x, y }, Dir4::Right));
+            bitboard.southOpen.assign(index, maze.isOpen({ x, y }, Dir4::Down));
+        }
+    }
+
+    return bitboard;
+}
+
+template <int S>
+template <DerivedFromCell C, DerivedFromEdge E>
+void WallBitboard<S>::writeTo(const Maze<S, C, E>& maze) const {
+    for (int y = 0; y < this->height(); ++y) {
+        for (int x = 0; x < this->width(); ++x) {
+            const auto index = this->cellIndex({ x, y });
+            if (x < this->width() - 1) {
+                const auto& edge = maze.edge({ x, y }, Dir4::Right);
+                edge.hasWall = !eastOpen.test(index);
+                edge.isKnown = eastKnown.test(index);
+            }
+            if (y < this->height() - 1) {
+                const auto& edge = maze.edge({ x, y }, Dir4::Down);
+                edge.hasWall = !southOpen.test(index);
+                edge.isKnown = southKnown.test(index);
+            }
+        }
+    }
+}
+
+template <int S>
+constexpr bool WallBitboard<S>::isOpen(const int index, const Dir4 dir) const {
+    switch (dir) {
+        case Dir4::Up:
+            return index >= this->width() &&
+                   southOpen.test(index - this->width());
+        case Dir4::Right:
+            return eastOpen.test(index);
+        case Dir4::Down:
+            return southOpen.test(index);
+        case Dir4::Left:
+            // The east edge of the last cell of the row above is a border
+            // wall, so a left edge needs no column test
+            return index != 0 && eastOpen.test(index - 1);
+    }
+    return false;
+}
+
+template <int S>
+constexpr bool WallBitboard<S>::isKnown(const int index, const Dir4 dir) const {
+    switch (dir) {
+        case Dir4::Up:
+            return index < this->width() ||
+                   southKnown.test(index - this->width());
+        case Dir4::Right:
+            return eastKnown.test(index);
+        case Dir4::Down:
+            return southKnown.test(index);
+        case Dir4::Left:
+            // Border edges are known, like the east edge of the row above
+            return index == 0 || eastKnown.test(index - 1);
+    }
+    return true;
+}
+
+template <int S>
+constexpr bool WallBitboard<S>::mayBeOpen(
+    const int index, const Dir4 dir) const {
+    return isOpen(index, dir) || !isKnown(index, dir);
+}
+
+template <int S>
+void WallBitboard<S>::setOpen(
+    const Vector2& coord, const Dir4 dir, const bool open) {
+    if (!this->withinBounds(coord, dir)) {
+        throw std::invalid_argument(
+            "WallBitboard::setOpen(): coord is out of range");
+    }
+
+    setOpenAt(this->cellIndex(coord), dir, open);
+}
+
+template <int S>
+constexpr void WallBitboard<S>::setOpenAt(
+    const int index, const Dir4 dir, const bool open) {
+    switch (dir) {
+        case Dir4::Up:
+            southOpen.assign(index - this->width(), open);
+            southKnown.set(index - this->width());
+            break;
+        case Dir4::Right:
+            eastOpen.assign(index, open);
+            eastKnown.set(index);
+            break;
+        case Dir4::Down:
+            southOpen.assign(index, open);
+            southKnown.set(index);
+            break;
+        case Dir4::Left:
+            eastOpen.assign(index - 1, open);
+            eastKnown.set(index - 1);
+    }
+}
+
+template <int S>
+constexpr int WallBitboard<S>::openMask(const int index) const {
+    return isOpen(index, Dir4::Up) << static_cast<int>(Dir4::Up) |
+           isOpen(index, Dir4::Right) << static_cast<int>(Dir4::Right) |
+           isOpen(index, Dir4::Down) << static_cast<int>(Dir4::Down) |
+           isOpen(index, Dir4::Left) << static_cast<int>(Dir4::Left);
+}
+
+template <int S>
+constexpr int WallBitboard<S>::mayBeOpenMask(const int index) const {
+    return mayBeOpen(index, Dir4::Up) << static_cast<int>(Dir4::Up) |
+           mayBeOpen(index, Dir4::Right) << static_cast<int>(Dir4::Right) |
+           mayBeOpen(index, Dir4::Down) << static_cast<int>(Dir4::Down) |
+           mayBeOpen(index, Dir4::Left) << static_cast<int>(Dir4::Left);
+}
+
+template <int S>
+constexpr typename WallBitboard<S>::Plane WallBitboard<S>::openTowards(
+    const Dir4 dir) const {
+    switch (dir) {
+        case Dir4::Up:
+            return southOpen << this->width();
+        case Dir4::Right:
+            return eastOpen;
+        case Dir4::Down:
+            return southOpen;
+        case Dir4::Left:
+            return eastOpen << 1;
+    }
+    return Plane(this->numCells());
+}
+
+template <int S>
+constexpr typename WallBitboard<S>::Plane WallBitboard<S>::mayBeOpenTowards(
+    const Dir4 dir) const {
+    // The border edges are known walls, so their bits stay cleared
+    switch (dir) {
+        case Dir4::Up:
+            return (southOpen | ~southKnown) << this->width();
+        case Dir4::Right:
+            return eastOpen | ~eastKnown;
+        case Dir4::Down:
+            return southOpen | ~southKnown;
+        case Dir4::Left:
+            return (eastOpen | ~eastKnown) << 1;
+    }
+    return Plane(this->numCells());
+}
+
+template <int S>
+WallBitboard<S> WallBitboard<S>::optimistic() const {
+    WallBitboard bitboard(*this);
+    bitboard.eastOpen |= ~eastKnown;
+    bitboard.southOpen |= ~southKnown;
+    bitboard.eastKnown = Plane::filled(this->numCells());
+    bitboard.southKnown = Plane::filled(this->numCells());
+
+    return bitboard;
+}
+
+template <int S>
+WallBitboard<S> WallBitboard<S>::pessimistic() const {
+    WallBitboard bitboard(*this);
+    bitboard.eastKnown = Plane::filled(this->numCells());
+    bitboard.southKnown = Plane::filled(this->numCells());
+
+    return bitboard;
+}
+
+}  // namespace Mazemouse
+
+#endif
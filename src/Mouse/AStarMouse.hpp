@@ -1,59 +1,238 @@
 #ifndef A_STAR_MOUSE_HPP
 #define A_STAR_MOUSE_HPP
+
+#include <limits>
+#include <type_traits>
+#include "../Container/IndexedHeap.hpp"
 #include "FloodFillMouse.hpp"
+#include "MotionPrimitive.hpp"
 
 namespace Mazemouse {
 
-template <int S, DerivedFromFloodFillCell C, DerivedFromEdge E>
-class AStarMouse : public FloodFillMouse<S, C, E> {
+/**
+ * @brief The cell memory of an `AStarMouse`; see `BasicFloodFillCell`.
+ */
+template <typename V, typename D>
+struct BasicAStarCell : BasicFloodFillCell<V, D> {
+    /**
+     * The number of cells on the best known path from the starting cell, or
+     * the maximum of `D` if no path is known.
+     */
+    mutable D cost{ std::numeric_limits<D>::max() };
+
+    /**
+     * The absolute direction of the last move on that path.
+     */
+    mutable Dir4 parent{ Dir4::Up };
+
+    /**
+     * The number of cells to the nearest finishing cell assuming that every
+     * unknown edge is open, which never overestimates the known path.
+     */
+    mutable D estimate{ 0 };
+};
+
+/**
+ * The cell memory of an `AStarMouse` that can use every exploration mode.
+ */
+struct AStarCell : BasicAStarCell<int, int>, KnownDistanceCell<int> {};
+
+/**
+ * An `AStarCell` for small memories; see `CompactFloodFillCell`.
+ */
+template <int S>
+using CompactAStarCell = BasicAStarCell<std::uint8_t, CompactDistance<S>>;
+
+template <typename C>
+concept DerivedFromAStarCell = std::is_base_of_v<
+    BasicAStarCell<typename C::VisitCount, typename C::Distance>, C>;
+
+/**
+ * @brief A mouse that explores like a `FloodFillMouse`, then rushes along the
+ * shortest path it knows.
+ *
+ * When a rush starts, an A* search over the edges known to be open finds the
+ * shortest path from the starting cell to the finishing cells. It is guided
+ * by the distance to the finish over the optimistic view of the walls, which
+ * a bit-parallel flood computes for every cell at once. The resulting
+ * directions are compiled into motion primitives (straight runs, smooth
+ * turns and diagonals) timed with `motion_profile`, one per rushing cycle, so
+ * the plan is never stored.
+ */
+template <
+    int S, DerivedFromAStarCell C, DerivedFromEdge E,
+    typename Hw = MouseHardwareInterface>
+class AStarMouse : public FloodFillMouse<S, C, E, Hw> {
  public:
-    AStarMouse(const Vector2 startingPosition, const Dir4 startingOrientation) :
-        FloodFillMouse<S, C, E>(startingPosition, startingOrientation){};
+    AStarMouse(const Vector2 startingPosition, const Dir4 startingOrientation)
+        requires(S != DYNAMIC_SIZE)
+        : AStarMouse(startingPosition, startingOrientation, {}) {}
 
-    void nextExploringCycle() override;
+    AStarMouse(
+        const Vector2 startingPosition, const Dir4 startingOrientation,
+        Maze<S, C, E> maze) :
+        FloodFillMouse<S, C, E, Hw>(
+            startingPosition, startingOrientation, std::move(maze)),
+        open_cells(this->maze.numCells()) {}
 
+    /**
+     * The limits of the mouse, which the rush is timed with.
+     */
+    MotionProfile motion_profile{};
+
+    /**
+     * @brief Plans the rush when it starts, then runs the next motion
+     * primitive.
+     */
     void nextRushingCycle() override;
 
     void resetRushingState() override;
 
  protected:
-    std::vector<Dir4> vector{};
+    /**
+     * @brief Replaces `route` with the shortest known path from the current
+     * cell to the finish.
+     *
+     * @return True if a path was found; otherwise `route` is left unchanged.
+     */
+    virtual bool planRoute();
 
-    int total_step{ 0 };
-};
+    /**
+     * @brief Floods the `estimate` of every cell from the finishing cells.
+     */
+    void floodEstimates();
+
+    /**
+     * @brief Returns the estimated distance from a cell to the nearest
+     * finishing cell; `floodEstimates()` must have been run.
+     */
+    [[nodiscard]] int estimateDistance(int index) const {
+        return this->maze.cellAt(index).estimate;
+    }
 
-template <int S, DerivedFromFloodFillCell C, DerivedFromEdge E>
-void AStarMouse<S, C, E>::nextExploringCycle() {
-    FloodFillMouse<S, C, E>::nextExploringCycle();
+    /**
+     * The key of a cell in `open_cells`, below `2 * n * (n + 1)` for `n`
+     * cells: an `int` suffices up to 128 by 128 cells.
+     */
+    using Key = std::conditional_t<S != DYNAMIC_SIZE && S <= 128, int, long>;
+
+    /**
+     * The cells discovered but not yet expanded by `planRoute()`, keyed by
+     * their estimated total cost.
+     */
+    IndexedHeap<Key, S == DYNAMIC_SIZE ? DYNAMIC_SIZE : S * S> open_cells;
+
+    /**
+     * Compiles `route` into the motion primitives of the rush, one per
+     * rushing cycle.
+     */
+    MotionCompiler motion_compiler{};
+
+    /**
+     * True once the rush has been planned. A rush that starts by turning in
+     * place is still in the starting cell after its first cycle.
+     */
+    bool rush_planned{ false };
+};
 
-    if (this->state == MouseState::ReturningToStart && vector.empty()) {
-        // Copy the stack
-        vector = this->stack;
+template <int S, DerivedFromAStarCell C, DerivedFromEdge E, typename Hw>
+void AStarMouse<S, C, E, Hw>::nextRushingCycle() {
+    if (!rush_planned) {
+        planRoute();
+        motion_compiler.start(this->orientation, motion_profile);
+        rush_planned = true;
     }
-}
 
-template <int S, DerivedFromFloodFillCell C, DerivedFromEdge E>
-void AStarMouse<S, C, E>::nextRushingCycle() {
-    if (this->hasArrivedAtFinish()) {
+    // The last primitive may enter no cell: it stops in the finishing cell
+    MotionPrimitive primitive;
+    if (!motion_compiler.next(this->route, primitive) ||
+        (this->hasArrivedAtFinish() && primitive.cells > 0)) {
         this->state = MouseState::Stopped;
         return;
     }
 
-    const auto absolute_dir = vector[total_step++];
-    this->turn(absolute_dir);
+    this->rush_step += primitive.cells;
+    this->derived().runPrimitive(primitive);
+}
+
+template <int S, DerivedFromAStarCell C, DerivedFromEdge E, typename Hw>
+void AStarMouse<S, C, E, Hw>::resetRushingState() {
+    FloodFillMouse<S, C, E, Hw>::resetRushingState();
+    rush_planned = false;
+}
 
-    int step = 1;
-    while (total_step < vector.size() && vector[total_step] == absolute_dir) {
-        step++;
-        total_step++;
+template <int S, DerivedFromAStarCell C, DerivedFromEdge E, typename Hw>
+bool AStarMouse<S, C, E, Hw>::planRoute() {
+    const int num_cells = this->maze.numCells();
+    const auto no_cost = std::numeric_limits<typename C::Distance>::max();
+    for (int i = 0; i < num_cells; ++i) {
+        this->maze.cellAt(i).cost = no_cost;
     }
-    this->moveForward(step);
+    floodEstimates();
+
+    // Among equal estimates, expand the cell farthest from the start first
+    const auto keyOf = [&](const int index, const int cost) {
+        return static_cast<Key>(cost + estimateDistance(index)) *
+                   (num_cells + 1) -
+               cost;
+    };
+
+    const auto starting_index = this->maze.cellIndex(this->position);
+    this->maze.cellAt(starting_index).cost = 0;
+    open_cells.clear();
+    open_cells.push(starting_index, keyOf(starting_index, 0));
+
+    int finishing_index = NO_NEIGHBOUR;
+    while (!open_cells.empty()) {
+        const auto index = open_cells.pop();
+        if (this->isFinishCell(this->maze.cellCoord(index))) {
+            finishing_index = index;
+            break;
+        }
+
+        const auto next_cost = this->maze.cellAt(index).cost + 1;
+        const auto open_mask = this->walls.openMask(index);
+        for (int d = 0; d < 4; ++d) {
+            if (!(open_mask >> d & 1)) {
+                continue;
+            }
+
+            const auto dir = static_cast<Dir4>(d);
+            const int neighbour_index = this->maze.neighbourIndex(index, dir);
+            const auto& neighbour = this->maze.cellAt(neighbour_index);
+            if (next_cost < neighbour.cost) {
+                neighbour.cost = next_cost;
+                neighbour.parent = dir;
+                open_cells.push(
+                    neighbour_index, keyOf(neighbour_index, next_cost));
+            }
+        }
+    }
+
+    if (finishing_index == NO_NEIGHBOUR) {
+        return false;
+    }
+
+    // Walk back from the finish along the parent directions
+    this->route.clear();
+    for (int index = finishing_index; index != starting_index;) {
+        const auto dir = this->maze.cellAt(index).parent;
+        this->route.push_back(dir);
+        index = this->maze.neighbourIndex(index, dir + Dir4::Down);
+    }
+    this->route.reverse();
+    this->rush_step = 0;
+
+    return true;
 }
 
-template <int S, DerivedFromFloodFillCell C, DerivedFromEdge E>
-void AStarMouse<S, C, E>::resetRushingState() {
-    Mouse<S, C, E>::resetRushingState();
-    this->total_step = 0;
+template <int S, DerivedFromAStarCell C, DerivedFromEdge E, typename Hw>
+void AStarMouse<S, C, E, Hw>::floodEstimates() {
+    this->bit_flood.distances(
+        this->walls, WallView::Optimistic, this->finish_cells,
+        [&](const int i) -> typename C::Distance& {
+            return this->maze.cellAt(i).estimate;
+        });
 }
 
 }  // namespace Mazemouse
@@ -0,0 +1,81 @@
+#ifndef COMPACT_MOUSE_HPP
+#define COMPACT_MOUSE_HPP
+
+#include <array>
+#include <cstddef>
+#include "AStarMouse.hpp"
+
+namespace Mazemouse {
+
+/**
+ * A `FloodFillMouse` whose maze memory fits small microcontrollers: 8-bit
+ * saturating visit counters, distances of 8 or 16 bits, walls only in the
+ * `WallBitboard` (the maze keeps `NoEdge`) and 2-bit route stacks. Its cells
+ * keep no `known_distance`, so it explores in `ExplorationMode::LeastVisited`
+ * or `ExplorationMode::FloodFill`.
+ */
+template <int S, typename Hw = MouseHardwareInterface>
+using CompactFloodFillMouse =
+    FloodFillMouse<S, CompactFloodFillCell<S>, NoEdge, Hw>;
+
+/**
+ * An `AStarMouse` with the memory layout of `CompactFloodFillMouse`.
+ */
+template <int S, typename Hw = MouseHardwareInterface>
+using CompactAStarMouse = AStarMouse<S, CompactAStarCell<S>, NoEdge, Hw>;
+
+/**
+ * The bytes of RAM a mouse may take on a small microcontroller.
+ */
+constexpr std::size_t SMALL_MCU_BUDGET = 8 * 1024;
+
+/**
+ * @brief The memory taken by a mouse configuration, against the budget of
+ * the microcontroller it targets.
+ */
+struct MemoryFootprint {
+    const char* name;
+
+    /**
+     * The size of the mouse object. Compile-time sized mice keep all their
+     * memory inline, so this is everything they use.
+     */
+    std::size_t bytes;
+
+    /**
+     * The bytes available, or 0 for configurations meant for a host.
+     */
+    std::size_t budget;
+};
+
+/**
+ * The footprints of the compile-time sized configurations, for reports.
+ */
+inline constexpr std::array MEMORY_FOOTPRINTS = {
+    MemoryFootprint{ "flood-fill 16x16",
+                     sizeof(FloodFillMouse<16, FloodFillCell, Edge>), 0 },
+    MemoryFootprint{ "astar 16x16", sizeof(AStarMouse<16, AStarCell, Edge>),
+                     0 },
+    MemoryFootprint{ "compact flood-fill 16x16",
+                     sizeof(CompactFloodFillMouse<16>), SMALL_MCU_BUDGET },
+    MemoryFootprint{ "compact astar 16x16", sizeof(CompactAStarMouse<16>),
+                     SMALL_MCU_BUDGET },
+    MemoryFootprint{ "compact flood-fill 32x32",
+                     sizeof(CompactFloodFillMouse<32>), SMALL_MCU_BUDGET },
+};
+
+static_assert(
+    sizeof(CompactFloodFillMouse<16>) <= SMALL_MCU_BUDGET,
+    "a compact 16x16 flood-fill mouse must fit a small microcontroller");
+
+static_assert(
+    sizeof(CompactAStarMouse<16>) <= SMALL_MCU_BUDGET,
+    "a compact 16x16 A* mouse must fit a small microcontroller");
+
+static_assert(
+    sizeof(CompactFloodFillMouse<32>) <= SMALL_MCU_BUDGET,
+    "a compact 32x32 flood-fill mouse must fit a small microcontroller");
+
+}  // namespace Mazemouse
+
+#endif
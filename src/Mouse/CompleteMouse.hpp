@@ -13,6 +13,8 @@ class CompleteMouse final : public SemiFinishedMouse<MAZE_LENGTH_SIDE> {
     void hardwareMoveForward(int step) override;
 
     void hardwareTurn(Dir4 relative_dir) override;
+
+    void hardwareRunPrimitive(const MotionPrimitive& primitive) override;
 };
 
 inline bool CompleteMouse::hardwareCheckWall(Dir4 dir) { return true; }
@@ -21,6 +23,9 @@ inline void CompleteMouse::hardwareMoveForward(int step) {}
 
 inline void CompleteMouse::hardwareTurn(Dir4 relative_dir) {}
 
+inline void CompleteMouse::hardwareRunPrimitive(
+    const MotionPrimitive& primitive) {}
+
 }  // namespace Mazemouse
 
 #endif
@@ -1,26 +1,184 @@
 #ifndef FLOOD_FILL_MOUSE_HPP
 #define FLOOD_FILL_MOUSE_HPP
 
+#include <array>
+#include <climits>
+#include <cstdint>
 #include <iostream>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include "../Container/PackedDirs.hpp"
+#include "../Container/RingQueue.hpp"
+#include "../Maze/BitFlood.hpp"
+#include "../Maze/WallBitboard.hpp"
 #include "Mouse.hpp"
 
 namespace Mazemouse {
 
-struct FloodFillCell : Cell {
-    mutable int num_visited{ 0 };
+/**
+ * A `FloodFillMouse` recomputes all distances instead of repairing them once
+ * more than 1 / `REFLOOD_FRACTION` of the cells have to be raised.
+ */
+constexpr int REFLOOD_FRACTION = 4;
+
+/**
+ * The most cells one exploring cycle queues for repair: the two cells next to
+ * each of the three walls the mouse can discover.
+ */
+constexpr int MAX_MARKED_CELLS = 6;
+
+/**
+ * @brief Returns the capacity of the repair queues of a `FloodFillMouse`.
+ *
+ * A repair that needs more room than this touches over 1 / `REFLOOD_FRACTION`
+ * of the maze, which is recomputed in full instead, so the queues never need
+ * a slot per cell.
+ */
+constexpr int floodQueueCapacity(const int numCells) {
+    return numCells / REFLOOD_FRACTION + MAX_MARKED_CELLS;
+}
+
+/**
+ * @brief The cell memory of a `FloodFillMouse`, enough for every exploration
+ * mode but `ExplorationMode::FloodFillUntilOptimal`, which needs a
+ * `KnownDistanceCell` as well.
+ *
+ * @tparam V The type of the visit counter, which saturates at its maximum.
+ * @tparam D The type of the distances and of the cell indices queued by the
+ * mouse. It must hold the number of cells of the maze.
+ */
+template <typename V, typename D>
+struct BasicFloodFillCell : Cell {
+    using VisitCount = V;
+
+    using Distance = D;
+
+    mutable V num_visited{ 0 };
+
+    /**
+     * The number of cells to the nearest target cell, assuming that every
+     * edge not yet known to have a wall is open. The targets are the
+     * finishing cells, or the starting cell while an
+     * `ExplorationMode::FloodFillUntilOptimal` mouse heads back to it. Not
+     * maintained in `ExplorationMode::LeastVisited`.
+     */
+    mutable D distance{ 0 };
 };
 
+/**
+ * @brief The cell memory `ExplorationMode::FloodFillUntilOptimal` adds to a
+ * `BasicFloodFillCell` of the same distance type.
+ */
+template <typename D>
+struct KnownDistanceCell {
+    /**
+     * The number of cells from the starting cell over edges known to be
+     * open.
+     */
+    mutable D known_distance{ 0 };
+};
+
+/**
+ * The cell memory of a `FloodFillMouse` that can use every exploration mode.
+ */
+struct FloodFillCell : BasicFloodFillCell<int, int>, KnownDistanceCell<int> {};
+
+/**
+ * The narrowest unsigned type that holds the number of cells of an `S` by `S`
+ * maze, or 16 bits for runtime-sized mazes.
+ */
+template <int S>
+using CompactDistance = std::conditional_t<
+    S != DYNAMIC_SIZE && S * S <= UINT8_MAX, std::uint8_t, std::uint16_t>;
+
+/**
+ * A `FloodFillCell` for small memories: an 8-bit saturating visit counter and
+ * a distance of 8 or 16 bits. It keeps no `known_distance`, so a mouse of it
+ * cannot use `ExplorationMode::FloodFillUntilOptimal`.
+ */
+template <int S>
+using CompactFloodFillCell =
+    BasicFloodFillCell<std::uint8_t, CompactDistance<S>>;
+
+/**
+ * @brief How a `FloodFillMouse` chooses the next cell while exploring.
+ */
+enum class ExplorationMode : int {
+    // Move to the reachable neighbour visited the fewest times
+    LeastVisited,
+
+    // Move to the reachable neighbour closest to the finish
+    FloodFill,
+
+    // Flood fill, then keep exploring between the finish and the start until
+    // the best known route is provably the shortest one
+    FloodFillUntilOptimal
+};
+
+template <typename C>
+concept DerivedFromFloodFillCell = std::is_base_of_v<
+    BasicFloodFillCell<typename C::VisitCount, typename C::Distance>, C>;
+
 template <typename C>
-concept DerivedFromFloodFillCell = std::is_base_of_v<FloodFillCell, C>;
+concept HasKnownDistance =
+    std::is_base_of_v<KnownDistanceCell<typename C::Distance>, C>;
+
+template <
+    int S, DerivedFromFloodFillCell C, DerivedFromEdge E,
+    typename Hw = MouseHardwareInterface>
+struct FloodFillMouse : Mouse<S, C, E, Hw> {
+    /**
+     * A sequence of absolute directions, 2 bits each. It holds a path without
+     * repeated cells, so it never needs more entries than the maze has cells.
+     */
+    using Path = PackedDirs<S == DYNAMIC_SIZE ? DYNAMIC_SIZE : S * S>;
+
+    using Distance = typename C::Distance;
+
+    FloodFillMouse(
+        const Vector2 startingPosition, const Dir4 startingOrientation)
+        requires(S != DYNAMIC_SIZE)
+        : FloodFillMouse(startingPosition, startingOrientation, {}) {}
 
-template <int S, DerivedFromFloodFillCell C, DerivedFromEdge E>
-struct FloodFillMouse : Mouse<S, C, E> {
     FloodFillMouse(
-        const Vector2 startingPosition, const Dir4 startingOrientation) :
-        Mouse<S, C, E>(startingPosition, startingOrientation){};
+        const Vector2 startingPosition, const Dir4 startingOrientation,
+        Maze<S, C, E> maze) :
+        Mouse<S, C, E, Hw>(
+            startingPosition, startingOrientation, std::move(maze)),
+        stack(this->maze.numCells()), route(this->maze.numCells()),
+        walls(WallBitboard<S>::unknown(this->maze)),
+        flood_queue(floodQueueCapacity(this->maze.numCells())),
+        raised_cells(this->maze.numCells() / REFLOOD_FRACTION),
+        queued(this->maze.numCells()),
+        bit_flood(this->maze), finish_cells(this->maze.numCells()),
+        starting_cell(this->maze.numCells()),
+        path_cells(this->maze.numCells()) {
+        checkDistanceRange();
+        initTargetCells();
+        floodDistances();
+        resetKnownDistances();
+    }
+
+    /**
+     * The exploration strategy. It should be chosen before the mouse starts
+     * exploring, because the distances are not kept up to date in
+     * `ExplorationMode::LeastVisited`. `ExplorationMode::FloodFillUntilOptimal`
+     * needs a cell type with `HasKnownDistance`; otherwise exploring throws
+     * `std::invalid_argument`.
+     */
+    ExplorationMode exploration_mode{ ExplorationMode::LeastVisited };
 
     void nextExploringCycle() override;
 
+    /**
+     * @brief Retraces the exploration route towards the finish, one cell per
+     * cycle.
+     */
+    void nextRushingCycle() override;
+
+    void resetRushingState() override;
+
     void moveForward(int length) override;
 
  protected:
@@ -28,6 +186,135 @@ struct FloodFillMouse : Mouse<S, C, E> {
 
     void exploreNext();
 
+    /**
+     * @brief Moves to the reachable neighbour with the smallest distance to
+     * the target cells, preferring to go straight on ties.
+     */
+    void exploreByDistance();
+
+    /**
+     * @brief Runs one exploring cycle of
+     * `ExplorationMode::FloodFillUntilOptimal`.
+     *
+     * The mouse floods towards the finish, then back towards the start, and
+     * so on, each trip passing through the cells that could still shorten
+     * the route. As soon as the optimistic cost (unknown edges open) of the
+     * route equals its pessimistic cost (unknown edges blocked), no
+     * unexplored cell can improve it, and the mouse returns to the start.
+     *
+     * @throws std::invalid_argument if the cells keep no `known_distance`.
+     */
+    void exploreUntilOptimal();
+
+    /**
+     * @brief Checks if the shortest route over the known open edges is as
+     * short as the shortest route assuming all unknown edges are open.
+     */
+    [[nodiscard]] bool isKnownRouteOptimal() const;
+
+    /**
+     * @brief Ends the exploration: sets `route` to the best known route and
+     * `stack` to the best known path back to the start.
+     */
+    void finishExploring();
+
+    /**
+     * @brief Writes the directions of the shortest known path from the
+     * starting cell to a cell, following decreasing `known_distance`.
+     */
+    void knownPathTo(int index, Path& path) const;
+
+    /**
+     * @brief Sets `known_distance` to unreachable for every cell except the
+     * starting cell, if the cells keep it.
+     */
+    void resetKnownDistances();
+
+    /**
+     * @brief Lowers `known_distance` after the edge of a cell was found open.
+     *
+     * The update is a breadth-first search from the edge in `flood_queue`;
+     * if it outgrows the queue, the distances are recomputed in full.
+     */
+    void lowerKnownDistances(int index, Dir4 absolute_dir);
+
+    /**
+     * @brief Records the move towards an absolute direction in the route
+     * stack, then turns and moves one cell.
+     *
+     * Moving into a cell already on the stack drops the loop back to it, so
+     * the stack always holds a path without repeated cells from the start.
+     */
+    void advance(Dir4 next_absolute_dir);
+
+    /**
+     * @brief Records a wall discovered on the edge of a cell.
+     *
+     * In `ExplorationMode::FloodFill`, both cells next to the edge are queued
+     * for `repropagateDistances()`.
+     */
+    void markWall(int index, Dir4 absolute_dir);
+
+    /**
+     * @brief Computes the distance of every cell with a bit-parallel
+     * breadth-first search from the target cells, assuming that every unknown
+     * edge is open.
+     */
+    void floodDistances();
+
+    /**
+     * @brief Repairs the distances after walls were discovered next to the
+     * queued cells.
+     *
+     * New walls can only increase distances, and only of the cells whose
+     * shortest paths all went through them. First, every queued cell left
+     * without an open neighbour one step closer to the finish is raised to
+     * unreachable, and the neighbours that may have depended on it are queued
+     * in turn. Then each raised cell is seeded from its remaining neighbours
+     * and the new distances are spread among the raised cells. The work is
+     * proportional to the affected region; once that exceeds a
+     * `REFLOOD_FRACTION` of the maze, which is also when it outgrows the
+     * queues, `floodDistances()` is run instead. Every cell is queued at most
+     * once at a time.
+     */
+    void repropagateDistances();
+
+    /**
+     * @brief Abandons a repair: empties the queues and recomputes all
+     * distances.
+     */
+    void refloodDistances();
+
+    [[nodiscard]] bool isFinishCell(const Vector2& coord) const;
+
+    /**
+     * @brief Returns the indices of the four finishing cells.
+     */
+    [[nodiscard]] std::array<int, 4> finishCellIndices() const;
+
+    /**
+     * @brief Sets the bits of the finishing and starting cells in
+     * `finish_cells` and `starting_cell`, and starts `path_cells` with the
+     * starting cell.
+     */
+    void initTargetCells();
+
+    /**
+     * @brief Checks that `Distance` holds the number of cells, which marks
+     * unreachable cells.
+     *
+     * @throws std::invalid_argument if the maze has too many cells.
+     */
+    void checkDistanceRange() const;
+
+    /**
+     * @brief Checks if the exploration modes in use keep `distance` up to
+     * date.
+     */
+    [[nodiscard]] bool usesDistances() const {
+        return exploration_mode != ExplorationMode::LeastVisited;
+    }
+
     bool hasArrivedAtFinish();
 
     bool hasArrivedAtStarting();
@@ -38,19 +325,101 @@ struct FloodFillMouse : Mouse<S, C, E> {
 
     C& getCellOn(Dir4 absolute_dir);
 
-    std::vector<Dir4> stack{};
+    /**
+     * The absolute directions leading from the starting cell to the current
+     * cell while exploring.
+     */
+    Path stack;
+
+    /**
+     * The absolute directions leading from the starting cell to the finish,
+     * recorded when the mouse first arrives at the finish.
+     */
+    Path route;
+
+    /**
+     * The index of the next direction in `route` to rush along.
+     */
+    int rush_step{ 0 };
+
+    /**
+     * @brief The known walls, bit-packed.
+     *
+     * Updated by `updateWallMemory()` so that the exploration and rush
+     * planners can look up walls with a shift-and-mask. The edges of `maze`
+     * are kept as well unless `E` is `NoEdge`. The rush planners
+     * use its pessimistic view (`isOpen()`), and the distances its
+     * optimistic view (`mayBeOpen()`).
+     */
+    WallBitboard<S> walls;
+
+    /**
+     * The cells waiting for `repropagateDistances()` or
+     * `lowerKnownDistances()`.
+     */
+    RingQueue<
+        Distance, S == DYNAMIC_SIZE ? DYNAMIC_SIZE : floodQueueCapacity(S * S)>
+        flood_queue;
+
+    /**
+     * The cells raised to unreachable by `repropagateDistances()`.
+     */
+    RingQueue<
+        Distance, S == DYNAMIC_SIZE ? DYNAMIC_SIZE : S * S / REFLOOD_FRACTION>
+        raised_cells;
+
+    /**
+     * Bit `i` is set while cell `i` is in `flood_queue`.
+     */
+    typename WallBitboard<S>::Plane queued;
+
+    /**
+     * True while the distances lead to the starting cell instead of the
+     * finishing cells.
+     */
+    bool flooding_to_start{ false };
+
+    /**
+     * Computes whole distance maps over `walls`.
+     */
+    BitFlood<S> bit_flood;
+
+    /**
+     * Bit `i` is set if cell `i` is a finishing cell.
+     */
+    typename WallBitboard<S>::Plane finish_cells;
+
+    /**
+     * Only the bit of the starting cell is set.
+     */
+    typename WallBitboard<S>::Plane starting_cell;
+
+    /**
+     * Bit `i` is set if cell `i` is on the path recorded in `stack`.
+     */
+    typename WallBitboard<S>::Plane path_cells;
 };
 
-template <int S, DerivedFromFloodFillCell C, DerivedFromEdge E>
-void FloodFillMouse<S, C, E>::nextExploringCycle() {
+template <int S, DerivedFromFloodFillCell C, DerivedFromEdge E, typename Hw>
+void FloodFillMouse<S, C, E, Hw>::nextExploringCycle() {
     if (this->state == MouseState::Exploring) {
+        if (exploration_mode == ExplorationMode::FloodFillUntilOptimal) {
+            exploreUntilOptimal();
+            return;
+        }
+
         if (hasArrivedAtFinish()) {
             this->state = MouseState::ReturningToStart;
+            route = stack;
             return;
         }
 
         updateWallMemory();
-        exploreNext();
+        if (exploration_mode == ExplorationMode::FloodFill) {
+            exploreByDistance();
+        } else {
+            exploreNext();
+        }
     } else if (this->state == MouseState::ReturningToStart) {
         if (hasArrivedAtStarting()) {
             this->state = MouseState::RushingToFinish;
@@ -61,41 +430,84 @@ void FloodFillMouse<S, C, E>::nextExploringCycle() {
     }
 }
 
-template <int S, DerivedFromFloodFillCell C, DerivedFromEdge E>
-void FloodFillMouse<S, C, E>::moveForward(int length) {
-    Mouse<S, C, E>::moveForward(length);
+template <int S, DerivedFromFloodFillCell C, DerivedFromEdge E, typename Hw>
+void FloodFillMouse<S, C, E, Hw>::nextRushingCycle() {
+    if (hasArrivedAtFinish() || rush_step >= static_cast<int>(route.size())) {
+        this->state = MouseState::Stopped;
+        return;
+    }
 
-    if (this->state == MouseState::Exploring) {
-        ++this->maze.cell(this->position).num_visited;
+    this->derived().turn(route[rush_step++]);
+    this->derived().moveForward(1);
+}
+
+template <int S, DerivedFromFloodFillCell C, DerivedFromEdge E, typename Hw>
+void FloodFillMouse<S, C, E, Hw>::resetRushingState() {
+    Mouse<S, C, E, Hw>::resetRushingState();
+    rush_step = 0;
+}
+
+template <int S, DerivedFromFloodFillCell C, DerivedFromEdge E, typename Hw>
+void FloodFillMouse<S, C, E, Hw>::moveForward(int length) {
+    Mouse<S, C, E, Hw>::moveForward(length);
+
+    // The counter saturates, so a narrow one keeps the most visited cells
+    // last in line instead of wrapping around to the front
+    auto& num_visited = this->maze.cell(this->position).num_visited;
+    if (this->state == MouseState::Exploring &&
+        num_visited < std::numeric_limits<typename C::VisitCount>::max()) {
+        ++num_visited;
     }
 }
 
-template <int S, DerivedFromFloodFillCell C, DerivedFromEdge E>
-void FloodFillMouse<S, C, E>::updateWallMemory() {
+template <int S, DerivedFromFloodFillCell C, DerivedFromEdge E, typename Hw>
+void FloodFillMouse<S, C, E, Hw>::updateWallMemory() {
     if (this->state != MouseState::Exploring) {
         return;
     }
 
+    const auto index = this->maze.cellIndex(this->position);
     const auto updateWallMemory = [&](Dir4 dir) {
         const auto absolute_dir = this->getAbsoluteDir(dir);
-        if (!this->maze.withinBounds(this->position, absolute_dir)) {
+        if (this->maze.neighbourIndex(index, absolute_dir) == NO_NEIGHBOUR) {
             return;
         }
 
-        if (this->checkWall(dir)) {
+        if (this->derived().checkWall(dir)) {
+            markWall(index, absolute_dir);
             return;
         }
 
-        this->maze.edge(this->position, absolute_dir).hasWall = false;
+        if constexpr (!std::is_same_v<E, NoEdge>) {
+            auto& edge = this->maze.edgeAt(index, absolute_dir);
+            edge.hasWall = false;
+            edge.isKnown = true;
+        }
+        walls.setOpenAt(index, absolute_dir, true);
     };
 
     updateWallMemory(Dir4::Up);
     updateWallMemory(Dir4::Right);
     updateWallMemory(Dir4::Left);
+
+    if (usesDistances()) {
+        repropagateDistances();
+    }
+
+    // Both searches share `flood_queue`, so the walls are repaired first
+    if constexpr (HasKnownDistance<C>) {
+        if (exploration_mode == ExplorationMode::FloodFillUntilOptimal) {
+            for (int d = 0; d < 4; ++d) {
+                if (walls.isOpen(index, static_cast<Dir4>(d))) {
+                    lowerKnownDistances(index, static_cast<Dir4>(d));
+                }
+            }
+        }
+    }
 }
 
-template <int S, DerivedFromFloodFillCell C, DerivedFromEdge E>
-void FloodFillMouse<S, C, E>::exploreNext() {
+template <int S, DerivedFromFloodFillCell C, DerivedFromEdge E, typename Hw>
+void FloodFillMouse<S, C, E, Hw>::exploreNext() {
     // Four absolute directions
     Dir4 dirs[4] = { this->orientation };
     for (int i = 1; i < 4; i++) {
@@ -110,7 +522,9 @@ void FloodFillMouse<S, C, E>::exploreNext() {
 
     int num_visited[4] = {};
     for (int i = 0; i < 4; i++) {
-        num_visited[i] = moveable[i] ? getCellOn(dirs[i]).num_visited : INT_MAX;
+        num_visited[i] =
+            moveable[i] ? static_cast<int>(getCellOn(dirs[i]).num_visited)
+                        : INT_MAX;
     }
 
     auto next_absolute_dir = dirs[0];
@@ -122,56 +536,403 @@ void FloodFillMouse<S, C, E>::exploreNext() {
         }
     }
 
-    // Handling stack
-    if (!stack.empty()) {
-        const auto previous_dir = stack.back();
-        if (previous_dir - next_absolute_dir == Dir4::Down) {
+    advance(next_absolute_dir);
+}
+
+template <int S, DerivedFromFloodFillCell C, DerivedFromEdge E, typename Hw>
+void FloodFillMouse<S, C, E, Hw>::exploreByDistance() {
+    const auto index = this->maze.cellIndex(this->position);
+
+    auto next_absolute_dir = this->orientation;
+    int min_distance = INT_MAX;
+    auto dir = this->orientation;
+    for (int i = 0; i < 4; i++, dir = dir + Dir4::Right) {
+        if (!walls.isOpen(index, dir)) {
+            continue;
+        }
+
+        const int distance =
+            this->maze.cellAt(this->maze.neighbourIndex(index, dir)).distance;
+        if (distance < min_distance) {
+            next_absolute_dir = dir;
+            min_distance = distance;
+        }
+    }
+
+    advance(next_absolute_dir);
+}
+
+template <int S, DerivedFromFloodFillCell C, DerivedFromEdge E, typename Hw>
+void FloodFillMouse<S, C, E, Hw>::advance(const Dir4 next_absolute_dir) {
+    const auto index = this->maze.cellIndex(this->position);
+    const auto next_index = this->maze.neighbourIndex(index, next_absolute_dir);
+    if (next_index != NO_NEIGHBOUR && path_cells.test(next_index)) {
+        // Unwind the stack back to the cell, which usually is the previous one
+        for (int cell = index; cell != next_index;) {
+            path_cells.reset(cell);
+            cell = this->maze.neighbourIndex(cell, stack.back() + Dir4::Down);
             stack.pop_back();
-        } else {
-            stack.push_back(next_absolute_dir);
         }
     } else {
+        // A move off the maze is recorded as well; the mouse crashes on it
+        if (next_index != NO_NEIGHBOUR) {
+            path_cells.set(next_index);
+        }
         stack.push_back(next_absolute_dir);
     }
 
-    this->turn(next_absolute_dir);
-    this->moveForward(1);
+    this->derived().turn(next_absolute_dir);
+    this->derived().moveForward(1);
 }
 
-template <int S, DerivedFromFloodFillCell C, DerivedFromEdge E>
-bool FloodFillMouse<S, C, E>::hasArrivedAtFinish() {
-    const int a = S / 2, b = a - 1;
+template <int S, DerivedFromFloodFillCell C, DerivedFromEdge E, typename Hw>
+void FloodFillMouse<S, C, E, Hw>::markWall(
+    const int index, const Dir4 absolute_dir) {
+    if (walls.isKnown(index, absolute_dir)) {
+        return;
+    }
+    walls.setOpenAt(index, absolute_dir, false);
+    if constexpr (!std::is_same_v<E, NoEdge>) {
+        this->maze.edgeAt(index, absolute_dir).isKnown = true;
+    }
+
+    if (!usesDistances()) {
+        return;
+    }
+
+    // The queue is emptied every cycle and has room for `MAX_MARKED_CELLS`
+    for (const int cell :
+         { index, this->maze.neighbourIndex(index, absolute_dir) }) {
+        if (!queued.test(cell)) {
+            queued.set(cell);
+            flood_queue.push(cell);
+        }
+    }
+}
+
+template <int S, DerivedFromFloodFillCell C, DerivedFromEdge E, typename Hw>
+void FloodFillMouse<S, C, E, Hw>::floodDistances() {
+    bit_flood.distances(
+        walls, WallView::Optimistic,
+        flooding_to_start ? starting_cell : finish_cells,
+        [&](const int i) -> Distance& {
+            return this->maze.cellAt(i).distance;
+        });
+}
+
+template <int S, DerivedFromFloodFillCell C, DerivedFromEdge E, typename Hw>
+void FloodFillMouse<S, C, E, Hw>::repropagateDistances() {
+    const int unreachable = this->maze.numCells();
+    const auto distanceOf = [&](const int i) -> Distance& {
+        return this->maze.cellAt(i).distance;
+    };
+    // Returns false if the queue is full
+    const auto pushOnce = [&](const int i) {
+        if (queued.test(i)) {
+            return true;
+        }
+        if (flood_queue.size() == flood_queue.capacity()) {
+            return false;
+        }
+        queued.set(i);
+        flood_queue.push(i);
+        return true;
+    };
+
+    // Raise the cells that lost their last neighbour one step closer
+    while (!flood_queue.empty()) {
+        const auto cell = flood_queue.pop();
+        queued.reset(cell);
+
+        const int distance = distanceOf(cell);
+        if (distance == 0 || distance == unreachable) {
+            continue;
+        }
+
+        const auto open_mask = walls.mayBeOpenMask(cell);
+        bool supported = false;
+        for (int d = 0; d < 4 && !supported; ++d) {
+            supported = (open_mask >> d & 1) &&
+                        distanceOf(this->maze.neighbourIndex(
+                            cell, static_cast<Dir4>(d))) == distance - 1;
+        }
+        if (supported) {
+            continue;
+        }
+
+        // A full search is cheaper once a large part of the maze is raised
+        if (raised_cells.size() == raised_cells.capacity()) {
+            refloodDistances();
+            return;
+        }
+
+        distanceOf(cell) = unreachable;
+        raised_cells.push(cell);
+        for (int d = 0; d < 4; ++d) {
+            if (open_mask >> d & 1) {
+                const int next =
+                    this->maze.neighbourIndex(cell, static_cast<Dir4>(d));
+                if (distanceOf(next) == distance + 1 && !pushOnce(next)) {
+                    refloodDistances();
+                    return;
+                }
+            }
+        }
+    }
+
+    // Seed the raised cells from their neighbours that kept their distance
+    while (!raised_cells.empty()) {
+        const auto cell = raised_cells.pop();
+        const auto open_mask = walls.mayBeOpenMask(cell);
+        for (int d = 0; d < 4; ++d) {
+            if (open_mask >> d & 1) {
+                const int next =
+                    this->maze.neighbourIndex(cell, static_cast<Dir4>(d));
+                distanceOf(cell) =
+                    std::min<int>(distanceOf(cell), distanceOf(next) + 1);
+            }
+        }
+        if (distanceOf(cell) < unreachable && !pushOnce(cell)) {
+            refloodDistances();
+            return;
+        }
+    }
+
+    // Spread the new distances, which only lowers raised cells
+    while (!flood_queue.empty()) {
+        const auto cell = flood_queue.pop();
+        queued.reset(cell);
+
+        const auto next_distance = distanceOf(cell) + 1;
+        const auto open_mask = walls.mayBeOpenMask(cell);
+        for (int d = 0; d < 4; ++d) {
+            if (open_mask >> d & 1) {
+                const int next =
+                    this->maze.neighbourIndex(cell, static_cast<Dir4>(d));
+                if (distanceOf(next) > next_distance) {
+                    distanceOf(next) = next_distance;
+                    if (!pushOnce(next)) {
+                        refloodDistances();
+                        return;
+                    }
+                }
+            }
+        }
+    }
+}
+
+template <int S, DerivedFromFloodFillCell C, DerivedFromEdge E, typename Hw>
+void FloodFillMouse<S, C, E, Hw>::refloodDistances() {
+    while (!flood_queue.empty()) {
+        queued.reset(flood_queue.pop());
+    }
+    raised_cells.clear();
+    floodDistances();
+}
+
+template <int S, DerivedFromFloodFillCell C, DerivedFromEdge E, typename Hw>
+void FloodFillMouse<S, C, E, Hw>::exploreUntilOptimal() {
+    if constexpr (!HasKnownDistance<C>) {
+        throw std::invalid_argument(
+            "FloodFillMouse::exploreUntilOptimal(): the cells keep no "
+            "known_distance");
+    } else {
+        updateWallMemory();
+        if (isKnownRouteOptimal()) {
+            finishExploring();
+            return;
+        }
+
+        // Turn around at either end of the trip
+        const auto arrived = flooding_to_start ? hasArrivedAtStarting()
+                                               : hasArrivedAtFinish();
+        if (arrived) {
+            flooding_to_start = !flooding_to_start;
+            floodDistances();
+        }
+
+        exploreByDistance();
+    }
+}
+
+template <int S, DerivedFromFloodFillCell C, DerivedFromEdge E, typename Hw>
+bool FloodFillMouse<S, C, E, Hw>::isKnownRouteOptimal() const {
+    int pessimistic = INT_MAX, optimistic = INT_MAX;
+    for (const auto index : finishCellIndices()) {
+        const auto& cell = this->maze.cellAt(index);
+        pessimistic = std::min<int>(pessimistic, cell.known_distance);
+        optimistic = std::min<int>(optimistic, cell.distance);
+    }
+    if (!flooding_to_start) {
+        optimistic =
+            this->maze.cellAt(this->maze.cellIndex(this->startingPosition))
+                .distance;
+    }
+
+    return pessimistic < this->maze.numCells() && pessimistic == optimistic;
+}
+
+template <int S, DerivedFromFloodFillCell C, DerivedFromEdge E, typename Hw>
+void FloodFillMouse<S, C, E, Hw>::finishExploring() {
+    auto best_finish = finishCellIndices()[0];
+    for (const auto index : finishCellIndices()) {
+        if (this->maze.cellAt(index).known_distance <
+            this->maze.cellAt(best_finish).known_distance) {
+            best_finish = index;
+        }
+    }
+
+    knownPathTo(best_finish, route);
+    knownPathTo(this->maze.cellIndex(this->position), stack);
+    this->state = MouseState::ReturningToStart;
+}
+
+template <int S, DerivedFromFloodFillCell C, DerivedFromEdge E, typename Hw>
+void FloodFillMouse<S, C, E, Hw>::knownPathTo(int index, Path& path) const {
+    path.resize(this->maze.cellAt(index).known_distance);
+    for (int i = path.size() - 1; i >= 0; --i) {
+        const auto distance = this->maze.cellAt(index).known_distance;
+        for (int d = 0; d < 4; ++d) {
+            const auto dir = static_cast<Dir4>(d);
+            if (!walls.isOpen(index, dir)) {
+                continue;
+            }
+
+            const int neighbour_index = this->maze.neighbourIndex(index, dir);
+            if (this->maze.cellAt(neighbour_index).known_distance ==
+                distance - 1) {
+                path.set(i, dir + Dir4::Down);
+                index = neighbour_index;
+                break;
+            }
+        }
+    }
+}
+
+template <int S, DerivedFromFloodFillCell C, DerivedFromEdge E, typename Hw>
+void FloodFillMouse<S, C, E, Hw>::resetKnownDistances() {
+    if constexpr (HasKnownDistance<C>) {
+        for (int i = 0; i < this->maze.numCells(); ++i) {
+            this->maze.cellAt(i).known_distance = this->maze.numCells();
+        }
+        this->maze.cellAt(this->maze.cellIndex(this->startingPosition))
+            .known_distance = 0;
+    }
+}
+
+template <int S, DerivedFromFloodFillCell C, DerivedFromEdge E, typename Hw>
+void FloodFillMouse<S, C, E, Hw>::lowerKnownDistances(
+    const int index, const Dir4 absolute_dir) {
+    const auto distanceOf = [&](const int i) -> Distance& {
+        return this->maze.cellAt(i).known_distance;
+    };
+
+    // Opening an edge can only shorten paths, so a plain BFS from the closer
+    // end suffices
+    const int neighbour_index = this->maze.neighbourIndex(index, absolute_dir);
+    for (const auto& [from, to] :
+         { std::pair{ index, neighbour_index },
+           std::pair{ neighbour_index, index } }) {
+        if (distanceOf(from) + 1 < distanceOf(to)) {
+            distanceOf(to) = distanceOf(from) + 1;
+            flood_queue.push(to);
+        }
+    }
+
+    while (!flood_queue.empty()) {
+        const auto cell = flood_queue.pop();
+        const auto next_distance = distanceOf(cell) + 1;
+        const auto open_mask = walls.openMask(cell);
+        for (int d = 0; d < 4; ++d) {
+            if (!(open_mask >> d & 1)) {
+                continue;
+            }
+
+            const int next =
+                this->maze.neighbourIndex(cell, static_cast<Dir4>(d));
+            if (distanceOf(next) > next_distance) {
+                if (flood_queue.size() == flood_queue.capacity()) {
+                    // A large region was connected; search it all at once
+                    flood_queue.clear();
+                    bit_flood.distances(
+                        walls, WallView::Pessimistic, starting_cell,
+                        distanceOf);
+                    return;
+                }
+                distanceOf(next) = next_distance;
+                flood_queue.push(next);
+            }
+        }
+    }
+}
+
+template <int S, DerivedFromFloodFillCell C, DerivedFromEdge E, typename Hw>
+bool FloodFillMouse<S, C, E, Hw>::isFinishCell(const Vector2& coord) const {
+    const int ax = this->maze.width() / 2, bx = ax - 1;
+    const int ay = this->maze.height() / 2, by = ay - 1;
+
+    return (coord.x == ax || coord.x == bx) && (coord.y == ay || coord.y == by);
+}
+
+template <int S, DerivedFromFloodFillCell C, DerivedFromEdge E, typename Hw>
+std::array<int, 4> FloodFillMouse<S, C, E, Hw>::finishCellIndices() const {
+    const int ax = this->maze.width() / 2, ay = this->maze.height() / 2;
+
+    return { this->maze.cellIndex({ ax - 1, ay - 1 }),
+             this->maze.cellIndex({ ax, ay - 1 }),
+             this->maze.cellIndex({ ax - 1, ay }),
+             this->maze.cellIndex({ ax, ay }) };
+}
+
+template <int S, DerivedFromFloodFillCell C, DerivedFromEdge E, typename Hw>
+void FloodFillMouse<S, C, E, Hw>::initTargetCells() {
+    for (const auto index : finishCellIndices()) {
+        finish_cells.set(index);
+    }
+    starting_cell.set(this->maze.cellIndex(this->startingPosition));
+    path_cells.set(this->maze.cellIndex(this->startingPosition));
+}
+
+template <int S, DerivedFromFloodFillCell C, DerivedFromEdge E, typename Hw>
+void FloodFillMouse<S, C, E, Hw>::checkDistanceRange() const {
+    if (this->maze.numCells() > std::numeric_limits<Distance>::max()) {
+        throw std::invalid_argument(
+            "FloodFillMouse(): the maze has more cells than the distance "
+            "type can count");
+    }
+}
 
-    return (this->position.x == a || this->position.x == b) &&
-           (this->position.y == a || this->position.y == b);
+template <int S, DerivedFromFloodFillCell C, DerivedFromEdge E, typename Hw>
+bool FloodFillMouse<S, C, E, Hw>::hasArrivedAtFinish() {
+    return isFinishCell(this->position);
 }
 
-template <int S, DerivedFromFloodFillCell C, DerivedFromEdge E>
-bool FloodFillMouse<S, C, E>::hasArrivedAtStarting() {
-    return this->position.x == 0 && this->position.y == S - 1;
+template <int S, DerivedFromFloodFillCell C, DerivedFromEdge E, typename Hw>
+bool FloodFillMouse<S, C, E, Hw>::hasArrivedAtStarting() {
+    return this->position == this->startingPosition;
 }
 
-template <int S, DerivedFromFloodFillCell C, DerivedFromEdge E>
-void FloodFillMouse<S, C, E>::returnAlongOriginalRoute() {
+template <int S, DerivedFromFloodFillCell C, DerivedFromEdge E, typename Hw>
+void FloodFillMouse<S, C, E, Hw>::returnAlongOriginalRoute() {
     if (stack.empty()) {
         return;
     }
 
     const auto opposite_absolute_dir = stack.back();
     stack.pop_back();
-    this->turn(opposite_absolute_dir + Dir4::Down);
-    moveForward(1);
+    this->derived().turn(opposite_absolute_dir + Dir4::Down);
+    this->derived().moveForward(1);
 }
 
-template <int S, DerivedFromFloodFillCell C, DerivedFromEdge E>
-bool FloodFillMouse<S, C, E>::canMove(const Dir4 absolute_dir) {
-    return this->maze.withinBounds(this->position, absolute_dir) &&
-           !this->maze.edge(this->position, absolute_dir).hasWall;
+template <int S, DerivedFromFloodFillCell C, DerivedFromEdge E, typename Hw>
+bool FloodFillMouse<S, C, E, Hw>::canMove(const Dir4 absolute_dir) {
+    return walls.isOpen(this->maze.cellIndex(this->position), absolute_dir);
 }
 
-template <int S, DerivedFromFloodFillCell C, DerivedFromEdge E>
-C& FloodFillMouse<S, C, E>::getCellOn(const Dir4 absolute_dir) {
-    return this->maze.cell(this->position + get_vector(absolute_dir));
+template <int S, DerivedFromFloodFillCell C, DerivedFromEdge E, typename Hw>
+C& FloodFillMouse<S, C, E, Hw>::getCellOn(const Dir4 absolute_dir) {
+    const auto index = this->maze.cellIndex(this->position);
+    return this->maze.cellAt(this->maze.neighbourIndex(index, absolute_dir));
 }
 
 }  // namespace Mazemouse
@@ -0,0 +1,395 @@
+#ifndef MOTION_PRIMITIVE_HPP
+#define MOTION_PRIMITIVE_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <numbers>
+#include "../Maze/Dir4.hpp"
+#include "MotionProfile.hpp"
+
+namespace Mazemouse {
+
+/**
+ * @brief The kinds of movements a rush is compiled into.
+ *
+ * Paths run between the midpoints of the edges the mouse crosses: through a
+ * cell it goes straight across, or turns into a neighbouring edge, and it
+ * starts and ends at the centre of a cell.
+ */
+enum class MotionKind : std::uint8_t {
+    // A straight run along the heading, one cell per crossed cell and half a
+    // cell from or to the centre of the first or last cell
+    Straight,
+
+    // A turn in place, at rest
+    InPlaceTurn,
+
+    // A 90-degree arc of half a cell radius through one cell
+    SmoothTurn,
+
+    // A 45-degree turn, a diagonal run cutting the corners of a zigzag of
+    // cells, and a 45-degree turn back
+    Diagonal
+};
+
+/**
+ * @brief One movement of a compiled rush, with its velocity profile.
+ *
+ * The cells the movement enters are given by absolute directions, which
+ * alternate between `dir` and `alternateDir` along a diagonal and are all
+ * `dir` otherwise. The speed rises from `entrySpeed` to `peakSpeed` and falls
+ * to `exitSpeed` (a trapezoid), and stays constant through a smooth turn.
+ * Lengths are in cells, speeds in cells per second and times in seconds; the
+ * kinematics use `float` to keep a whole plan small.
+ */
+struct MotionPrimitive {
+    MotionKind kind{ MotionKind::Straight };
+
+    /**
+     * The absolute direction of the first cell entered, or the heading of a
+     * straight run that enters none.
+     */
+    Dir4 dir{ Dir4::Up };
+
+    /**
+     * The absolute direction of every second cell entered.
+     */
+    Dir4 alternateDir{ Dir4::Up };
+
+    /**
+     * The relative direction turned towards: the turn of an in-place or smooth
+     * turn, or the first 45-degree turn of a diagonal. `Dir4::Up` for
+     * straight runs.
+     */
+    Dir4 turn{ Dir4::Up };
+
+    /**
+     * The number of cells entered.
+     */
+    int cells{ 0 };
+
+    /**
+     * The length of the path travelled, in cells.
+     */
+    float length{ 0 };
+
+    float entrySpeed{ 0 };
+
+    float peakSpeed{ 0 };
+
+    float exitSpeed{ 0 };
+
+    float duration{ 0 };
+
+    /**
+     * @brief Returns the absolute direction of the `i`-th cell entered.
+     */
+    [[nodiscard]] constexpr Dir4 cellDir(const int i) const {
+        return i % 2 == 0 ? dir : alternateDir;
+    }
+
+    /**
+     * @brief Returns the number of heading changes: two for a diagonal, one
+     * for any other turn.
+     */
+    [[nodiscard]] constexpr int numTurns() const {
+        switch (kind) {
+            case MotionKind::Straight:
+                return 0;
+            case MotionKind::InPlaceTurn:
+            case MotionKind::SmoothTurn:
+                return 1;
+            case MotionKind::Diagonal:
+                return 2;
+        }
+        return 0;
+    }
+};
+
+/**
+ * @brief Compiles a route into motion primitives with trapezoidal velocity
+ * profiles, one primitive at a time.
+ *
+ * Equal directions merge into straight runs. A single change of direction
+ * between straight runs becomes a smooth turn. Two or more changes that
+ * alternate between right and left form a zigzag, which the mouse cuts with
+ * one diagonal run of `sqrt(2) / 2` cells per turning cell. The mouse starts
+ * and stops at rest, and turns in place only if the route starts away from
+ * its orientation or reverses. Turns are taken at no more than
+ * `smoothTurnSpeed`; the speed between primitives is then lowered, forwards
+ * and backwards, to what the acceleration can reach over every run.
+ *
+ * Only the position in the route and the speed reached so far are kept, so
+ * a rush is run without storing its plan. The limit that later primitives
+ * put on the speed is found by reading the route ahead until the
+ * acceleration could not lower it any further, which is rarely more than one
+ * primitive ahead.
+ */
+class MotionCompiler {
+ public:
+    /**
+     * @brief Starts a new route.
+     *
+     * @param orientation The orientation of the mouse before the route.
+     * @param profile The limits the durations are computed with.
+     * @throws std::invalid_argument if the profile is not valid; see
+     * `MotionProfile::validate()`.
+     */
+    void start(const Dir4 orientation, const MotionProfile& profile) {
+        profile.validate();
+        cursor_ = { 0, orientation, false };
+        profile_ = profile;
+        speed_ = forward_speed_ = 0;
+    }
+
+    /**
+     * @brief Compiles the next primitive of the route.
+     *
+     * @param route The absolute directions of the cells to enter, without
+     * repeated cells; it needs `size()` and `operator[]`, and must not change
+     * until the route is done.
+     * @return False once the whole route has been compiled.
+     */
+    template <typename Path>
+    bool next(const Path& route, MotionPrimitive& primitive);
+
+ private:
+    /**
+     * @brief Where the next primitive starts.
+     */
+    struct Cursor {
+        /**
+         * The next transition: transition `i` runs through the cell entered
+         * by move `i - 1` and ends by entering the cell of move `i`.
+         */
+        int step;
+
+        Dir4 orientation;
+
+        /**
+         * False if the mouse is at rest in the centre of a cell.
+         */
+        bool moving;
+    };
+
+    Cursor cursor_{ 0, Dir4::Up, false };
+
+    MotionProfile profile_{};
+
+    /**
+     * The speed at the start of the next primitive.
+     */
+    float speed_{ 0 };
+
+    /**
+     * The highest speed the acceleration reaches by the start of the next
+     * primitive, whatever comes after it.
+     */
+    float forward_speed_{ 0 };
+
+    /**
+     * @brief Reads the kind, directions and length of the primitive at a
+     * cursor and advances the cursor past it.
+     *
+     * @return False at the end of the route.
+     */
+    template <typename Path>
+    static bool nextShape(
+        const Path& route, Cursor& cursor, MotionPrimitive& primitive);
+
+    /**
+     * @brief Returns the speed limit at the start or end of a primitive.
+     */
+    [[nodiscard]] float speedLimit(const MotionPrimitive& primitive) const {
+        switch (primitive.kind) {
+            case MotionKind::Straight:
+                return static_cast<float>(profile_.maxSpeed);
+            case MotionKind::InPlaceTurn:
+                return 0;
+            case MotionKind::SmoothTurn:
+            case MotionKind::Diagonal:
+                return static_cast<float>(profile_.smoothTurnSpeed);
+        }
+        return 0;
+    }
+
+    /**
+     * @brief Returns the length over which a primitive may change its speed:
+     * none for a smooth turn, which keeps its speed.
+     */
+    [[nodiscard]] static float rampLength(const MotionPrimitive& primitive) {
+        return primitive.kind == MotionKind::SmoothTurn ? 0 : primitive.length;
+    }
+};
+
+template <typename Path>
+bool MotionCompiler::nextShape(
+    const Path& route, Cursor& cursor, MotionPrimitive& primitive) {
+    const int num_moves = static_cast<int>(route.size());
+    if (num_moves == 0 || cursor.step > num_moves) {
+        return false;
+    }
+
+    primitive = MotionPrimitive{};
+    const auto relative_dir = cursor.step < num_moves
+                                  ? route[cursor.step] - cursor.orientation
+                                  : Dir4::Up;
+    if (!cursor.moving && relative_dir != Dir4::Up) {
+        primitive.kind = MotionKind::InPlaceTurn;
+        primitive.dir = primitive.alternateDir = route[cursor.step];
+        primitive.turn = relative_dir;
+        cursor.orientation = route[cursor.step];
+        return true;
+    }
+
+    if (relative_dir == Dir4::Right || relative_dir == Dir4::Left) {
+        // The zigzag of alternating turns starting here
+        const int i = cursor.step;
+        int end = i + 1;
+        while (end < num_moves && route[end] - route[end - 1] != Dir4::Up &&
+               route[end] - route[end - 1] != Dir4::Down &&
+               route[end] - route[end - 1] !=
+                   route[end - 1] - route[end - 2]) {
+            ++end;
+        }
+
+        primitive.dir = route[i];
+        primitive.turn = relative_dir;
+        primitive.cells = end - i;
+        if (primitive.cells == 1) {
+            primitive.kind = MotionKind::SmoothTurn;
+            primitive.alternateDir = route[i];
+            primitive.length = std::numbers::pi_v<float> / 4;
+        } else {
+            primitive.kind = MotionKind::Diagonal;
+            primitive.alternateDir = route[i + 1];
+            primitive.length = static_cast<float>(primitive.cells) *
+                               std::numbers::sqrt2_v<float> / 2;
+        }
+        cursor.orientation = route[end - 1];
+        cursor.step = end;
+        return true;
+    }
+
+    // A straight run, from half a cell if it starts at rest, up to a turn,
+    // a reversal or the end of the route
+    primitive.dir = primitive.alternateDir = cursor.orientation;
+    for (bool first = true;; first = false) {
+        if (cursor.step == num_moves) {
+            primitive.length += 0.5f;
+            ++cursor.step;
+            break;
+        }
+
+        const auto dir = route[cursor.step] - cursor.orientation;
+        if (dir == Dir4::Down) {
+            primitive.length += 0.5f;
+            cursor.moving = false;
+            break;
+        }
+        if (dir != Dir4::Up) {
+            cursor.moving = true;
+            break;
+        }
+        primitive.length += first && !cursor.moving ? 0.5f : 1;
+        ++primitive.cells;
+        ++cursor.step;
+    }
+    return true;
+}
+
+template <typename Path>
+bool MotionCompiler::next(const Path& route, MotionPrimitive& primitive) {
+    if (!nextShape(route, cursor_, primitive)) {
+        return false;
+    }
+
+    // The speed limit between this primitive and the next; 0 at the end
+    Cursor ahead = cursor_;
+    MotionPrimitive following;
+    const bool has_following = nextShape(route, ahead, following);
+    const float boundary_limit =
+        has_following
+            ? std::min(speedLimit(primitive), speedLimit(following))
+            : 0;
+
+    // A later limit lowers the speed to what the acceleration reaches from
+    // it over the runs in between. Once that is above the speed found so
+    // far even from rest, nothing further ahead can lower it
+    float backward_speed = boundary_limit;
+    float ramp = 0;
+    for (bool has_next = has_following; has_next;) {
+        ramp += rampLength(following);
+        if (profile_.reachableSpeed(ramp, 0) >= backward_speed) {
+            break;
+        }
+
+        const auto current = following;
+        has_next = nextShape(route, ahead, following);
+        const float limit =
+            has_next ? std::min(speedLimit(current), speedLimit(following))
+                     : 0;
+        backward_speed = std::min(
+            backward_speed,
+            static_cast<float>(profile_.reachableSpeed(ramp, limit)));
+    }
+
+    const float forward_speed = std::min(
+        boundary_limit, static_cast<float>(profile_.reachableSpeed(
+                            rampLength(primitive), forward_speed_)));
+    primitive.entrySpeed = speed_;
+    primitive.exitSpeed = std::min(forward_speed, backward_speed);
+    speed_ = primitive.exitSpeed;
+    forward_speed_ = forward_speed;
+
+    switch (primitive.kind) {
+        case MotionKind::InPlaceTurn:
+            primitive.duration =
+                static_cast<float>(profile_.turnTimeTo(primitive.turn));
+            break;
+        case MotionKind::SmoothTurn:
+            primitive.peakSpeed = primitive.entrySpeed;
+            primitive.duration = primitive.length / primitive.peakSpeed;
+            break;
+        case MotionKind::Straight:
+        case MotionKind::Diagonal:
+            primitive.peakSpeed = static_cast<float>(profile_.peakSpeed(
+                primitive.length, primitive.entrySpeed,
+                primitive.exitSpeed));
+            primitive.duration = static_cast<float>(profile_.runTime(
+                primitive.length, primitive.entrySpeed,
+                primitive.exitSpeed));
+            break;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Compiles a whole route into motion primitives with a
+ * `MotionCompiler`.
+ *
+ * @param route The absolute directions of the cells to enter, without
+ * repeated cells; it needs `size()` and `operator[]`.
+ * @param orientation The orientation of the mouse before the route.
+ * @param profile The limits the durations are computed with.
+ * @param plan Receives the primitives, at most `route.size() + 2` for a
+ * route that never reverses. It needs `clear()` and `push_back()`, such as a
+ * `FixedVector`.
+ * @throws std::invalid_argument if the profile is not valid.
+ */
+template <typename Path, typename Plan>
+void compileMotion(
+    const Path& route, const Dir4 orientation, const MotionProfile& profile,
+    Plan& plan) {
+    plan.clear();
+    MotionCompiler compiler;
+    compiler.start(orientation, profile);
+    for (MotionPrimitive primitive; compiler.next(route, primitive);) {
+        plan.push_back(primitive);
+    }
+}
+
+}  // namespace Mazemouse
+
+#endif
@@ -0,0 +1,156 @@
+#ifndef MOTION_PROFILE_HPP
+#define MOTION_PROFILE_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include "../Maze/Dir4.hpp"
+
+namespace Mazemouse {
+
+/**
+ * @brief The physical limits of a mouse, used to estimate how long a route
+ * takes.
+ *
+ * Distances are measured in cells and times in seconds. A straight run
+ * starts and ends at rest: the mouse accelerates, cruises at the maximum
+ * speed if the run is long enough, and decelerates again. Turns are made in
+ * place between runs, or, by motion primitives, on the move at
+ * `smoothTurnSpeed`.
+ */
+struct MotionProfile {
+    /**
+     * The acceleration and deceleration, in cells per second squared.
+     */
+    double acceleration{ 25.0 };
+
+    /**
+     * The maximum speed, in cells per second.
+     */
+    double maxSpeed{ 10.0 };
+
+    /**
+     * The time of a 90-degree turn in place, in seconds.
+     */
+    double turnTime{ 0.25 };
+
+    /**
+     * The time of a 180-degree turn in place, in seconds.
+     */
+    double uTurnTime{ 0.5 };
+
+    /**
+     * The speed of smooth turns, including the 45-degree turns into and out
+     * of diagonals, in cells per second.
+     */
+    double smoothTurnSpeed{ 3.0 };
+
+    /**
+     * @brief Checks that the limits describe a mouse that can move.
+     *
+     * @throws std::invalid_argument if the acceleration, the maximum speed or
+     * the smooth turn speed is not a positive finite number, the smooth turn
+     * speed exceeds the maximum speed, or a turn time is negative.
+     */
+    void validate() const {
+        const auto positive = [](const double value) {
+            return std::isfinite(value) && value > 0;
+        };
+        if (!positive(acceleration) || !positive(maxSpeed) ||
+            !positive(smoothTurnSpeed) || smoothTurnSpeed > maxSpeed) {
+            throw std::invalid_argument(
+                "MotionProfile: the acceleration and speeds must be positive, "
+                "and smoothTurnSpeed at most maxSpeed");
+        }
+        if (!(turnTime >= 0) || !(uTurnTime >= 0)) {
+            throw std::invalid_argument(
+                "MotionProfile: the turn times must not be negative");
+        }
+    }
+
+    /**
+     * @brief Returns the time of a straight run of the given number of cells,
+     * from rest to rest.
+     */
+    [[nodiscard]] double straightTime(const int cells) const {
+        if (cells >= saturationCells()) {
+            return cells / maxSpeed + maxSpeed / acceleration;
+        }
+
+        return 2 * std::sqrt(cells / acceleration);
+    }
+
+    /**
+     * @brief Returns the time of turning in place towards a relative
+     * direction.
+     */
+    [[nodiscard]] double turnTimeTo(const Dir4 relative_dir) const {
+        switch (relative_dir) {
+            case Dir4::Up:
+                return 0;
+            case Dir4::Right:
+            case Dir4::Left:
+                return turnTime;
+            case Dir4::Down:
+                return uTurnTime;
+        }
+        return 0;
+    }
+
+    /**
+     * @brief Returns the highest speed a run of the given length reaches
+     * between its entry and exit speeds, accelerating and then decelerating.
+     */
+    [[nodiscard]] double peakSpeed(
+        const double length, const double entrySpeed,
+        const double exitSpeed) const {
+        return std::min(
+            maxSpeed,
+            std::sqrt(
+                acceleration * length +
+                (entrySpeed * entrySpeed + exitSpeed * exitSpeed) / 2));
+    }
+
+    /**
+     * @brief Returns the time of a run along a trapezoidal velocity profile:
+     * from the entry speed up to `peakSpeed()`, cruising there, and down to
+     * the exit speed. The speeds must be reachable within the length.
+     */
+    [[nodiscard]] double runTime(
+        const double length, const double entrySpeed,
+        const double exitSpeed) const {
+        const double peak = peakSpeed(length, entrySpeed, exitSpeed);
+        if (peak <= 0) {
+            return 0;
+        }
+
+        const double ramp_length =
+            (2 * peak * peak - entrySpeed * entrySpeed -
+             exitSpeed * exitSpeed) /
+            (2 * acceleration);
+
+        return (2 * peak - entrySpeed - exitSpeed) / acceleration +
+               (length - ramp_length) / peak;
+    }
+
+    /**
+     * @brief Returns the highest speed reachable after a run of the given
+     * length from a speed, ignoring `maxSpeed`.
+     */
+    [[nodiscard]] double reachableSpeed(
+        const double length, const double speed) const {
+        return std::sqrt(speed * speed + 2 * acceleration * length);
+    }
+
+    /**
+     * @brief Returns the length of the shortest run that reaches the maximum
+     * speed. Every cell beyond it adds exactly `1 / maxSpeed` seconds.
+     */
+    [[nodiscard]] double saturationCells() const {
+        return maxSpeed * maxSpeed / acceleration;
+    }
+};
+
+}  // namespace Mazemouse
+
+#endif
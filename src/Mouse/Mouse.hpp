@@ -1,7 +1,10 @@
 #ifndef MOUSE_HPP
 #define MOUSE_HPP
 
+#include <concepts>
+#include <type_traits>
 #include "../Maze/Maze.hpp"
+#include "MotionPrimitive.hpp"
 
 namespace Mazemouse {
 
@@ -68,8 +71,42 @@ struct MouseHardwareInterface {
      * orientation.
      */
     virtual void hardwareTurn(Dir4 relative_dir) = 0;
+
+    /**
+     * @brief Runs a motion primitive of a compiled rush.
+     *
+     * This function should be implemented to follow the path of the primitive
+     * with its velocity profile, starting from the current position and
+     * orientation.
+     *
+     * @param primitive The movement to run.
+     */
+    virtual void hardwareRunPrimitive(const MotionPrimitive& primitive) = 0;
 };
 
+/**
+ * @brief Checks if a type provides the hardware functions of
+ * `MouseHardwareInterface`, whether or not they are virtual.
+ */
+template <typename H>
+concept MouseHardware = requires(
+    H& hardware, Dir4 dir, int step, const MotionPrimitive& primitive) {
+    { hardware.hardwareCheckWall(dir) } -> std::convertible_to<bool>;
+    hardware.hardwareMoveForward(step);
+    hardware.hardwareTurn(dir);
+    hardware.hardwareRunPrimitive(primitive);
+};
+
+/**
+ * @brief The hardware argument of a mouse whose hardware is bound at compile
+ * time by the class deriving from it, such as `Simulation`.
+ *
+ * A mouse with this argument is a placeholder; `WithHardware` replaces it
+ * with the implementing class. It is also the empty base of every mouse bound
+ * at compile time, in place of `MouseHardwareInterface`.
+ */
+struct StaticHardware {};
+
 /**
  * @brief Represents the mouse that explores a maze.
  *
@@ -77,16 +114,40 @@ struct MouseHardwareInterface {
  * navigates through a maze. The mouse maintains a representation of the maze
  * in its memory and tracks its current position, orientation, and exploration
  * status.
+ *
+ * By default, the mouse reaches its hardware through the virtual
+ * `MouseHardwareInterface`, which a derived class implements. Alternatively,
+ * `Hw` names the most derived class itself (the curiously recurring template
+ * pattern). The mouse then calls the hardware and its own `checkWall()`,
+ * `moveForward()` and `turn()` through that class, so that a `final` one lets
+ * the compiler resolve and inline every call of a cycle.
+ *
+ * @tparam Hw `MouseHardwareInterface`, or the most derived class, which must
+ * satisfy `MouseHardware`.
  */
-template <int S, DerivedFromCell C, DerivedFromEdge E>
-struct Mouse : MouseHardwareInterface {
+template <
+    int S, DerivedFromCell C, DerivedFromEdge E,
+    typename Hw = MouseHardwareInterface>
+struct Mouse : std::conditional_t<
+                   std::is_same_v<Hw, MouseHardwareInterface>,
+                   MouseHardwareInterface, StaticHardware> {
+    using MazeType = Maze<S, C, E>;
+
+    /**
+     * The class every call to the hardware goes through.
+     */
+    using Derived = std::conditional_t<
+        std::is_same_v<Hw, MouseHardwareInterface>, Mouse, Hw>;
+
     /**
      * @brief Represents the maze in the mouse's memory.
      *
      * This member stores the maze structure, where all edges have their hasWall
      * property initialized to true at the beginning. As the mouse explores the
      * maze, the hasWall property of edges will be updated to reflect the
-     * actual configuration of the maze.
+     * actual configuration of the maze, and the isKnown property of every
+     * edge the mouse has seen is set. A maze of `NoEdge` keeps only the
+     * cells, for mice that remember the walls elsewhere.
      */
     Maze<S, C, E> maze;
 
@@ -118,6 +179,18 @@ struct Mouse : MouseHardwareInterface {
 
     Mouse(Vector2 startingPosition, Dir4 startingOrientation);
 
+    /**
+     * @brief Creates a mouse whose memory starts from the given maze.
+     *
+     * Runtime-sized mice must use this constructor, since the size of the
+     * maze in their memory is only known at runtime.
+     *
+     * @param startingPosition The cell the mouse starts from.
+     * @param startingOrientation The direction the mouse initially faces.
+     * @param maze The initial maze memory, usually with every wall present.
+     */
+    Mouse(Vector2 startingPosition, Dir4 startingOrientation, Maze<S, C, E> maze);
+
     /**
      * @brief Calculates the absolute direction based on the current
      * orientation.
@@ -181,6 +254,17 @@ struct Mouse : MouseHardwareInterface {
      */
     virtual void turn(Dir4 target_orientation);
 
+    /**
+     * @brief Runs a motion primitive.
+     *
+     * This method commands the hardware to run the primitive, then moves the
+     * mouse into the last cell it enters and faces the direction of that
+     * move.
+     *
+     * @param primitive The movement to run.
+     */
+    virtual void runPrimitive(const MotionPrimitive& primitive);
+
     /**
      * @brief Executes the next step in the exploration process.
      *
@@ -203,33 +287,63 @@ struct Mouse : MouseHardwareInterface {
      * @brief
      */
     virtual void resetRushingState();
+
+    /**
+     * @brief Returns this mouse as the class the hardware is bound to.
+     */
+    Derived& derived() { return static_cast<Derived&>(*this); }
 };
 
-template <int S, DerivedFromCell C, DerivedFromEdge E>
-Mouse<S, C, E>::Mouse(
+/**
+ * @brief Binds a mouse with the `StaticHardware` argument to the class that
+ * implements its hardware; any other mouse type is left unchanged.
+ */
+template <typename M, typename Hw>
+struct WithHardware {
+    using type = M;
+};
+
+template <
+    template <int, typename, typename, typename> class M, int S, typename C,
+    typename E, typename Hw>
+struct WithHardware<M<S, C, E, StaticHardware>, Hw> {
+    using type = M<S, C, E, Hw>;
+};
+
+template <int S, DerivedFromCell C, DerivedFromEdge E, typename Hw>
+Mouse<S, C, E, Hw>::Mouse(
     const Vector2 startingPosition, const Dir4 startingOrientation) :
     startingPosition{ startingPosition },
     startingOrientation{ startingOrientation }, position{ startingPosition },
     orientation(startingOrientation) {}
 
-template <int S, DerivedFromCell C, DerivedFromEdge E>
-Dir4 Mouse<S, C, E>::getAbsoluteDir(const Dir4 relative_dir) const {
+template <int S, DerivedFromCell C, DerivedFromEdge E, typename Hw>
+Mouse<S, C, E, Hw>::Mouse(
+    const Vector2 startingPosition, const Dir4 startingOrientation,
+    Maze<S, C, E> maze) :
+    maze{ std::move(maze) }, startingPosition{ startingPosition },
+    startingOrientation{ startingOrientation }, position{ startingPosition },
+    orientation(startingOrientation) {}
+
+template <int S, DerivedFromCell C, DerivedFromEdge E, typename Hw>
+Dir4 Mouse<S, C, E, Hw>::getAbsoluteDir(const Dir4 relative_dir) const {
     return orientation + relative_dir;
 }
 
-template <int S, DerivedFromCell C, DerivedFromEdge E>
-Dir4 Mouse<S, C, E>::getRelativeDir(const Dir4 absolute_dir) const {
+template <int S, DerivedFromCell C, DerivedFromEdge E, typename Hw>
+Dir4 Mouse<S, C, E, Hw>::getRelativeDir(const Dir4 absolute_dir) const {
     return absolute_dir - orientation;
 }
 
-template <int S, DerivedFromCell C, DerivedFromEdge E>
-bool Mouse<S, C, E>::checkWall(const Dir4 dir) {
-    return hardwareCheckWall(dir);
+template <int S, DerivedFromCell C, DerivedFromEdge E, typename Hw>
+bool Mouse<S, C, E, Hw>::checkWall(const Dir4 dir) {
+    static_assert(MouseHardware<Derived>);
+    return derived().hardwareCheckWall(dir);
 }
 
-template <int S, DerivedFromCell C, DerivedFromEdge E>
-void Mouse<S, C, E>::moveForward(const int length) {
-    hardwareMoveForward(length);
+template <int S, DerivedFromCell C, DerivedFromEdge E, typename Hw>
+void Mouse<S, C, E, Hw>::moveForward(const int length) {
+    derived().hardwareMoveForward(length);
 
     switch (orientation) {
         case Dir4::Up:
@@ -246,15 +360,27 @@ void Mouse<S, C, E>::moveForward(const int length) {
     }
 }
 
-template <int S, DerivedFromCell C, DerivedFromEdge E>
-void Mouse<S, C, E>::turn(const Dir4 target_orientation) {
+template <int S, DerivedFromCell C, DerivedFromEdge E, typename Hw>
+void Mouse<S, C, E, Hw>::turn(const Dir4 target_orientation) {
+    const auto relative_dir = getRelativeDir(target_orientation);
     orientation = target_orientation;
 
-    return hardwareTurn(getRelativeDir(orientation));
+    return derived().hardwareTurn(relative_dir);
+}
+
+template <int S, DerivedFromCell C, DerivedFromEdge E, typename Hw>
+void Mouse<S, C, E, Hw>::runPrimitive(const MotionPrimitive& primitive) {
+    derived().hardwareRunPrimitive(primitive);
+
+    orientation = primitive.dir;
+    for (int i = 0; i < primitive.cells; ++i) {
+        orientation = primitive.cellDir(i);
+        position = position + get_vector(orientation);
+    }
 }
 
-template <int S, DerivedFromCell C, DerivedFromEdge E>
-void Mouse<S, C, E>::resetRushingState() {
+template <int S, DerivedFromCell C, DerivedFromEdge E, typename Hw>
+void Mouse<S, C, E, Hw>::resetRushingState() {
     this->position = startingPosition;
     this->orientation = startingOrientation;
     this->state = MouseState::RushingToFinish;
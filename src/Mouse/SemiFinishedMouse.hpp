@@ -6,10 +6,23 @@
 namespace Mazemouse {
 
 template <int S>
-class SemiFinishedMouse : public AStarMouse<S, FloodFillCell, Edge> {
+class SemiFinishedMouse : public AStarMouse<S, AStarCell, Edge> {
  public:
-    SemiFinishedMouse() :
-        AStarMouse<S, FloodFillCell, Edge>({ 0, S - 1 }, Dir4::Up){};
+    SemiFinishedMouse()
+        requires(S != DYNAMIC_SIZE)
+        : AStarMouse<S, AStarCell, Edge>({ 0, S - 1 }, Dir4::Up){};
+
+    /**
+     * @brief Creates a runtime-sized mouse starting from the bottom-left cell.
+     *
+     * @param width The number of cells along the x-axis.
+     * @param height The number of cells along the y-axis.
+     */
+    SemiFinishedMouse(const int width, const int height)
+        requires(S == DYNAMIC_SIZE)
+        : AStarMouse<S, AStarCell, Edge>(
+              { 0, height - 1 }, Dir4::Up,
+              Maze<S, AStarCell, Edge>(width, height)){};
 };
 
 }  // namespace Mazemouse
@@ -0,0 +1,367 @@
+#ifndef TIME_OPTIMAL_MOUSE_HPP
+#define TIME_OPTIMAL_MOUSE_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <numbers>
+#include <stdexcept>
+#include <vector>
+#include "AStarMouse.hpp"
+#include "MotionProfile.hpp"
+
+namespace Mazemouse {
+
+/**
+ * @brief A mouse that rushes along the fastest known route instead of the
+ * shortest one.
+ *
+ * The planner prices every move with the motion primitives the route is run
+ * as (see `MotionCompiler`). Its states are (cell, heading, primitive, run):
+ * the primitive the mouse is in the middle of, the straight run from the
+ * start, a later straight run, or a smooth turn or diagonal whose last turn
+ * was to the right or to the left, and the cells of the straight run or turns
+ * of the zigzag so far. Extending a primitive costs the difference between
+ * its durations before and after, as if it ended at `smoothTurnSpeed`; ending
+ * it adds what the actual end costs more, such as the smooth turn a single
+ * turn makes instead of a diagonal, or the stop at the finish. Runs at or
+ * beyond the length at which every further cell costs the same share a
+ * state.
+ *
+ * The costs add up to the duration of the compiled rush when the mouse
+ * reaches `smoothTurnSpeed` within half a cell, as with the default profile;
+ * otherwise turns are priced at the speed half a cell allows. Routes that
+ * reverse are not considered, since the compiled rush only turns in place at
+ * the start.
+ */
+template <
+    int S, DerivedFromAStarCell C, DerivedFromEdge E,
+    typename Hw = MouseHardwareInterface>
+class TimeOptimalMouse : public AStarMouse<S, C, E, Hw> {
+ public:
+    TimeOptimalMouse(
+        const Vector2 startingPosition, const Dir4 startingOrientation)
+        requires(S != DYNAMIC_SIZE)
+        : TimeOptimalMouse(startingPosition, startingOrientation, {}) {}
+
+    TimeOptimalMouse(
+        const Vector2 startingPosition, const Dir4 startingOrientation,
+        Maze<S, C, E> maze) :
+        AStarMouse<S, C, E, Hw>(
+            startingPosition, startingOrientation, std::move(maze)),
+        max_run(saturationRun(this->motion_profile)) {
+        allocateStates();
+    }
+
+ protected:
+    /**
+     * @brief Replaces `route` with the fastest known route from the current
+     * cell and orientation to the finish.
+     *
+     * @return True if a route was found; otherwise `route` is left unchanged.
+     */
+    bool planRoute() override;
+
+    /**
+     * @brief Returns the planned duration of the rush along `route`, as of
+     * the last `planRoute()` that found a route.
+     */
+    [[nodiscard]] double plannedTime() const {
+        return arrival_times[numStates(max_run)];
+    }
+
+ private:
+    /**
+     * @brief The primitive a state is in the middle of.
+     */
+    enum class Leg : std::uint8_t {
+        // The straight run from the start, which starts at rest
+        FirstStraight,
+
+        // A straight run after a turn
+        Straight,
+
+        // A smooth turn or a diagonal whose last turn was to the right
+        RightTurn,
+
+        // A smooth turn or a diagonal whose last turn was to the left
+        LeftTurn
+    };
+
+    static constexpr int NUM_LEGS = 4;
+
+    /**
+     * The time to reach every state, indexed by `stateIndex()`, and last the
+     * time to stop at the finish.
+     */
+    std::vector<double> arrival_times{};
+
+    /**
+     * The state every state was reached from, or -1.
+     */
+    std::vector<int> parent_states{};
+
+    IndexedHeap<double, DYNAMIC_SIZE> open_states{};
+
+    /**
+     * The run, in cells or turns, at which every state shares the cost of
+     * further cells.
+     */
+    int max_run{ 0 };
+
+    /**
+     * @brief Returns the run at which every further cell costs the same with
+     * a profile, or the longest run the maze has room for if that is
+     * shorter.
+     */
+    [[nodiscard]] int saturationRun(const MotionProfile& profile) const;
+
+    /**
+     * @brief Returns the number of states with runs up to `run`.
+     *
+     * @throw std::invalid_argument If the states cannot be indexed by an
+     * `int`.
+     */
+    [[nodiscard]] int numStates(int run) const;
+
+    /**
+     * @brief Sizes the state arrays for runs up to `max_run`.
+     *
+     * The arrays only grow, so planning with the profile the mouse was
+     * constructed with, or one that saturates sooner, never allocates.
+     */
+    void allocateStates();
+
+    [[nodiscard]] int stateIndex(
+        const int index, const Dir4 heading, const Leg leg,
+        const int run) const {
+        return ((index * 4 + static_cast<int>(heading)) * NUM_LEGS +
+                static_cast<int>(leg)) *
+                   (max_run + 1) +
+               run;
+    }
+};
+
+template <int S, DerivedFromAStarCell C, DerivedFromEdge E, typename Hw>
+int TimeOptimalMouse<S, C, E, Hw>::saturationRun(
+    const MotionProfile& profile) const {
+    // A diagonal run grows by half the diagonal of a cell per turn, so it
+    // saturates last. A zigzag turns in up to every cell of a staircase
+    // across the maze, so no run is longer than the width plus the height
+    constexpr double half_diagonal = std::numbers::sqrt2 / 2;
+    const int longest_run = this->maze.width() + this->maze.height();
+    return static_cast<int>(std::clamp(
+        std::ceil(profile.saturationCells() / half_diagonal) + 1, 2.0,
+        static_cast<double>(longest_run)));
+}
+
+template <int S, DerivedFromAStarCell C, DerivedFromEdge E, typename Hw>
+int TimeOptimalMouse<S, C, E, Hw>::numStates(const int run) const {
+    const auto num_states = static_cast<std::size_t>(this->maze.numCells()) *
+                            4 * NUM_LEGS * (run + 1);
+
+    // The finish state comes last
+    if (num_states >= std::numeric_limits<int>::max()) {
+        throw std::invalid_argument(
+            "TimeOptimalMouse: the maze has more planning states than an int "
+            "can index");
+    }
+
+    return static_cast<int>(num_states);
+}
+
+template <int S, DerivedFromAStarCell C, DerivedFromEdge E, typename Hw>
+void TimeOptimalMouse<S, C, E, Hw>::allocateStates() {
+    const auto num_states = static_cast<std::size_t>(numStates(max_run)) + 1;
+    if (num_states <= arrival_times.size()) {
+        return;
+    }
+
+    arrival_times.resize(num_states);
+    parent_states.resize(num_states);
+    open_states =
+        IndexedHeap<double, DYNAMIC_SIZE>(static_cast<int>(num_states));
+}
+
+template <int S, DerivedFromAStarCell C, DerivedFromEdge E, typename Hw>
+bool TimeOptimalMouse<S, C, E, Hw>::planRoute() {
+    const auto& profile = this->motion_profile;
+    profile.validate();
+
+    constexpr double half_diagonal = std::numbers::sqrt2 / 2;
+    max_run = saturationRun(profile);
+    allocateStates();
+
+    const int num_states = numStates(max_run);
+    const int finish_state = num_states;
+    std::fill_n(
+        arrival_times.begin(), num_states + 1,
+        std::numeric_limits<double>::infinity());
+    std::fill_n(parent_states.begin(), num_states + 1, -1);
+    open_states.clear();
+    this->floodEstimates();
+
+    // The durations of the primitives, ending at the turn speed
+    const double turn_speed =
+        std::min(profile.smoothTurnSpeed, std::sqrt(profile.acceleration));
+    const auto firstStraightTime = [&](const int cells) {
+        return profile.runTime(cells - 0.5, 0, turn_speed);
+    };
+    const auto straightTime = [&](const int cells) {
+        return profile.runTime(cells, turn_speed, turn_speed);
+    };
+    const auto diagonalTime = [&](const int turns) {
+        return profile.runTime(turns * half_diagonal, turn_speed, turn_speed);
+    };
+    const auto runTime = [&](const Leg leg, const int run) {
+        switch (leg) {
+            case Leg::FirstStraight:
+                return firstStraightTime(run);
+            case Leg::Straight:
+                return straightTime(run);
+            case Leg::RightTurn:
+            case Leg::LeftTurn:
+                return diagonalTime(run);
+        }
+        return 0.0;
+    };
+
+    // What ending a primitive costs more than ending it at the turn speed:
+    // a single turn is a smooth turn rather than a diagonal
+    const auto endTurnTime = [&](const int turns) {
+        return turns == 1
+                   ? std::numbers::pi / 4 / turn_speed - diagonalTime(1)
+                   : 0.0;
+    };
+
+    // What stopping at the centre of a finishing cell costs more
+    const auto stopTime = [&](const Leg leg, const int run) {
+        switch (leg) {
+            case Leg::FirstStraight:
+                return run == 0 ? 0.0
+                                : profile.runTime(run, 0, 0) -
+                                      firstStraightTime(run);
+            case Leg::Straight:
+                return profile.runTime(run + 0.5, turn_speed, 0) -
+                       straightTime(run);
+            case Leg::RightTurn:
+            case Leg::LeftTurn:
+                return endTurnTime(run) + profile.runTime(0.5, turn_speed, 0);
+        }
+        return 0.0;
+    };
+
+    // Every remaining cell takes at least the time of half a diagonal at
+    // the maximum speed
+    const auto keyOf = [&](const int index, const double time) {
+        return time + this->estimateDistance(index) * half_diagonal /
+                          profile.maxSpeed;
+    };
+    const auto relax = [&](const int from_state, const int state,
+                           const double time, const double key) {
+        if (time < arrival_times[state]) {
+            arrival_times[state] = time;
+            parent_states[state] = from_state;
+            open_states.push(state, key);
+        }
+    };
+    const auto relaxMove = [&](const int from_state, const int index,
+                               const Dir4 heading, const Leg leg,
+                               const int run, const double time) {
+        relax(
+            from_state,
+            stateIndex(index, heading, leg, std::min(run, max_run)), time,
+            keyOf(index, time));
+    };
+
+    const auto starting_index = this->maze.cellIndex(this->position);
+    const auto starting_state =
+        stateIndex(starting_index, this->orientation, Leg::FirstStraight, 0);
+    arrival_times[starting_state] = 0;
+    open_states.push(starting_state, keyOf(starting_index, 0));
+
+    while (!open_states.empty()) {
+        const auto state = open_states.pop();
+        if (state == finish_state) {
+            break;
+        }
+
+        const int run = state % (max_run + 1);
+        const auto leg = static_cast<Leg>(state / (max_run + 1) % NUM_LEGS);
+        const auto heading =
+            static_cast<Dir4>(state / (max_run + 1) / NUM_LEGS % 4);
+        const int index = state / (max_run + 1) / NUM_LEGS / 4;
+        const auto time = arrival_times[state];
+        if (this->isFinishCell(this->maze.cellCoord(index))) {
+            const auto finish_time =
+                time + std::max(0.0, stopTime(leg, run));
+            relax(state, finish_state, finish_time, finish_time);
+            continue;
+        }
+
+        const auto open_mask = this->walls.openMask(index);
+        for (int d = 0; d < 4; ++d) {
+            if (!(open_mask >> d & 1)) {
+                continue;
+            }
+
+            const auto dir = static_cast<Dir4>(d);
+            const auto relative_dir = dir - heading;
+            const int neighbour_index = this->maze.neighbourIndex(index, dir);
+            if (state == starting_state) {
+                relaxMove(
+                    state, neighbour_index, dir, Leg::FirstStraight, 1,
+                    time + profile.turnTimeTo(relative_dir) +
+                        firstStraightTime(1));
+                continue;
+            }
+            if (relative_dir == Dir4::Down) {
+                continue;
+            }
+
+            const bool is_turn = leg == Leg::RightTurn || leg == Leg::LeftTurn;
+            const auto turn_leg =
+                relative_dir == Dir4::Right ? Leg::RightTurn : Leg::LeftTurn;
+            if (relative_dir == Dir4::Up && !is_turn) {
+                relaxMove(
+                    state, neighbour_index, dir, leg, run + 1,
+                    time + runTime(leg, run + 1) - runTime(leg, run));
+            } else if (relative_dir == Dir4::Up) {
+                relaxMove(
+                    state, neighbour_index, dir, Leg::Straight, 1,
+                    time + endTurnTime(run) + straightTime(1));
+            } else if (is_turn && turn_leg != leg) {
+                // The zigzag goes on
+                relaxMove(
+                    state, neighbour_index, dir, turn_leg, run + 1,
+                    time + diagonalTime(run + 1) - diagonalTime(run));
+            } else {
+                relaxMove(
+                    state, neighbour_index, dir, turn_leg, 1,
+                    time + (is_turn ? endTurnTime(run) : 0) +
+                        diagonalTime(1));
+            }
+        }
+    }
+
+    if (parent_states[finish_state] == -1) {
+        return false;
+    }
+
+    // Walk back from the finish along the parent states
+    this->route.clear();
+    for (int state = parent_states[finish_state]; state != starting_state;
+         state = parent_states[state]) {
+        this->route.push_back(
+            static_cast<Dir4>(state / (max_run + 1) / NUM_LEGS % 4));
+    }
+    this->route.reverse();
+    this->rush_step = 0;
+
+    return true;
+}
+
+}  // namespace Mazemouse
+
+#endif
@@ -0,0 +1,569 @@
+#include "BatchSimulation.hpp"
+#include <algorithm>
+#include <climits>
+#include <stdexcept>
+
+namespace Mazemouse {
+
+namespace {
+
+constexpr int EXPLORING = static_cast<int>(MouseState::Exploring);
+
+constexpr int RETURNING = static_cast<int>(MouseState::ReturningToStart);
+
+constexpr int RUSHING = static_cast<int>(MouseState::RushingToFinish);
+
+constexpr int STOPPED = static_cast<int>(MouseState::Stopped);
+
+#ifdef MAZEMOUSE_AVX2
+// The kernel multiplies cell indices by the number of slots with a shift
+static_assert(BATCH_LANES == 8);
+
+__attribute__((target("avx2"))) __m256i loadSlots(
+    const std::vector<int>& values, const int first) {
+    return _mm256_loadu_si256(
+        reinterpret_cast<const __m256i*>(values.data() + first));
+}
+
+__attribute__((target("avx2"))) void storeSlots(
+    std::vector<int>& values, const int first, const __m256i slots) {
+    _mm256_storeu_si256(
+        reinterpret_cast<__m256i*>(values.data() + first), slots);
+}
+
+/**
+ * @brief Returns the offset of the data of a cell for every slot of a block
+ * from the data of the block.
+ */
+__attribute__((target("avx2"))) __m256i cellOffsets(const __m256i cells) {
+    return _mm256_add_epi32(
+        _mm256_slli_epi32(cells, 3), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+}
+
+__attribute__((target("avx2"))) __m256i gatherCells(
+    const int* data, const __m256i cells) {
+    return _mm256_i32gather_epi32(data, cellOffsets(cells), 4);
+}
+
+/**
+ * @brief Like `gatherCells()` for bytes, which are read as the low byte of a
+ * 32-bit load.
+ */
+__attribute__((target("avx2"))) __m256i gatherCellBytes(
+    const std::uint8_t* data, const __m256i cells) {
+    return _mm256_and_si256(
+        _mm256_i32gather_epi32(
+            reinterpret_cast<const int*>(data), cellOffsets(cells), 1),
+        _mm256_set1_epi32(0xFF));
+}
+#endif
+
+}  // namespace
+
+BatchSimulation::BatchSimulation(
+    const std::vector<SimulationMaze>& realMazes,
+    const Vector2 startingPosition, const Dir4 startingOrientation) :
+    num_lanes_(static_cast<int>(realMazes.size())),
+    num_cells_(realMazes.empty() ? 0 : realMazes.front().numCells()),
+    starting_index_(0), num_running_(num_lanes_), next_lane_(0),
+    num_active_blocks_(std::min(
+        (num_lanes_ + BATCH_LANES - 1) / BATCH_LANES, BATCH_MAX_BLOCKS)),
+    offsets_{} {
+    setMotionProfile(motion_profile_);
+    if (realMazes.empty()) {
+        return;
+    }
+
+    const auto& geometry = realMazes.front();
+    const int width = geometry.width(), height = geometry.height();
+    for (const auto& maze : realMazes) {
+        if (maze.width() != width || maze.height() != height) {
+            throw std::invalid_argument(
+                "BatchSimulation(): the real mazes differ in size");
+        }
+    }
+
+    starting_index_ = geometry.cellIndex(startingPosition);
+    offsets_[static_cast<int>(Dir4::Up)] = -width;
+    offsets_[static_cast<int>(Dir4::Right)] = 1;
+    offsets_[static_cast<int>(Dir4::Down)] = width;
+    offsets_[static_cast<int>(Dir4::Left)] = -1;
+
+    is_finish_.assign(num_cells_, 0);
+    for (const int x : { width / 2 - 1, width / 2 }) {
+        for (const int y : { height / 2 - 1, height / 2 }) {
+            is_finish_[geometry.cellIndex({ x, y })] = 1;
+        }
+    }
+
+    open_masks_.resize(static_cast<std::size_t>(num_lanes_) * num_cells_);
+    for (int lane = 0; lane < num_lanes_; ++lane) {
+        const auto walls =
+            WallBitboard<DYNAMIC_SIZE>::fromMaze(realMazes[lane]);
+        for (int cell = 0; cell < num_cells_; ++cell) {
+            open_masks_[static_cast<std::size_t>(lane) * num_cells_ + cell] =
+                static_cast<std::uint8_t>(walls.openMask(cell));
+        }
+    }
+
+    const int num_slots = num_active_blocks_ * BATCH_LANES;
+    cells_.assign(static_cast<std::size_t>(num_slots) * num_cells_, 0);
+    stacks_.assign(cells_.size() + 3, 0);
+    slot_lanes_.assign(num_slots, -1);
+    positions_.assign(num_slots, starting_index_);
+    orientations_.assign(num_slots, static_cast<int>(startingOrientation));
+    states_.assign(num_slots, STOPPED);
+    start_steps_.assign(num_slots, 0);
+    stack_sizes_.assign(num_slots, 0);
+    route_sizes_.assign(num_slots, 0);
+    rush_steps_.assign(num_slots, 0);
+    exploration_cells_.assign(num_slots, 0);
+    return_cells_.assign(num_slots, 0);
+    rush_cells_.assign(num_slots, 0);
+    turns_.assign(num_slots, 0);
+    rush_times_.assign(num_slots, 0);
+    crashed_.assign(num_slots, 0);
+    lane_slots_.assign(num_lanes_, -1);
+    results_.resize(num_lanes_);
+    starting_orientation_ = static_cast<int>(startingOrientation);
+    for (int slot = 0; slot < num_slots && next_lane_ < num_lanes_; ++slot) {
+        startLane(slot);
+    }
+}
+
+void BatchSimulation::setMotionProfile(const MotionProfile& motionProfile) {
+    motionProfile.validate();
+    motion_profile_ = motionProfile;
+    for (int d = 0; d < 4; ++d) {
+        turn_times_[d] = motionProfile.turnTimeTo(static_cast<Dir4>(d));
+    }
+    straight_time_ = motionProfile.straightTime(1);
+}
+
+bool BatchSimulation::step() {
+    BlockMoves moves{};
+    for (int block = 0; block < num_active_blocks_; ++block) {
+#ifdef MAZEMOUSE_AVX2
+        if (use_avx2_ && hasAvx2()) {
+            stepBlockAvx2(block, moves);
+            finishBlock(block, moves);
+            continue;
+        }
+#endif
+        stepBlock(block, moves);
+        finishBlock(block, moves);
+    }
+    ++num_steps_;
+    compact();
+
+    return num_running_ > 0;
+}
+
+void BatchSimulation::run(const long maxCycles) {
+    max_cycles_ = maxCycles;
+    if (maxCycles > 0) {
+        while (step()) {}
+    }
+}
+
+SimulationMetrics BatchSimulation::getMetrics(const int lane) const {
+    const int slot = lane_slots_[lane];
+    return slot < 0 ? results_[lane] : slotMetrics(slot);
+}
+
+std::vector<SimulationMetrics> BatchSimulation::getAllMetrics() const {
+    std::vector<SimulationMetrics> metrics;
+    metrics.reserve(num_lanes_);
+    for (int lane = 0; lane < num_lanes_; ++lane) {
+        metrics.push_back(getMetrics(lane));
+    }
+
+    return metrics;
+}
+
+SimulationMetrics BatchSimulation::slotMetrics(const int slot) const {
+    SimulationMetrics metrics;
+    metrics.cycles = num_steps_ - start_steps_[slot];
+    metrics.explorationCells = exploration_cells_[slot];
+    metrics.returnCells = return_cells_[slot];
+    metrics.rushCells = rush_cells_[slot];
+    metrics.rushMoves = rush_cells_[slot];
+    metrics.turns = turns_[slot];
+    metrics.rushTime = rush_times_[slot];
+    metrics.crashed = crashed_[slot];
+    metrics.finished = states_[slot] == STOPPED && !crashed_[slot];
+
+    return metrics;
+}
+
+void BatchSimulation::startLane(const int slot) {
+    const int lane = next_lane_++;
+    const auto* const open_masks =
+        &open_masks_[static_cast<std::size_t>(lane) * num_cells_];
+    for (int cell = 0; cell < num_cells_; ++cell) {
+        cells_[cellOf(slot, cell)] = open_masks[cell];
+    }
+    cells_[cellOf(slot, starting_index_)] |= ON_PATH;
+
+    positions_[slot] = starting_index_;
+    orientations_[slot] = starting_orientation_;
+    states_[slot] = EXPLORING;
+    start_steps_[slot] = num_steps_;
+    for (auto* values :
+         { &stack_sizes_, &route_sizes_, &rush_steps_, &exploration_cells_,
+           &return_cells_, &rush_cells_, &turns_, &crashed_ }) {
+        (*values)[slot] = 0;
+    }
+    rush_times_[slot] = 0;
+
+    slot_lanes_[slot] = lane;
+    lane_slots_[lane] = slot;
+}
+
+void BatchSimulation::stepBlock(const int block, BlockMoves& moves) {
+    const int first = block * BATCH_LANES;
+    const int* const cells = &cells_[cellOf(first, 0)];
+    const std::uint8_t* const stacks = &stacks_[cellOf(first, 0)];
+    const int* const is_finish = is_finish_.data();
+    const int starting_index = starting_index_, last_cell = num_cells_ - 1;
+    int offsets[4];
+    std::copy_n(offsets_, 4, offsets);
+
+    for (int k = 0; k < BATCH_LANES; ++k) {
+        const int slot = first + k;
+        const int state = states_[slot];
+        const int position = positions_[slot];
+        const int orientation = orientations_[slot];
+        const int open_mask = cells[position * BATCH_LANES + k] & OPEN_BITS;
+        const bool exploring = state == EXPLORING;
+        const bool returning = state == RETURNING;
+        const bool rushing = state == RUSHING;
+
+        // Prefer straight on, then right, back and left among the least
+        // visited. The edge behind is known to be open once the mouse has
+        // come through it. Blocked directions read the current cell and then
+        // count as INT_MAX, which keeps the selection free of branches.
+        const int behind = 1 << (orientation + 2) % 4;
+        const int known_mask =
+            open_mask & ~(exploration_cells_[slot] == 0 ? behind : 0);
+        int explore_dir = orientation;
+        int min_visited = INT_MAX;
+        for (int i = 0; i < 4; ++i) {
+            const int dir = (orientation + i) % 4;
+            const int open = known_mask >> dir & 1;
+            const int neighbour = position + (offsets[dir] & -open);
+            const int visited =
+                cells[neighbour * BATCH_LANES + k] >> VISIT_SHIFT |
+                ((open - 1) & INT_MAX);
+            const int fewer = -static_cast<int>(visited < min_visited);
+            explore_dir ^= (explore_dir ^ dir) & fewer;
+            min_visited ^= (min_visited ^ visited) & fewer;
+        }
+
+        // Returning retraces the stack, and rushing replays it from the start
+        const int stack_size = stack_sizes_[slot];
+        const int rush_step = rush_steps_[slot];
+        const int return_dir =
+            (stacks[std::max(stack_size - 1, 0) * BATCH_LANES + k] + 2) % 4;
+        const int rush_dir =
+            stacks[std::min(rush_step, last_cell) * BATCH_LANES + k];
+
+        // Bitwise operators on the conditions keep branches out of the kernel
+        const bool at_finish = is_finish[position];
+        const bool at_start = position == starting_index;
+        const bool rush_done = at_finish | (rush_step >= route_sizes_[slot]);
+        const bool move = (exploring & !at_finish) |
+                          (returning & !at_start & (stack_size > 0)) |
+                          (rushing & !rush_done);
+        const int dir =
+            exploring ? explore_dir : (returning ? return_dir : rush_dir);
+
+        const int relative_dir = (dir - orientation) & 3;
+        turns_[slot] += move & (relative_dir != 0);
+        orientations_[slot] = move ? dir : orientation;
+
+        // A wall of the real maze in the way crashes the mouse
+        const bool open = open_mask >> dir & 1;
+        const bool crashed = move & !open;
+        const bool rush_move = move & rushing;
+        positions_[slot] = position + (offsets[dir] & -(move & open));
+        crashed_[slot] |= crashed;
+        exploration_cells_[slot] += move & exploring;
+        return_cells_[slot] += move & returning;
+        rush_cells_[slot] += rush_move;
+        stack_sizes_[slot] -= move & returning;
+        rush_steps_[slot] += rush_move;
+        rush_times_[slot] += turn_times_[relative_dir] * rush_move;
+        rush_times_[slot] += straight_time_ * rush_move;
+
+        const bool to_returning = exploring & at_finish;
+        const bool stopped = (rushing & rush_done) | crashed;
+        int next_state = state;
+        next_state = to_returning ? RETURNING : next_state;
+        next_state = returning & at_start ? RUSHING : next_state;
+        next_state = stopped ? STOPPED : next_state;
+        states_[slot] = next_state;
+        route_sizes_[slot] = to_returning ? stack_size : route_sizes_[slot];
+
+        moves.from[k] = position;
+        moves.exploreDir[k] = move & exploring ? dir : -1;
+        moves.stopped[k] = stopped;
+    }
+}
+
+#ifdef MAZEMOUSE_AVX2
+__attribute__((target("avx2"))) void BatchSimulation::stepBlockAvx2(
+    const int block, BlockMoves& moves) {
+    const int first = block * BATCH_LANES;
+    const int* const cells = &cells_[cellOf(first, 0)];
+    const std::uint8_t* const stacks = &stacks_[cellOf(first, 0)];
+
+    const auto zero = _mm256_setzero_si256();
+    const auto one = _mm256_set1_epi32(1);
+    const auto two = _mm256_set1_epi32(2);
+    const auto three = _mm256_set1_epi32(3);
+    const auto offsets = _mm256_setr_epi32(
+        offsets_[0], offsets_[1], offsets_[2], offsets_[3], offsets_[0],
+        offsets_[1], offsets_[2], offsets_[3]);
+
+    const auto state = loadSlots(states_, first);
+    const auto position = loadSlots(positions_, first);
+    const auto orientation = loadSlots(orientations_, first);
+    const auto open_mask = _mm256_and_si256(
+        gatherCells(cells, position), _mm256_set1_epi32(OPEN_BITS));
+    const auto exploring =
+        _mm256_cmpeq_epi32(state, _mm256_set1_epi32(EXPLORING));
+    const auto returning =
+        _mm256_cmpeq_epi32(state, _mm256_set1_epi32(RETURNING));
+    const auto rushing = _mm256_cmpeq_epi32(state, _mm256_set1_epi32(RUSHING));
+
+    // The least-visited rule of the portable kernel, for all slots at once
+    const auto behind = _mm256_sllv_epi32(
+        one, _mm256_and_si256(_mm256_add_epi32(orientation, two), three));
+    const auto first_move =
+        _mm256_cmpeq_epi32(loadSlots(exploration_cells_, first), zero);
+    const auto known_mask =
+        _mm256_andnot_si256(_mm256_and_si256(first_move, behind), open_mask);
+    auto explore_dir = orientation;
+    auto min_visited = _mm256_set1_epi32(INT_MAX);
+    for (int i = 0; i < 4; ++i) {
+        const auto dir = _mm256_and_si256(
+            _mm256_add_epi32(orientation, _mm256_set1_epi32(i)), three);
+        const auto open =
+            _mm256_and_si256(_mm256_srlv_epi32(known_mask, dir), one);
+        const auto neighbour = _mm256_add_epi32(
+            position,
+            _mm256_and_si256(
+                _mm256_permutevar8x32_epi32(offsets, dir),
+                _mm256_sub_epi32(zero, open)));
+        const auto visited = _mm256_or_si256(
+            _mm256_srli_epi32(gatherCells(cells, neighbour), VISIT_SHIFT),
+            _mm256_and_si256(
+                _mm256_sub_epi32(open, one), _mm256_set1_epi32(INT_MAX)));
+        const auto fewer = _mm256_cmpgt_epi32(min_visited, visited);
+        explore_dir = _mm256_blendv_epi8(explore_dir, dir, fewer);
+        min_visited = _mm256_min_epi32(min_visited, visited);
+    }
+
+    const auto stack_size = loadSlots(stack_sizes_, first);
+    const auto rush_step = loadSlots(rush_steps_, first);
+    const auto route_size = loadSlots(route_sizes_, first);
+    const auto return_dir = _mm256_and_si256(
+        _mm256_add_epi32(
+            gatherCellBytes(
+                stacks,
+                _mm256_max_epi32(_mm256_sub_epi32(stack_size, one), zero)),
+            two),
+        three);
+    const auto rush_dir = gatherCellBytes(
+        stacks, _mm256_min_epi32(rush_step, _mm256_set1_epi32(num_cells_ - 1)));
+
+    const auto at_finish = _mm256_cmpeq_epi32(
+        _mm256_i32gather_epi32(is_finish_.data(), position, 4), one);
+    const auto at_start =
+        _mm256_cmpeq_epi32(position, _mm256_set1_epi32(starting_index_));
+    const auto rush_done = _mm256_or_si256(
+        at_finish,
+        _mm256_cmpgt_epi32(_mm256_add_epi32(rush_step, one), route_size));
+    const auto stuck =
+        _mm256_or_si256(at_start, _mm256_cmpeq_epi32(stack_size, zero));
+    const auto move = _mm256_or_si256(
+        _mm256_andnot_si256(at_finish, exploring),
+        _mm256_or_si256(
+            _mm256_andnot_si256(stuck, returning),
+            _mm256_andnot_si256(rush_done, rushing)));
+    const auto dir = _mm256_blendv_epi8(
+        _mm256_blendv_epi8(rush_dir, return_dir, returning), explore_dir,
+        exploring);
+
+    // The masks are -1, so subtracting one counts it
+    const auto relative_dir =
+        _mm256_and_si256(_mm256_sub_epi32(dir, orientation), three);
+    const auto turned =
+        _mm256_andnot_si256(_mm256_cmpeq_epi32(relative_dir, zero), move);
+    storeSlots(
+        turns_, first, _mm256_sub_epi32(loadSlots(turns_, first), turned));
+    storeSlots(
+        orientations_, first, _mm256_blendv_epi8(orientation, dir, move));
+
+    const auto open = _mm256_cmpeq_epi32(
+        _mm256_and_si256(_mm256_srlv_epi32(open_mask, dir), one), one);
+    const auto crashed = _mm256_andnot_si256(open, move);
+    storeSlots(
+        positions_, first,
+        _mm256_add_epi32(
+            position,
+            _mm256_and_si256(
+                _mm256_permutevar8x32_epi32(offsets, dir),
+                _mm256_and_si256(move, open))));
+    storeSlots(
+        crashed_, first,
+        _mm256_or_si256(
+            loadSlots(crashed_, first), _mm256_and_si256(crashed, one)));
+
+    const auto explore_move = _mm256_and_si256(move, exploring);
+    const auto return_move = _mm256_and_si256(move, returning);
+    const auto rush_move = _mm256_and_si256(move, rushing);
+    storeSlots(
+        exploration_cells_, first,
+        _mm256_sub_epi32(loadSlots(exploration_cells_, first), explore_move));
+    storeSlots(
+        return_cells_, first,
+        _mm256_sub_epi32(loadSlots(return_cells_, first), return_move));
+    storeSlots(
+        rush_cells_, first,
+        _mm256_sub_epi32(loadSlots(rush_cells_, first), rush_move));
+    storeSlots(stack_sizes_, first, _mm256_add_epi32(stack_size, return_move));
+    storeSlots(rush_steps_, first, _mm256_sub_epi32(rush_step, rush_move));
+
+    // Four rush times per register, added in the order of the portable kernel
+    const __m128i halves_dir[2] = {
+        _mm256_castsi256_si128(relative_dir),
+        _mm256_extracti128_si256(relative_dir, 1),
+    };
+    const __m128i halves_move[2] = {
+        _mm256_castsi256_si128(rush_move),
+        _mm256_extracti128_si256(rush_move, 1),
+    };
+    for (int half = 0; half < 2; ++half) {
+        double* const times = rush_times_.data() + first + 4 * half;
+        const auto mask =
+            _mm256_castsi256_pd(_mm256_cvtepi32_epi64(halves_move[half]));
+        auto time = _mm256_loadu_pd(times);
+        time = _mm256_add_pd(
+            time,
+            _mm256_mask_i32gather_pd(
+                _mm256_setzero_pd(), turn_times_, halves_dir[half], mask, 8));
+        time = _mm256_add_pd(
+            time, _mm256_and_pd(_mm256_set1_pd(straight_time_), mask));
+        _mm256_storeu_pd(times, time);
+    }
+
+    const auto to_returning = _mm256_and_si256(exploring, at_finish);
+    const auto stopped =
+        _mm256_or_si256(_mm256_and_si256(rushing, rush_done), crashed);
+    auto next_state =
+        _mm256_blendv_epi8(state, _mm256_set1_epi32(RETURNING), to_returning);
+    next_state = _mm256_blendv_epi8(
+        next_state, _mm256_set1_epi32(RUSHING),
+        _mm256_and_si256(returning, at_start));
+    next_state =
+        _mm256_blendv_epi8(next_state, _mm256_set1_epi32(STOPPED), stopped);
+    storeSlots(states_, first, next_state);
+    storeSlots(
+        route_sizes_, first,
+        _mm256_blendv_epi8(route_size, stack_size, to_returning));
+
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(moves.from), position);
+    _mm256_storeu_si256(
+        reinterpret_cast<__m256i*>(moves.exploreDir),
+        _mm256_blendv_epi8(_mm256_set1_epi32(-1), dir, explore_move));
+    _mm256_storeu_si256(
+        reinterpret_cast<__m256i*>(moves.stopped),
+        _mm256_and_si256(stopped, one));
+}
+#endif
+
+void BatchSimulation::finishBlock(const int block, const BlockMoves& moves) {
+    for (int k = 0; k < BATCH_LANES; ++k) {
+        const int slot = block * BATCH_LANES + k;
+        if (const int dir = moves.exploreDir[k]; dir >= 0) {
+            const int position = moves.from[k];
+            const int open = cells_[cellOf(slot, position)] >> dir & 1;
+            const int next = position + (offsets_[dir] & -open);
+            auto& stack_size = stack_sizes_[slot];
+            if (cells_[cellOf(slot, next)] & ON_PATH) {
+                for (int cell = position; cell != next;) {
+                    cells_[cellOf(slot, cell)] &= ~ON_PATH;
+                    cell -= offsets_[stacks_[cellOf(slot, --stack_size)]];
+                }
+            } else {
+                cells_[cellOf(slot, next)] |= ON_PATH;
+                stacks_[cellOf(slot, stack_size++)] =
+                    static_cast<std::uint8_t>(dir);
+            }
+            cells_[cellOf(slot, next)] += open << VISIT_SHIFT;
+        }
+
+        // The step is counted once every block has run it
+        const int lane = slot_lanes_[slot];
+        if (lane >= 0 && (moves.stopped[k] ||
+                          num_steps_ + 1 - start_steps_[slot] >= max_cycles_)) {
+            results_[lane] = slotMetrics(slot);
+            ++results_[lane].cycles;
+            lane_slots_[lane] = -1;
+            slot_lanes_[slot] = -1;
+            states_[slot] = STOPPED;
+            --num_running_;
+            if (next_lane_ < num_lanes_) {
+                // The new lane first runs in the next step
+                startLane(slot);
+                ++start_steps_[slot];
+            }
+        }
+    }
+}
+
+void BatchSimulation::compact() {
+    int free_slot = 0;
+    while (num_active_blocks_ > 0 &&
+           num_running_ <= (num_active_blocks_ - 1) * BATCH_LANES) {
+        // The earlier blocks have a free slot for every lane of the last one
+        const int last = num_active_blocks_ - 1;
+        for (int slot = last * BATCH_LANES; slot < num_active_blocks_ *
+                                                       BATCH_LANES;
+             ++slot) {
+            if (slot_lanes_[slot] < 0) {
+                continue;
+            }
+            while (slot_lanes_[free_slot] >= 0) {
+                ++free_slot;
+            }
+            moveSlot(slot, free_slot);
+        }
+        --num_active_blocks_;
+    }
+}
+
+void BatchSimulation::moveSlot(const int from, const int to) {
+    for (auto* values :
+         { &positions_, &orientations_, &states_, &stack_sizes_,
+           &route_sizes_, &rush_steps_, &exploration_cells_, &return_cells_,
+           &rush_cells_, &turns_, &crashed_ }) {
+        (*values)[to] = (*values)[from];
+    }
+    rush_times_[to] = rush_times_[from];
+    start_steps_[to] = start_steps_[from];
+    for (int cell = 0; cell < num_cells_; ++cell) {
+        cells_[cellOf(to, cell)] = cells_[cellOf(from, cell)];
+        stacks_[cellOf(to, cell)] = stacks_[cellOf(from, cell)];
+    }
+
+    const int lane = slot_lanes_[from];
+    slot_lanes_[to] = lane;
+    lane_slots_[lane] = to;
+    slot_lanes_[from] = -1;
+    states_[from] = STOPPED;
+}
+
+}  // namespace Mazemouse
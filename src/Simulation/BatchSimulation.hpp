@@ -0,0 +1,338 @@
+#ifndef BATCH_SIMULATION_HPP
+#define BATCH_SIMULATION_HPP
+
+#include <cstdint>
+#include <vector>
+#include "../Maze/BitFlood.hpp"
+#include "../Maze/WallBitboard.hpp"
+#include "Simulation.hpp"
+
+namespace Mazemouse {
+
+/**
+ * The number of lanes a `BatchSimulation` steps together: eight 32-bit
+ * values, one AVX2 register.
+ */
+constexpr int BATCH_LANES = 8;
+
+/**
+ * The most blocks of slots a `BatchSimulation` steps at once. A few blocks
+ * hide the latency of each other's gathers, while their cells still fit in
+ * the first levels of the cache.
+ */
+constexpr int BATCH_MAX_BLOCKS = 4;
+
+/**
+ * @brief Runs the least-visited `FloodFillMouse` in many mazes of the same
+ * size at once, one cycle of every mouse in a slot per step.
+ *
+ * Every maze is a lane. The lanes run in slots grouped into at most
+ * `BATCH_MAX_BLOCKS` blocks of `BATCH_LANES`, and a lane waits until a slot
+ * is free, so the data stepped over and over stays in the cache however many
+ * lanes there are. The state of the mice is kept as a structure of arrays in
+ * which the slot is the minor index: the positions, orientations, states and
+ * metrics of a block are `BATCH_LANES` consecutive values, and so are the
+ * per-cell data of a block (the open directions of the real mazes, the visit
+ * counts and the route stacks) for every cell. A step runs one cycle of
+ * every slot of a block at once with the same decision rules as
+ * `FloodFillMouse::exploreNext()`,
+ * `FloodFillMouse::returnAlongOriginalRoute()` and
+ * `FloodFillMouse::nextRushingCycle()`. Every slot computes the move of each
+ * state and keeps the one of its own state with selects, so lanes in
+ * different states share the kernel without branches. On CPUs with AVX2,
+ * the whole block is one vector: the wall lookups and the visit counts of
+ * the least-visited rule are gathers, and the counters and positions are
+ * updated with vector arithmetic. Other CPUs run a portable kernel with the
+ * same results. Only the route stack, whose loops unwind by a data-dependent
+ * number of cells, is updated slot by slot afterwards.
+ *
+ * When a lane stops, the next waiting lane starts in its slot. Once no lane
+ * waits, the running lanes of the last blocks are moved into the slots of
+ * stopped lanes in earlier blocks after every step, and only
+ * `ceil(numRunning() / BATCH_LANES)` blocks are stepped. Every lane moves at
+ * most a few times over a run.
+ *
+ * The real walls are read directly instead of through the virtual
+ * `MouseHardwareInterface`, without a `Maze` of `Edge` objects per mouse.
+ * The metrics of every lane are identical to those of a
+ * `Simulation<FloodFillMouse>` in `ExplorationMode::LeastVisited`, except
+ * for `simulatedTime`, which is not kept.
+ *
+ * The least-visited rule only looks at the edges of the current cell, which
+ * the mouse has either just sensed or just come through, so a lane needs no
+ * memory of the walls it has learned.
+ */
+class BatchSimulation {
+ public:
+    /**
+     * @brief Creates one lane per real maze, every mouse exploring from the
+     * same starting cell.
+     *
+     * @throws std::invalid_argument if the mazes differ in size.
+     */
+    BatchSimulation(
+        const std::vector<SimulationMaze>& realMazes, Vector2 startingPosition,
+        Dir4 startingOrientation);
+
+    [[nodiscard]] int numLanes() const { return num_lanes_; }
+
+    /**
+     * @brief Returns the number of lanes that have not stopped yet.
+     */
+    [[nodiscard]] int numRunning() const { return num_running_; }
+
+    [[nodiscard]] const MotionProfile& getMotionProfile() const {
+        return motion_profile_;
+    }
+
+    /**
+     * @brief Sets the motion profile used to estimate `rushTime`.
+     *
+     * @throws std::invalid_argument if the profile is not valid; see
+     * `MotionProfile::validate()`.
+     */
+    void setMotionProfile(const MotionProfile& motionProfile);
+
+    /**
+     * @brief Chooses the AVX2 kernel if the CPU supports it (the default),
+     * or the portable kernel. Both give the same metrics.
+     */
+    void setUseAvx2(const bool useAvx2) { use_avx2_ = useAvx2; }
+
+    /**
+     * @brief Runs every lane until it stops or has run `maxCycles` cycles.
+     */
+    void run(long maxCycles = SIMULATION_MAX_CYCLES);
+
+    /**
+     * @brief Returns the metrics of a lane.
+     */
+    [[nodiscard]] SimulationMetrics getMetrics(int lane) const;
+
+    /**
+     * @brief Returns the metrics of every lane, in lane order.
+     */
+    [[nodiscard]] std::vector<SimulationMetrics> getAllMetrics() const;
+
+ private:
+    /**
+     * @brief What a step did to the slots of a block, for the slot by slot
+     * part of the step.
+     */
+    struct BlockMoves {
+        /**
+         * The cell each slot was in before the step.
+         */
+        int from[BATCH_LANES];
+
+        /**
+         * The absolute direction of an exploring move, or -1 if the slot did
+         * not explore.
+         */
+        int exploreDir[BATCH_LANES];
+
+        /**
+         * 1 if the lane in the slot stopped during the step.
+         */
+        int stopped[BATCH_LANES];
+    };
+
+    /**
+     * The bits of a cell word that hold the open directions.
+     */
+    static constexpr int OPEN_BITS = 0xF;
+
+    static constexpr int ON_PATH = 1 << 4;
+
+    /**
+     * The visit count sits above this bit, which leaves room for 2^26 visits
+     * of a cell.
+     */
+    static constexpr int VISIT_SHIFT = 5;
+
+    int num_lanes_;
+
+    int num_cells_;
+
+    int starting_index_;
+
+    int starting_orientation_{ 0 };
+
+    int num_running_;
+
+    /**
+     * The first lane that has not started yet.
+     */
+    int next_lane_;
+
+    /**
+     * The number of blocks from the first one that hold running lanes.
+     */
+    int num_active_blocks_;
+
+    /**
+     * The number of steps run so far.
+     */
+    long num_steps_{ 0 };
+
+    /**
+     * The cycle limit of every lane in the current `run()`.
+     */
+    long max_cycles_{ SIMULATION_MAX_CYCLES };
+
+    bool use_avx2_{ true };
+
+    /**
+     * The index offset of the neighbour towards every direction.
+     */
+    int offsets_[4];
+
+    MotionProfile motion_profile_{};
+
+    /**
+     * `motion_profile_.turnTimeTo()` of every relative direction.
+     */
+    double turn_times_[4];
+
+    /**
+     * `motion_profile_.straightTime(1)`, the time of every rushing move.
+     */
+    double straight_time_;
+
+    /**
+     * Indexed by cell: 1 for the finishing cells.
+     */
+    std::vector<int> is_finish_;
+
+    /**
+     * Indexed by `lane * num_cells_ + cell`: the open directions of the real
+     * mazes, copied into the slot of a lane when it starts.
+     */
+    std::vector<std::uint8_t> open_masks_;
+
+    /**
+     * Indexed by `cellOf(slot, cell)`: the open directions of the real maze
+     * (`OPEN_BITS`), whether the cell is on the route stack (`ON_PATH`) and
+     * the number of visits (above `VISIT_SHIFT`).
+     */
+    std::vector<int> cells_;
+
+    /**
+     * Indexed by `cellOf(slot, i)`: entry `i` of the route stack, a path
+     * without repeated cells, followed by 3 bytes of padding for 32-bit
+     * gathers. Returning to the start only lowers `stack_sizes_`, so the
+     * route to the finish stays in place for the rush.
+     */
+    std::vector<std::uint8_t> stacks_;
+
+    /**
+     * The per-slot data below is indexed by slot, `block * BATCH_LANES + k`
+     * for the `k`th slot of a block.
+     *
+     * The lane in every slot, or -1 for a free one.
+     */
+    std::vector<int> slot_lanes_;
+
+    std::vector<int> positions_;
+
+    std::vector<int> orientations_;
+
+    /**
+     * The `MouseState` of the lane; free slots are stopped.
+     */
+    std::vector<int> states_;
+
+    /**
+     * The step the lane started at.
+     */
+    std::vector<long> start_steps_;
+
+    std::vector<int> stack_sizes_;
+
+    std::vector<int> route_sizes_;
+
+    std::vector<int> rush_steps_;
+
+    std::vector<int> exploration_cells_;
+
+    std::vector<int> return_cells_;
+
+    std::vector<int> rush_cells_;
+
+    std::vector<int> turns_;
+
+    std::vector<double> rush_times_;
+
+    std::vector<int> crashed_;
+
+    /**
+     * Indexed by lane: the slot of a running lane, or -1 once it stopped.
+     */
+    std::vector<int> lane_slots_;
+
+    /**
+     * Indexed by lane: the metrics of a stopped lane.
+     */
+    std::vector<SimulationMetrics> results_;
+
+    /**
+     * @brief Returns the index of the data of a cell for a slot.
+     */
+    [[nodiscard]] std::size_t cellOf(const int slot, const int cell) const {
+        return (static_cast<std::size_t>(slot / BATCH_LANES) * num_cells_ +
+                cell) *
+                   BATCH_LANES +
+               slot % BATCH_LANES;
+    }
+
+    [[nodiscard]] SimulationMetrics slotMetrics(int slot) const;
+
+    /**
+     * @brief Advances every lane in a slot by one cycle.
+     *
+     * @return True if a lane is still running, false once all have stopped.
+     */
+    bool step();
+
+    /**
+     * @brief Starts the next waiting lane in a free slot.
+     */
+    void startLane(int slot);
+
+    /**
+     * @brief Runs one cycle of every slot of a block, except for the route
+     * stacks, and records what happened for `finishBlock()`.
+     */
+    void stepBlock(int block, BlockMoves& moves);
+
+#ifdef MAZEMOUSE_AVX2
+    /**
+     * @brief `stepBlock()` with the block held in AVX2 registers.
+     */
+    __attribute__((target("avx2"))) void stepBlockAvx2(
+        int block, BlockMoves& moves);
+#endif
+
+    /**
+     * @brief Updates the route stacks and the visit counts after the
+     * exploring moves of a block, and passes the slots of lanes that stopped
+     * or reached the cycle limit on to waiting lanes.
+     *
+     * Moving into a cell on the stack unwinds the stack back to it, as in
+     * `FloodFillMouse::advance()`. A blocked move stays in the current cell,
+     * which unwinds nothing before the mouse crashes.
+     */
+    void finishBlock(int block, const BlockMoves& moves);
+
+    /**
+     * @brief Moves the running lanes of the last active blocks into free
+     * slots of earlier blocks while they fit.
+     */
+    void compact();
+
+    void moveSlot(int from, int to);
+};
+
+}  // namespace Mazemouse
+
+#endif
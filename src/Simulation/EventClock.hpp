@@ -0,0 +1,209 @@
+#ifndef EVENT_CLOCK_HPP
+#define EVENT_CLOCK_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <queue>
+#include <utility>
+#include <vector>
+
+namespace Mazemouse {
+
+/**
+ * The number of events an `EventClock` makes room for on construction. A
+ * mouse cycle schedules a handful of sensor reads and motions, so the queue
+ * never has to grow while a mouse runs.
+ */
+constexpr int EVENT_CLOCK_INITIAL_CAPACITY = 16;
+
+/**
+ * @brief The things that take time while a mouse runs.
+ */
+enum class SimulationEvent : std::uint8_t {
+    // A wall sensor has been read
+    SensorRead,
+
+    // The planner of a cycle has finished computing
+    PlannerDone,
+
+    // A movement or turn has been completed
+    MotionComplete
+};
+
+/**
+ * @brief An event at its finish time. Events at the same time fire in the
+ * order they were scheduled.
+ */
+struct ScheduledEvent {
+    double time{ 0 };
+
+    long sequence{ 0 };
+
+    SimulationEvent event{ SimulationEvent::MotionComplete };
+
+    [[nodiscard]] bool operator>(const ScheduledEvent& other) const {
+        return time > other.time ||
+               (time == other.time && sequence > other.sequence);
+    }
+};
+
+/**
+ * @brief The time the mouse spends other than moving, in seconds.
+ */
+struct EventTiming {
+    /**
+     * The time of reading one wall sensor.
+     */
+    double sensorReadTime{ 0.0005 };
+
+    /**
+     * The time the planner computes in every cycle.
+     */
+    double plannerTime{ 0.002 };
+};
+
+/**
+ * @brief A discrete-event clock for a simulated mouse.
+ *
+ * Hardware calls do not wait for the hardware; they schedule an event at the
+ * time the sensor read, the computation or the motion would finish. The
+ * mouse does one thing at a time, so every event is scheduled after the
+ * previous one. `runUntil()` and `runAll()` then jump the clock from event to
+ * event instead of ticking through the time in between, so the simulated
+ * time is exact however coarsely the clock is advanced.
+ *
+ * The planner of a cycle is scheduled just before its first motion, after
+ * the sensor reads it decides on, or at the end of a cycle without motions.
+ */
+class EventClock {
+ public:
+    EventTiming timing{};
+
+    EventClock() {
+        std::vector<ScheduledEvent> events;
+        events.reserve(EVENT_CLOCK_INITIAL_CAPACITY);
+        events_ = Queue({}, std::move(events));
+    }
+
+    /**
+     * @brief Returns the current simulated time in seconds.
+     */
+    [[nodiscard]] double now() const { return now_; }
+
+    [[nodiscard]] bool empty() const { return events_.empty(); }
+
+    /**
+     * @brief Returns the time of the next event; the clock must not be
+     * empty.
+     */
+    [[nodiscard]] double nextTime() const { return events_.top().time; }
+
+    /**
+     * @brief Returns the time the last scheduled event finishes, or now if
+     * it has already fired.
+     */
+    [[nodiscard]] double busyUntil() const { return std::max(now_, last_); }
+
+    /**
+     * @brief Schedules an event `duration` seconds after the last scheduled
+     * event.
+     *
+     * @return The time of the event.
+     */
+    double scheduleNext(const SimulationEvent event, const double duration) {
+        last_ = busyUntil() + duration;
+        events_.push({ last_, next_sequence_++, event });
+
+        return last_;
+    }
+
+    /**
+     * @brief Schedules a sensor read.
+     */
+    void sensorRead() {
+        scheduleNext(SimulationEvent::SensorRead, timing.sensorReadTime);
+    }
+
+    /**
+     * @brief Schedules a motion, after the planner of the cycle.
+     *
+     * @return The time the motion finishes.
+     */
+    double motion(const double duration) {
+        schedulePlanner();
+        return scheduleNext(SimulationEvent::MotionComplete, duration);
+    }
+
+    /**
+     * @brief Ends a cycle, scheduling its planner if no motion has.
+     */
+    void endCycle() {
+        schedulePlanner();
+        planned_ = false;
+    }
+
+    /**
+     * @brief Fires every event up to the given time in order, then moves the
+     * clock to that time.
+     *
+     * @param time The time to run until, in seconds.
+     * @param handler Called with every event, after the clock has jumped to
+     * it; it may schedule more events.
+     */
+    template <typename Handler>
+    void runUntil(const double time, Handler handler) {
+        while (!events_.empty() && events_.top().time <= time) {
+            handler(pop());
+        }
+        now_ = std::max(now_, time);
+    }
+
+    /**
+     * @brief Fires every event in order, jumping the clock to the last one.
+     */
+    template <typename Handler>
+    void runAll(Handler handler) {
+        while (!events_.empty()) {
+            handler(pop());
+        }
+    }
+
+    void runAll() {
+        runAll([](const ScheduledEvent&) {});
+    }
+
+ private:
+    using Queue = std::priority_queue<
+        ScheduledEvent, std::vector<ScheduledEvent>,
+        std::greater<ScheduledEvent>>;
+
+    Queue events_;
+
+    double now_{ 0 };
+
+    double last_{ 0 };
+
+    long next_sequence_{ 0 };
+
+    bool planned_{ false };
+
+    ScheduledEvent pop() {
+        const auto event = events_.top();
+        events_.pop();
+        now_ = event.time;
+
+        return event;
+    }
+
+    void schedulePlanner() {
+        if (!planned_) {
+            scheduleNext(SimulationEvent::PlannerDone, timing.plannerTime);
+            planned_ = true;
+        }
+    }
+};
+
+}  // namespace Mazemouse
+
+#endif
@@ -0,0 +1,95 @@
+#include "LiveSimulation.hpp"
+#include <algorithm>
+#include <chrono>
+
+namespace Mazemouse {
+
+namespace {
+
+SimulationSnapshot snapshotOf(const AnySimulation& simulation) {
+    SimulationSnapshot snapshot;
+    simulation.snapshot(snapshot);
+
+    return snapshot;
+}
+
+}  // namespace
+
+LiveSimulation::LiveSimulation(
+    std::string label, std::unique_ptr<AnySimulation> simulation,
+    const double timeScale) :
+    label_(std::move(label)), simulation_(std::move(simulation)),
+    // Every slot gets its trail storage before the worker starts
+    snapshots_(snapshotOf(*simulation_)), time_scale_(timeScale) {
+    worker_ = std::thread([this] { run(); });
+}
+
+LiveSimulation::~LiveSimulation() {
+    stop();
+    if (worker_.joinable()) {
+        worker_.join();
+    }
+}
+
+void LiveSimulation::run() {
+    using Clock = std::chrono::steady_clock;
+
+    // The real and simulated time at which the current time scale took
+    // effect
+    auto anchor_real = Clock::now();
+    double anchor_simulated = 0;
+    double anchor_scale = time_scale_.load(std::memory_order_relaxed);
+    auto last_publish = Clock::now();
+
+    bool running = true;
+    while (running && !stopping_.load(std::memory_order_relaxed)) {
+        running = simulation_->step();
+        const double simulated = simulation_->simulatedTime();
+
+        const double scale = time_scale_.load(std::memory_order_relaxed);
+        if (scale != anchor_scale) {
+            anchor_real = Clock::now();
+            anchor_simulated = simulated;
+            anchor_scale = scale;
+        }
+
+        if (scale == LIVE_UNLIMITED_TIME_SCALE) {
+            // Snapshots are only taken and published as often as anyone can
+            // watch
+            const auto now = Clock::now();
+            if (!running ||
+                now - last_publish >=
+                    std::chrono::microseconds(LIVE_SNAPSHOT_INTERVAL_US)) {
+                simulation_->snapshot(snapshots_.back());
+                publish();
+                last_publish = now;
+            }
+            continue;
+        }
+
+        // Wait until the cycle has finished in scaled real time
+        simulation_->snapshot(snapshots_.back());
+        publish();
+        const auto finish =
+            anchor_real +
+            std::chrono::duration_cast<Clock::duration>(
+                std::chrono::duration<double>(
+                    (simulated - anchor_simulated) / scale));
+        while (!stopping_.load(std::memory_order_relaxed) &&
+               time_scale_.load(std::memory_order_relaxed) == scale &&
+               Clock::now() < finish) {
+            std::this_thread::sleep_until(std::min(
+                finish,
+                Clock::now() + std::chrono::milliseconds(LIVE_MAX_SLEEP_MS)));
+        }
+    }
+
+    done_.store(true, std::memory_order_release);
+}
+
+void LiveSimulation::publish() {
+    snapshots_.back().sequence = num_published_++;
+    snapshots_.publish();
+}
+
+}  // namespace Mazemouse
@@ -0,0 +1,219 @@
+#ifndef LIVE_SIMULATION_HPP
+#define LIVE_SIMULATION_HPP
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "Simulation.hpp"
+#include "TripleBuffer.hpp"
+
+namespace Mazemouse {
+
+/**
+ * The shortest real time between two snapshots of an unpaced live
+ * simulation, in microseconds.
+ */
+constexpr int LIVE_SNAPSHOT_INTERVAL_US = 1000;
+
+/**
+ * The longest a paced live simulation sleeps before it checks whether it has
+ * been stopped or its time scale has changed, in milliseconds.
+ */
+constexpr int LIVE_MAX_SLEEP_MS = 20;
+
+/**
+ * The time scale at which a live simulation runs as fast as it can.
+ */
+constexpr double LIVE_UNLIMITED_TIME_SCALE = 0;
+
+/**
+ * @brief The state of a running simulation at the end of a cycle.
+ */
+struct SimulationSnapshot {
+    Vector2 position{ 0, 0 };
+
+    Dir4 orientation{ Dir4::Up };
+
+    MouseState state{ MouseState::Stopped };
+
+    SimulationMetrics metrics{};
+
+    /**
+     * The number of times the mouse has traveled through every edge of the
+     * real maze, indexed like `Maze::edges`.
+     */
+    std::vector<int> numTraveled{};
+
+    /**
+     * The number of snapshots published before this one.
+     */
+    long sequence{ 0 };
+};
+
+/**
+ * @brief A simulation of any mouse type, as a live simulation drives it.
+ */
+class AnySimulation {
+ public:
+    virtual ~AnySimulation() = default;
+
+    /**
+     * @brief Advances the mouse by one cycle.
+     *
+     * @return True if the mouse is still running, false once it has stopped.
+     */
+    virtual bool step() = 0;
+
+    /**
+     * @brief Returns the simulated time of the run so far.
+     */
+    [[nodiscard]] virtual double simulatedTime() const = 0;
+
+    /**
+     * @brief Writes the current state into a snapshot, reusing its storage.
+     */
+    virtual void snapshot(SimulationSnapshot& snapshot) const = 0;
+};
+
+/**
+ * @brief Adapts a `Simulation` to `AnySimulation`.
+ *
+ * @tparam M The mouse type of the simulation.
+ */
+template <typename M>
+class AnySimulationOf final : public AnySimulation {
+ public:
+    template <typename... Args>
+    explicit AnySimulationOf(Args&&... args) :
+        simulation_(std::forward<Args>(args)...) {
+        simulation_.start();
+    }
+
+    bool step() override { return simulation_.step(); }
+
+    [[nodiscard]] double simulatedTime() const override {
+        return simulation_.getMetrics().simulatedTime;
+    }
+
+    void snapshot(SimulationSnapshot& snapshot) const override;
+
+    Simulation<M>& getSimulation() { return simulation_; }
+
+ private:
+    Simulation<M> simulation_;
+};
+
+template <typename M>
+void AnySimulationOf<M>::snapshot(SimulationSnapshot& snapshot) const {
+    snapshot.position = simulation_.position;
+    snapshot.orientation = simulation_.orientation;
+    snapshot.state = simulation_.state;
+    snapshot.metrics = simulation_.getMetrics();
+
+    const auto& real_maze = simulation_.getRealMaze();
+    snapshot.numTraveled.resize(real_maze.numEdges());
+    for (int i = 0; i < real_maze.numEdges(); ++i) {
+        snapshot.numTraveled[i] = real_maze.edges[i].num_traveled;
+    }
+}
+
+/**
+ * @brief Creates the simulation of a mouse in a real maze.
+ */
+using SimulationFactory =
+    std::function<std::unique_ptr<AnySimulation>(const SimulationMaze&)>;
+
+/**
+ * @brief Runs a simulation on a worker thread of its own and publishes its
+ * state for a render thread to watch.
+ *
+ * The worker paces the mouse so that the simulated time of the run, from the
+ * event clock of the simulation, passes at the time scale, and publishes a
+ * snapshot after every cycle through a `TripleBuffer`; an unlimited run only
+ * takes and publishes one every `LIVE_SNAPSHOT_INTERVAL_US`. The render
+ * thread reads the latest snapshot with `latest()`, which never blocks the
+ * worker.
+ */
+class LiveSimulation {
+ public:
+    /**
+     * @brief Creates a live simulation and starts its worker.
+     *
+     * @param label The name shown for the run.
+     * @param simulation The simulation to run; its mouse must be started.
+     * @param timeScale The simulated seconds per real second, or
+     * `LIVE_UNLIMITED_TIME_SCALE`.
+     */
+    LiveSimulation(
+        std::string label, std::unique_ptr<AnySimulation> simulation,
+        double timeScale = 1);
+
+    LiveSimulation(const LiveSimulation&) = delete;
+
+    LiveSimulation& operator=(const LiveSimulation&) = delete;
+
+    /**
+     * @brief Stops the worker and waits for it.
+     */
+    ~LiveSimulation();
+
+    [[nodiscard]] const std::string& getLabel() const { return label_; }
+
+    /**
+     * @brief Returns the latest snapshot. Render thread only; the reference
+     * stays valid until the next call.
+     */
+    const SimulationSnapshot& latest() { return snapshots_.read(); }
+
+    /**
+     * @brief Returns whether a snapshot has been published since the last
+     * call to `latest()`.
+     */
+    [[nodiscard]] bool hasFresh() const { return snapshots_.hasFresh(); }
+
+    void setTimeScale(const double timeScale) {
+        time_scale_.store(timeScale, std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] bool isDone() const {
+        return done_.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief Asks the worker to stop after its current cycle.
+     */
+    void stop() { stopping_.store(true, std::memory_order_relaxed); }
+
+ private:
+    std::string label_;
+
+    std::unique_ptr<AnySimulation> simulation_;
+
+    TripleBuffer<SimulationSnapshot> snapshots_;
+
+    std::atomic<double> time_scale_;
+
+    std::atomic<bool> stopping_{ false };
+
+    std::atomic<bool> done_{ false };
+
+    long num_published_{ 0 };
+
+    std::thread worker_;
+
+    /**
+     * @brief Runs the simulation until the mouse stops or the simulation is
+     * stopped.
+     */
+    void run();
+
+    void publish();
+};
+
+}  // namespace Mazemouse
+
+#endif
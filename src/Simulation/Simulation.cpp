@@ -0,0 +1,32 @@
+#include "Simulation.hpp"
+
+namespace Mazemouse {
+
+std::string toString(const MouseState state) {
+    switch (state) {
+        case MouseState::Stopped:
+            return "STOPPED";
+        case MouseState::Exploring:
+            return "EXPLORING";
+        case MouseState::ReturningToStart:
+            return "RETURNING TO START";
+        case MouseState::RushingToFinish:
+            return "RUSHING TO FINISH";
+    }
+    return "";
+}
+
+std::ostream& operator<<(std::ostream& os, const SimulationMetrics& metrics) {
+    return os << "cycles=" << metrics.cycles
+              << " exploration_cells=" << metrics.explorationCells
+              << " return_cells=" << metrics.returnCells
+              << " rush_cells=" << metrics.rushCells
+              << " rush_moves=" << metrics.rushMoves
+              << " turns=" << metrics.turns
+              << " rush_time=" << metrics.rushTime
+              << " simulated_time=" << metrics.simulatedTime
+              << " crashed=" << metrics.crashed
+              << " finished=" << metrics.finished;
+}
+
+}  // namespace Mazemouse
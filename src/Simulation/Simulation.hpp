@@ -0,0 +1,356 @@
+#ifndef SIMULATION_HPP
+#define SIMULATION_HPP
+
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include "../Maze/Maze.hpp"
+#include "../Mouse/MotionProfile.hpp"
+#include "../Mouse/Mouse.hpp"
+#include "EventClock.hpp"
+
+namespace Mazemouse {
+
+/**
+ * The default number of cycles after which a simulation gives up.
+ */
+constexpr long SIMULATION_MAX_CYCLES = 1'000'000;
+
+/**
+ * Represents an edge of the real maze, which also records how many times the
+ * mouse has traveled through it.
+ */
+struct SimulationEdge : Edge {
+    mutable int num_traveled{ 0 };
+};
+
+/**
+ * The real maze a simulated mouse runs in. It is runtime-sized so that one
+ * binary can simulate any maze size.
+ */
+using SimulationMaze = Maze<DYNAMIC_SIZE, Cell, SimulationEdge>;
+
+/**
+ * @brief Counters collected while a simulation runs.
+ */
+struct SimulationMetrics {
+    /**
+     * The number of exploring and rushing cycles executed.
+     */
+    long cycles{ 0 };
+
+    /**
+     * The number of cells moved while exploring.
+     */
+    int explorationCells{ 0 };
+
+    /**
+     * The number of cells moved while returning to the starting cell.
+     */
+    int returnCells{ 0 };
+
+    /**
+     * The number of cells moved while rushing to the finish.
+     */
+    int rushCells{ 0 };
+
+    /**
+     * The number of `moveForward()` calls and moving motion primitives while
+     * rushing to the finish.
+     */
+    int rushMoves{ 0 };
+
+    /**
+     * The number of turns, excluding turns that keep the orientation. A
+     * diagonal counts as two.
+     */
+    int turns{ 0 };
+
+    /**
+     * The time of the rush to the finish in seconds, estimated with the
+     * simulation's motion profile. Motion primitives bring their own
+     * duration, computed with the profile of the mouse.
+     */
+    double rushTime{ 0 };
+
+    /**
+     * The simulated time of the whole run in seconds, from the event clock:
+     * every motion, sensor read and planner computation, moves estimated
+     * with the simulation's motion profile.
+     */
+    double simulatedTime{ 0 };
+
+    /**
+     * True if the mouse tried to move through a wall of the real maze.
+     */
+    bool crashed{ false };
+
+    /**
+     * True if the mouse stopped by itself before the cycle limit.
+     */
+    bool finished{ false };
+};
+
+/**
+ * @brief Returns the display name of a mouse state, e.g. "EXPLORING".
+ */
+std::string toString(MouseState state);
+
+std::ostream& operator<<(std::ostream& os, const SimulationMetrics& metrics);
+
+/**
+ * @brief Runs a mouse in a real maze without any rendering.
+ *
+ * The simulation implements the `MouseHardwareInterface` of the given mouse
+ * type against a real maze: wall checks read the real maze, and movements are
+ * validated against it and applied instantly. `step()` advances the mouse by
+ * one cycle of its state machine (`Exploring`, then `ReturningToStart`, then
+ * `RushingToFinish`), so a whole run takes only as long as the mouse's own
+ * computation.
+ *
+ * Meanwhile, every hardware call schedules an event on an `EventClock` at the
+ * time it would finish on a real mouse, and each cycle jumps the clock
+ * through its events. `SimulationMetrics::simulatedTime` is thus the exact
+ * time of the run under the motion profile and the `EventTiming`.
+ *
+ * A mouse type with the `StaticHardware` argument, such as
+ * `FloodFillMouse<16, FloodFillCell, Edge, StaticHardware>`, is bound to the
+ * simulation at compile time: every hardware call of a cycle is resolved
+ * statically and can be inlined. Any other mouse type implements the virtual
+ * `MouseHardwareInterface` through the simulation.
+ *
+ * @tparam M The mouse type to simulate. It must derive from `Mouse` and
+ * implement everything except the hardware interface.
+ */
+template <typename M>
+class Simulation final : public WithHardware<M, Simulation<M>>::type {
+ public:
+    using MouseType = typename WithHardware<M, Simulation<M>>::type;
+
+    /**
+     * @brief Creates a simulation of a mouse in the given real maze.
+     *
+     * @param realMaze The real maze; it must have the same dimensions as the
+     * maze in the mouse's memory.
+     * @param args The arguments forwarded to the constructor of the mouse.
+     * @throws std::invalid_argument if the dimensions of the mazes differ.
+     */
+    template <typename... Args>
+    explicit Simulation(SimulationMaze realMaze, Args&&... args);
+
+    // Not marked `override`, since a statically bound mouse has no virtual
+    // hardware functions
+    bool hardwareCheckWall(Dir4 dir);
+
+    void hardwareMoveForward(int step);
+
+    void hardwareTurn(Dir4 relative_dir);
+
+    void hardwareRunPrimitive(const MotionPrimitive& primitive);
+
+    /**
+     * @brief Puts the mouse into the exploring state.
+     */
+    void start();
+
+    /**
+     * @brief Advances the mouse by one cycle.
+     *
+     * @return True if the mouse is still running, false once it has stopped.
+     */
+    bool step();
+
+    /**
+     * @brief Runs the mouse until it stops or the cycle limit is reached.
+     *
+     * The mouse is started first if it has not run yet.
+     *
+     * @param maxCycles The maximum number of cycles to execute.
+     * @return The metrics of the run.
+     */
+    SimulationMetrics run(long maxCycles = SIMULATION_MAX_CYCLES);
+
+    [[nodiscard]] const SimulationMetrics& getMetrics() const {
+        return metrics_;
+    }
+
+    [[nodiscard]] const SimulationMaze& getRealMaze() const {
+        return realMaze_;
+    }
+
+    [[nodiscard]] const MotionProfile& getMotionProfile() const {
+        return motionProfile_;
+    }
+
+    /**
+     * @brief Sets the motion profile used to estimate `rushTime`.
+     *
+     * @throws std::invalid_argument if the profile is not valid; see
+     * `MotionProfile::validate()`.
+     */
+    void setMotionProfile(const MotionProfile& motionProfile) {
+        motionProfile.validate();
+        motionProfile_ = motionProfile;
+    }
+
+    [[nodiscard]] const EventClock& getClock() const { return clock_; }
+
+    /**
+     * @brief Sets the sensor and planner times of the event clock.
+     */
+    void setEventTiming(const EventTiming& timing) { clock_.timing = timing; }
+
+ private:
+    SimulationMaze realMaze_;
+
+    MotionProfile motionProfile_{};
+
+    SimulationMetrics metrics_{};
+
+    EventClock clock_{};
+};
+
+template <typename M>
+template <typename... Args>
+Simulation<M>::Simulation(SimulationMaze realMaze, Args&&... args) :
+    MouseType(std::forward<Args>(args)...), realMaze_(std::move(realMaze)) {
+    if (realMaze_.width() != this->maze.width() ||
+        realMaze_.height() != this->maze.height()) {
+        throw std::invalid_argument(
+            "Simulation(): the real maze and the mouse's maze differ in size");
+    }
+}
+
+template <typename M>
+bool Simulation<M>::hardwareCheckWall(const Dir4 dir) {
+    clock_.sensorRead();
+    return !realMaze_.isOpenAt(
+        realMaze_.cellIndex(this->position), this->getAbsoluteDir(dir));
+}
+
+template <typename M>
+void Simulation<M>::hardwareMoveForward(const int step) {
+    auto index = realMaze_.cellIndex(this->position);
+    for (int i = 0; i < step; ++i) {
+        const auto& edge = realMaze_.edgeAt(index, this->orientation);
+        if (edge.hasWall) {
+            metrics_.crashed = true;
+            break;
+        }
+        ++edge.num_traveled;
+        index = realMaze_.neighbourIndex(index, this->orientation);
+    }
+    const double time = motionProfile_.straightTime(step);
+    clock_.motion(time);
+
+    switch (this->state) {
+        case MouseState::Exploring:
+            metrics_.explorationCells += step;
+            break;
+        case MouseState::ReturningToStart:
+            metrics_.returnCells += step;
+            break;
+        case MouseState::RushingToFinish:
+            metrics_.rushCells += step;
+            ++metrics_.rushMoves;
+            metrics_.rushTime += time;
+            break;
+        case MouseState::Stopped:
+            break;
+    }
+}
+
+template <typename M>
+void Simulation<M>::hardwareTurn(const Dir4 relative_dir) {
+    if (relative_dir == Dir4::Up) {
+        return;
+    }
+
+    ++metrics_.turns;
+    const double time = motionProfile_.turnTimeTo(relative_dir);
+    clock_.motion(time);
+    if (this->state == MouseState::RushingToFinish) {
+        metrics_.rushTime += time;
+    }
+}
+
+template <typename M>
+void Simulation<M>::hardwareRunPrimitive(const MotionPrimitive& primitive) {
+    auto index = realMaze_.cellIndex(this->position);
+    for (int i = 0; i < primitive.cells; ++i) {
+        const auto dir = primitive.cellDir(i);
+        const auto& edge = realMaze_.edgeAt(index, dir);
+        if (edge.hasWall) {
+            metrics_.crashed = true;
+            break;
+        }
+        ++edge.num_traveled;
+        index = realMaze_.neighbourIndex(index, dir);
+    }
+    clock_.motion(primitive.duration);
+
+    metrics_.turns += primitive.numTurns();
+    switch (this->state) {
+        case MouseState::Exploring:
+            metrics_.explorationCells += primitive.cells;
+            break;
+        case MouseState::ReturningToStart:
+            metrics_.returnCells += primitive.cells;
+            break;
+        case MouseState::RushingToFinish:
+            metrics_.rushCells += primitive.cells;
+            metrics_.rushMoves += primitive.kind != MotionKind::InPlaceTurn;
+            metrics_.rushTime += primitive.duration;
+            break;
+        case MouseState::Stopped:
+            break;
+    }
+}
+
+template <typename M>
+void Simulation<M>::start() {
+    this->state = MouseState::Exploring;
+}
+
+template <typename M>
+bool Simulation<M>::step() {
+    if (metrics_.crashed) {
+        this->state = MouseState::Stopped;
+    }
+
+    switch (this->state) {
+        case MouseState::Exploring:
+        case MouseState::ReturningToStart:
+            this->nextExploringCycle();
+            break;
+        case MouseState::RushingToFinish:
+            this->nextRushingCycle();
+            break;
+        case MouseState::Stopped:
+            return false;
+    }
+    ++metrics_.cycles;
+
+    clock_.endCycle();
+    clock_.runAll();
+    metrics_.simulatedTime = clock_.now();
+
+    return true;
+}
+
+template <typename M>
+SimulationMetrics Simulation<M>::run(const long maxCycles) {
+    if (metrics_.cycles == 0 && this->state == MouseState::Stopped) {
+        start();
+    }
+
+    while (metrics_.cycles < maxCycles && step()) {}
+    metrics_.finished = this->state == MouseState::Stopped && !metrics_.crashed;
+
+    return metrics_;
+}
+
+}  // namespace Mazemouse
+
+#endif
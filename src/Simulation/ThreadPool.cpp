@@ -0,0 +1,146 @@
+#include "ThreadPool.hpp"
+#include <algorithm>
+#include <utility>
+
+namespace Mazemouse {
+
+ThreadPool::ThreadPool(unsigned numThreads) {
+    if (numThreads == 0) {
+        numThreads = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    for (unsigned i = 0; i < numThreads; ++i) {
+        queues_.push_back(std::make_unique<Queue>());
+    }
+    for (unsigned i = 0; i < numThreads; ++i) {
+        workers_.emplace_back([this, i] { workerLoop(i); });
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    try {
+        wait();
+    } catch (...) {
+        // Nobody waited for the task that threw
+    }
+    {
+        std::lock_guard lock(mutex_);
+        stopping_ = true;
+    }
+    task_available_.notify_all();
+
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+}
+
+void ThreadPool::submit(Task task) {
+    const unsigned index = next_queue_.fetch_add(1) % queues_.size();
+    ++num_unfinished_;
+    {
+        std::lock_guard lock(queues_[index]->mutex);
+        queues_[index]->tasks.push_back(std::move(task));
+    }
+    ++num_queued_;
+
+    // A worker registers as sleeping before it checks for tasks, so either
+    // it sees the task or it is seen here
+    if (num_sleeping_ > 0) {
+        { std::lock_guard lock(mutex_); }
+        task_available_.notify_one();
+    }
+}
+
+void ThreadPool::wait() {
+    std::unique_lock lock(mutex_);
+    all_done_.wait(lock, [this] { return num_unfinished_ == 0; });
+
+    if (error_) {
+        const auto error = std::exchange(error_, nullptr);
+        std::rethrow_exception(error);
+    }
+}
+
+void ThreadPool::parallelFor(
+    const int count, const std::function<void(int)>& fn) {
+    const int num_chunks = std::min(
+        count,
+        static_cast<int>(getNumThreads()) * PARALLEL_FOR_CHUNKS_PER_THREAD);
+    for (int chunk = 0; chunk < num_chunks; ++chunk) {
+        const int begin = static_cast<int>(
+            static_cast<long>(count) * chunk / num_chunks);
+        const int end = static_cast<int>(
+            static_cast<long>(count) * (chunk + 1) / num_chunks);
+        submit([&fn, begin, end] {
+            for (int i = begin; i < end; ++i) {
+                fn(i);
+            }
+        });
+    }
+    wait();
+}
+
+void ThreadPool::workerLoop(const unsigned index) {
+    while (true) {
+        Task task;
+        if (!tryPop(index, task)) {
+            std::unique_lock lock(mutex_);
+            ++num_sleeping_;
+            task_available_.wait(
+                lock, [this] { return stopping_ || num_queued_ > 0; });
+            --num_sleeping_;
+            if (stopping_ && num_queued_ == 0) {
+                return;
+            }
+            continue;
+        }
+
+        std::exception_ptr error;
+        try {
+            task();
+        } catch (...) {
+            error = std::current_exception();
+        }
+
+        if (error || --num_unfinished_ == 0) {
+            std::lock_guard lock(mutex_);
+            if (error) {
+                if (!error_) {
+                    error_ = error;
+                }
+                --num_unfinished_;
+            }
+            if (num_unfinished_ == 0) {
+                all_done_.notify_all();
+            }
+        }
+    }
+}
+
+bool ThreadPool::tryPop(const unsigned index, Task& task) {
+    const auto num_queues = static_cast<unsigned>(queues_.size());
+
+    // Own queue first (newest task), then steal from the others (oldest task)
+    for (unsigned offset = 0; offset < num_queues; ++offset) {
+        auto& queue = *queues_[(index + offset) % num_queues];
+        std::lock_guard lock(queue.mutex);
+        if (queue.tasks.empty()) {
+            continue;
+        }
+
+        if (offset == 0) {
+            task = std::move(queue.tasks.back());
+            queue.tasks.pop_back();
+        } else {
+            task = std::move(queue.tasks.front());
+            queue.tasks.pop_front();
+        }
+        --num_queued_;
+
+        return true;
+    }
+
+    return false;
+}
+
+}  // namespace Mazemouse
@@ -0,0 +1,129 @@
+#ifndef THREAD_POOL_HPP
+#define THREAD_POOL_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Mazemouse {
+
+/**
+ * The number of index ranges `ThreadPool::parallelFor()` hands every worker,
+ * so that workers which finish early can steal ranges of the others.
+ */
+constexpr int PARALLEL_FOR_CHUNKS_PER_THREAD = 4;
+
+/**
+ * @brief A work-stealing thread pool.
+ *
+ * Every worker owns a task queue. Submitted tasks are spread over the queues
+ * round-robin; a worker runs tasks from the back of its own queue and, once it
+ * is empty, steals from the front of the other workers' queues. This keeps all
+ * workers busy even when tasks take very different amounts of time.
+ *
+ * Submitting only locks the queue it pushes to. The pool-wide mutex is taken
+ * only to wake sleeping workers and to wait for the tasks to finish.
+ *
+ * An exception thrown by a task is caught on the worker and rethrown by the
+ * next `wait()`, on the waiting thread; if several tasks throw, the first is
+ * kept.
+ */
+class ThreadPool {
+ public:
+    using Task = std::function<void()>;
+
+    /**
+     * @brief Starts the workers.
+     *
+     * @param numThreads The number of workers; 0 uses one per hardware thread.
+     */
+    explicit ThreadPool(unsigned numThreads = 0);
+
+    ThreadPool(const ThreadPool&) = delete;
+
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * @brief Waits for all submitted tasks and stops the workers. An
+     * exception of a task that nobody waited for is dropped.
+     */
+    ~ThreadPool();
+
+    [[nodiscard]] unsigned getNumThreads() const {
+        return static_cast<unsigned>(workers_.size());
+    }
+
+    /**
+     * @brief Queues a task for execution.
+     */
+    void submit(Task task);
+
+    /**
+     * @brief Blocks until every submitted task has finished.
+     *
+     * @throws The first exception thrown by a task since the last wait.
+     */
+    void wait();
+
+    /**
+     * @brief Runs `fn(i)` for every `i` in [0, count) and waits for all of
+     * them to finish.
+     *
+     * The indices are handed out in contiguous ranges, about
+     * `PARALLEL_FOR_CHUNKS_PER_THREAD` per worker, rather than one task each.
+     *
+     * @throws The first exception thrown by `fn`. A range stops at its first
+     * exception; the other ranges still run.
+     */
+    void parallelFor(int count, const std::function<void(int)>& fn);
+
+ private:
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    std::vector<std::unique_ptr<Queue>> queues_;
+
+    std::vector<std::thread> workers_;
+
+    std::mutex mutex_;
+
+    std::condition_variable task_available_;
+
+    std::condition_variable all_done_;
+
+    std::atomic<long> num_queued_{ 0 };
+
+    std::atomic<long> num_unfinished_{ 0 };
+
+    /**
+     * The number of workers waiting for a task; submitting only takes the
+     * pool-wide mutex to wake them if there are any.
+     */
+    std::atomic<int> num_sleeping_{ 0 };
+
+    std::atomic<unsigned> next_queue_{ 0 };
+
+    /**
+     * The first exception thrown by a task since the last `wait()`. Guarded
+     * by `mutex_`.
+     */
+    std::exception_ptr error_{};
+
+    bool stopping_{ false };
+
+    void workerLoop(unsigned index);
+
+    bool tryPop(unsigned index, Task& task);
+};
+
+}  // namespace Mazemouse
+
+#endif
@@ -0,0 +1,269 @@
+#include "Tournament.hpp"
+#include <algorithm>
+#include <iomanip>
+#include <stdexcept>
+#include <utility>
+#include "../Maze/MazeCorpus.hpp"
+#include "../Maze/MazeGenerator.hpp"
+#include "../Mouse/AStarMouse.hpp"
+#include "../Mouse/TimeOptimalMouse.hpp"
+#include "BatchSimulation.hpp"
+#include "ThreadPool.hpp"
+
+namespace Mazemouse {
+
+namespace {
+
+/**
+ * @brief Per-mouse totals over all mazes of a tournament.
+ */
+struct TournamentSummary {
+    std::string mouse;
+    int runs{ 0 };
+    int finished{ 0 };
+    int crashed{ 0 };
+    long cycles{ 0 };
+    long explorationCells{ 0 };
+    long rushCells{ 0 };
+    long rushMoves{ 0 };
+    long turns{ 0 };
+    double rushTime{ 0 };
+};
+
+std::vector<TournamentSummary> summarize(
+    const std::vector<TournamentResult>& results) {
+    std::vector<TournamentSummary> summaries;
+    for (const auto& result : results) {
+        auto it = std::find_if(
+            summaries.begin(), summaries.end(),
+            [&](const auto& summary) { return summary.mouse == result.mouse; });
+        if (it == summaries.end()) {
+            it = summaries.insert(summaries.end(), { result.mouse });
+        }
+
+        const auto& metrics = result.metrics;
+        ++it->runs;
+        it->finished += metrics.finished;
+        it->crashed += metrics.crashed;
+        it->cycles += metrics.cycles;
+        it->explorationCells += metrics.explorationCells;
+        it->rushCells += metrics.rushCells;
+        it->rushMoves += metrics.rushMoves;
+        it->turns += metrics.turns;
+        it->rushTime += metrics.rushTime;
+    }
+
+    return summaries;
+}
+
+double average(const double total, const int count) {
+    return count == 0 ? 0.0 : static_cast<double>(total) / count;
+}
+
+}  // namespace
+
+std::vector<TournamentEntry> builtInMice(const long maxCycles) {
+    const auto flood_fill = [](auto& mouse) {
+        mouse.exploration_mode = ExplorationMode::FloodFill;
+    };
+    const auto until_optimal = [](auto& mouse) {
+        mouse.exploration_mode = ExplorationMode::FloodFillUntilOptimal;
+    };
+
+    std::vector<TournamentEntry> entries;
+    entries.push_back(makeEntry<FloodFillMouse>("flood-fill", maxCycles));
+    entries.back().batchRunner =
+        [maxCycles](const std::vector<SimulationMaze>& mazes) {
+            BatchSimulation batch(
+                mazes, { 0, mazes.front().height() - 1 },
+                MOUSE_STARTING_ORIENTATION);
+            batch.run(maxCycles);
+            return batch.getAllMetrics();
+        };
+    entries.push_back(makeEntry<FloodFillMouse>(
+        "flood-fill-distance", maxCycles, flood_fill));
+    entries.push_back(makeEntry<FloodFillMouse>(
+        "flood-fill-optimal", maxCycles, until_optimal));
+    entries.push_back(makeEntry<AStarMouse, AStarCell>("astar", maxCycles));
+    entries.push_back(makeEntry<AStarMouse, AStarCell>(
+        "astar-flood-fill", maxCycles, flood_fill));
+    entries.push_back(makeEntry<AStarMouse, AStarCell>(
+        "astar-optimal", maxCycles, until_optimal));
+    entries.push_back(makeEntry<TimeOptimalMouse, AStarCell>(
+        "time-optimal", maxCycles, flood_fill));
+
+    return entries;
+}
+
+Tournament::Tournament(TournamentOptions options) :
+    options_(std::move(options)) {
+    if (options_.numMazes < 0) {
+        throw std::invalid_argument(
+            "Tournament(): the number of mazes must not be negative");
+    }
+    if (options_.width < 2 || options_.height < 2) {
+        throw std::invalid_argument(
+            "Tournament(): the maze must be at least 2 cells wide and high");
+    }
+
+    for (auto& entry : builtInMice(options_.maxCycles)) {
+        addEntry(std::move(entry));
+    }
+}
+
+void Tournament::addMouse(std::string name, MouseRunner runner) {
+    addEntry({ std::move(name), std::move(runner) });
+}
+
+void Tournament::addEntry(TournamentEntry entry) {
+    for (const auto& registered : entries_) {
+        if (registered.name == entry.name) {
+            throw std::invalid_argument(
+                "Tournament::addEntry(): duplicate mouse name: " + entry.name);
+        }
+    }
+
+    entries_.push_back(std::move(entry));
+}
+
+std::vector<TournamentResult> Tournament::run() const {
+    const int num_entries = static_cast<int>(entries_.size());
+    ThreadPool pool(options_.numThreads);
+
+    std::vector<SimulationMaze> mazes;
+    std::vector<int> seeds;
+    if (options_.corpusPath.empty()) {
+        mazes.reserve(options_.numMazes);
+        for (int i = 0; i < options_.numMazes; ++i) {
+            mazes.emplace_back(options_.width, options_.height);
+            seeds.push_back(options_.seed + i);
+        }
+        generateBatch(mazes, seeds, pool, options_.algorithm);
+    } else {
+        const MazeCorpus corpus(options_.corpusPath);
+        mazes.reserve(corpus.size());
+        for (std::size_t i = 0; i < corpus.size(); ++i) {
+            const auto view = corpus.at(i);
+            mazes.emplace_back(view.width(), view.height());
+            view.writeTo(mazes.back());
+            seeds.push_back(static_cast<int>(view.getSeed()));
+        }
+    }
+    const int num_mazes = static_cast<int>(mazes.size());
+
+    const auto isBatched = [&](const TournamentEntry& entry) {
+        return options_.batch && entry.batchRunner;
+    };
+
+    // Every run writes only to its own slot
+    std::vector<TournamentResult> results(num_mazes * num_entries);
+    pool.parallelFor(num_mazes * num_entries, [&](const int i) {
+        const int maze_index = i / num_entries;
+        const auto& entry = entries_[i % num_entries];
+
+        auto& result = results[i];
+        result.mazeIndex = maze_index;
+        result.seed = seeds[maze_index];
+        result.mouse = entry.name;
+        if (!isBatched(entry)) {
+            result.metrics = entry.runner(mazes[maze_index]);
+        }
+    });
+
+    // Chunks of consecutive mazes of the same size, as [first, last)
+    std::vector<std::pair<int, int>> chunks;
+    for (int first = 0; first < num_mazes;) {
+        int last = first + 1;
+        while (last < num_mazes && last - first < TOURNAMENT_BATCH_MAZES &&
+               mazes[last].width() == mazes[first].width() &&
+               mazes[last].height() == mazes[first].height()) {
+            ++last;
+        }
+        chunks.emplace_back(first, last);
+        first = last;
+    }
+
+    const int num_chunks = static_cast<int>(chunks.size());
+    for (int e = 0; e < num_entries; ++e) {
+        const auto& entry = entries_[e];
+        if (!isBatched(entry)) {
+            continue;
+        }
+
+        pool.parallelFor(num_chunks, [&](const int c) {
+            const auto [first, last] = chunks[c];
+            const std::vector<SimulationMaze> chunk(
+                mazes.begin() + first, mazes.begin() + last);
+            const auto metrics = entry.batchRunner(chunk);
+            for (int i = first; i < last; ++i) {
+                results[i * num_entries + e].metrics = metrics[i - first];
+            }
+        });
+    }
+
+    return results;
+}
+
+void Tournament::writeCsv(
+    std::ostream& os, const std::vector<TournamentResult>& results) {
+    os << "maze,seed,mouse,cycles,exploration_cells,return_cells,rush_cells,"
+          "rush_moves,turns,rush_time,crashed,finished\n";
+    for (const auto& result : results) {
+        const auto& metrics = result.metrics;
+        os << result.mazeIndex << ',' << result.seed << ',' << result.mouse
+           << ',' << metrics.cycles << ',' << metrics.explorationCells << ','
+           << metrics.returnCells << ',' << metrics.rushCells << ','
+           << metrics.rushMoves << ',' << metrics.turns << ','
+           << metrics.rushTime << ',' << metrics.crashed << ','
+           << metrics.finished << '\n';
+    }
+}
+
+void Tournament::writeJson(
+    std::ostream& os, const std::vector<TournamentResult>& results) {
+    const auto flags = os.flags();
+    os << std::boolalpha << std::fixed << std::setprecision(2);
+
+    os << "{\n  \"runs\": [";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const auto& result = results[i];
+        const auto& metrics = result.metrics;
+        os << (i == 0 ? "\n" : ",\n") << "    {\"maze\": " << result.mazeIndex
+           << ", \"seed\": " << result.seed << ", \"mouse\": \""
+           << result.mouse << "\", \"cycles\": " << metrics.cycles
+           << ", \"exploration_cells\": " << metrics.explorationCells
+           << ", \"return_cells\": " << metrics.returnCells
+           << ", \"rush_cells\": " << metrics.rushCells
+           << ", \"rush_moves\": " << metrics.rushMoves
+           << ", \"turns\": " << metrics.turns
+           << ", \"rush_time\": " << metrics.rushTime
+           << ", \"crashed\": " << metrics.crashed
+           << ", \"finished\": " << metrics.finished << "}";
+    }
+    os << "\n  ],\n  \"summary\": [";
+
+    const auto summaries = summarize(results);
+    for (size_t i = 0; i < summaries.size(); ++i) {
+        const auto& summary = summaries[i];
+        os << (i == 0 ? "\n" : ",\n") << "    {\"mouse\": \"" << summary.mouse
+           << "\", \"runs\": " << summary.runs
+           << ", \"finished\": " << summary.finished
+           << ", \"crashed\": " << summary.crashed
+           << ", \"avg_cycles\": " << average(summary.cycles, summary.runs)
+           << ", \"avg_exploration_cells\": "
+           << average(summary.explorationCells, summary.runs)
+           << ", \"avg_rush_cells\": "
+           << average(summary.rushCells, summary.runs)
+           << ", \"avg_rush_moves\": "
+           << average(summary.rushMoves, summary.runs)
+           << ", \"avg_turns\": " << average(summary.turns, summary.runs)
+           << ", \"avg_rush_time\": "
+           << average(summary.rushTime, summary.runs)
+           << "}";
+    }
+    os << "\n  ]\n}\n";
+
+    os.flags(flags);
+}
+
+}  // namespace Mazemouse
@@ -0,0 +1,305 @@
+#ifndef TOURNAMENT_HPP
+#define TOURNAMENT_HPP
+
+#include <functional>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "../Maze/MazeGenerator.hpp"
+#include "../Mouse/FloodFillMouse.hpp"
+#include "LiveSimulation.hpp"
+#include "Simulation.hpp"
+
+namespace Mazemouse {
+
+/**
+ * The maze side length that runs on the compile-time sized fast path.
+ */
+constexpr int TOURNAMENT_STATIC_SIZE = 16;
+
+/**
+ * @brief Runs one mouse algorithm in a real maze and returns the metrics.
+ */
+using MouseRunner = std::function<SimulationMetrics(const SimulationMaze&)>;
+
+/**
+ * The most mazes run by one `BatchRunner` call in a tournament.
+ */
+constexpr int TOURNAMENT_BATCH_MAZES = 256;
+
+/**
+ * @brief Runs one mouse algorithm in many real mazes of the same size and
+ * returns the metrics in maze order.
+ */
+using BatchRunner = std::function<std::vector<SimulationMetrics>(
+    const std::vector<SimulationMaze>&)>;
+
+/**
+ * @brief A mouse algorithm that takes part in a tournament.
+ */
+struct TournamentEntry {
+    std::string name;
+    MouseRunner runner;
+
+    /**
+     * Runs the mouse in many mazes at once with the same metrics as
+     * `runner`, or is empty. Used when `TournamentOptions::batch` is set.
+     */
+    BatchRunner batchRunner{};
+
+    /**
+     * Creates the simulation of the mouse for watching it live, or is empty
+     * for mice registered with a runner only.
+     */
+    SimulationFactory factory{};
+};
+
+/**
+ * @brief The metrics of one mouse running in one maze.
+ */
+struct TournamentResult {
+    int mazeIndex{ 0 };
+    int seed{ 0 };
+    std::string mouse;
+    SimulationMetrics metrics{};
+};
+
+/**
+ * @brief Options of a tournament.
+ */
+struct TournamentOptions {
+    /**
+     * The number of mazes to generate.
+     */
+    int numMazes{ 100 };
+
+    int width{ TOURNAMENT_STATIC_SIZE };
+
+    int height{ TOURNAMENT_STATIC_SIZE };
+
+    /**
+     * The seed of the first maze; maze `i` is carved with `seed + i`.
+     */
+    int seed{ 10086 };
+
+    /**
+     * The algorithm that carves the mazes.
+     */
+    MazeAlgorithm algorithm{ MazeAlgorithm::DepthFirst };
+
+    /**
+     * A maze corpus file to run in instead of generated mazes, or empty. The
+     * number of mazes, the size, the seed and the algorithm are then taken
+     * from the corpus.
+     */
+    std::string corpusPath{};
+
+    /**
+     * The number of worker threads; 0 uses one per hardware thread.
+     */
+    unsigned numThreads{ 0 };
+
+    long maxCycles{ SIMULATION_MAX_CYCLES };
+
+    /**
+     * Whether mice with a `BatchRunner` run in batches of mazes of the same
+     * size instead of one maze at a time.
+     */
+    bool batch{ false };
+};
+
+/**
+ * @brief A mouse setup that leaves the mouse unchanged.
+ */
+struct NoMouseSetup {
+    template <typename M>
+    void operator()(M& /* mouse */) const {}
+};
+
+/**
+ * @brief Simulates a mouse algorithm in a real maze.
+ *
+ * The mouse starts at the bottom-left cell facing up. Mazes of the size
+ * `TOURNAMENT_STATIC_SIZE` use the compile-time sized mouse; all other sizes
+ * use the `DYNAMIC_SIZE` one.
+ *
+ * @tparam M The mouse template, e.g. `FloodFillMouse`.
+ * @tparam C The cell type of the mouse's maze.
+ * @tparam E The edge type of the mouse's maze.
+ * @tparam Hw `StaticHardware` to bind the hardware at compile time, or
+ * `MouseHardwareInterface` to go through virtual calls.
+ * @param setup Called with the mouse before it starts, e.g. to choose a mode.
+ */
+template <
+    template <int, typename, typename, typename> class M,
+    typename C = FloodFillCell, typename E = Edge,
+    typename Hw = StaticHardware, typename Setup = NoMouseSetup>
+SimulationMetrics simulate(
+    const SimulationMaze& realMaze, long maxCycles, Setup setup = {}) {
+    const int width = realMaze.width(), height = realMaze.height();
+    const Vector2 starting_position{ 0, height - 1 };
+
+    if (width == TOURNAMENT_STATIC_SIZE && height == TOURNAMENT_STATIC_SIZE) {
+        Simulation<M<TOURNAMENT_STATIC_SIZE, C, E, Hw>> simulation(
+            realMaze, starting_position, MOUSE_STARTING_ORIENTATION);
+        setup(simulation);
+        return simulation.run(maxCycles);
+    }
+
+    Simulation<M<DYNAMIC_SIZE, C, E, Hw>> simulation(
+        realMaze, starting_position, MOUSE_STARTING_ORIENTATION,
+        Maze<DYNAMIC_SIZE, C, E>(width, height));
+    setup(simulation);
+    return simulation.run(maxCycles);
+}
+
+/**
+ * @brief Creates the simulation of a mouse algorithm in a real maze, like
+ * `simulate()` but without running it.
+ */
+template <
+    template <int, typename, typename, typename> class M,
+    typename C = FloodFillCell, typename E = Edge,
+    typename Hw = StaticHardware, typename Setup = NoMouseSetup>
+std::unique_ptr<AnySimulation> makeSimulation(
+    const SimulationMaze& realMaze, Setup setup = {}) {
+    const int width = realMaze.width(), height = realMaze.height();
+    const Vector2 starting_position{ 0, height - 1 };
+
+    if (width == TOURNAMENT_STATIC_SIZE && height == TOURNAMENT_STATIC_SIZE) {
+        auto simulation = std::make_unique<
+            AnySimulationOf<M<TOURNAMENT_STATIC_SIZE, C, E, Hw>>>(
+            realMaze, starting_position, MOUSE_STARTING_ORIENTATION);
+        setup(simulation->getSimulation());
+        return simulation;
+    }
+
+    auto simulation =
+        std::make_unique<AnySimulationOf<M<DYNAMIC_SIZE, C, E, Hw>>>(
+            realMaze, starting_position, MOUSE_STARTING_ORIENTATION,
+            Maze<DYNAMIC_SIZE, C, E>(width, height));
+    setup(simulation->getSimulation());
+    return simulation;
+}
+
+/**
+ * @brief Creates the tournament entry of a mouse template, which is run
+ * through `simulate()` and created live through `makeSimulation()`.
+ *
+ * @param name The unique name of the mouse in the results.
+ * @param maxCycles The most cycles the runner simulates.
+ * @param setup Called with every mouse before it starts.
+ */
+template <
+    template <int, typename, typename, typename> class M,
+    typename C = FloodFillCell, typename E = Edge,
+    typename Setup = NoMouseSetup>
+TournamentEntry makeEntry(std::string name, long maxCycles, Setup setup = {}) {
+    return {
+        std::move(name),
+        [maxCycles, setup](const SimulationMaze& maze) {
+            return simulate<M, C, E, StaticHardware>(maze, maxCycles, setup);
+        },
+        BatchRunner{},
+        [setup](const SimulationMaze& maze) {
+            return makeSimulation<M, C, E, StaticHardware>(maze, setup);
+        },
+    };
+}
+
+/**
+ * @brief Returns the entries of the built-in mouse algorithms, in the order a
+ * tournament registers them.
+ *
+ * @param maxCycles The most cycles their runners simulate.
+ */
+std::vector<TournamentEntry> builtInMice(long maxCycles);
+
+/**
+ * @brief Runs every registered mouse algorithm in a set of generated mazes.
+ *
+ * Mazes are carved in parallel from consecutive seeds, or copied from the
+ * views of a maze corpus, then every
+ * (maze, mouse) pair is simulated as a separate task on a work-stealing
+ * thread pool. With `TournamentOptions::batch`, mice with a `BatchRunner`
+ * instead run in chunks of consecutive mazes of the same size, one task per
+ * chunk. Each run owns its copy of the real maze and writes to a
+ * pre-assigned result slot, so the results are identical whatever the number
+ * of threads.
+ */
+class Tournament {
+ public:
+    /**
+     * @brief Creates a tournament with the `builtInMice()` registered.
+     *
+     * @throws std::invalid_argument if the options are invalid.
+     */
+    explicit Tournament(TournamentOptions options);
+
+    /**
+     * @brief Registers a mouse algorithm.
+     *
+     * @throws std::invalid_argument if the name is already registered.
+     */
+    void addMouse(std::string name, MouseRunner runner);
+
+    /**
+     * @brief Registers a mouse template through `makeEntry()`.
+     *
+     * @param name The unique name of the mouse in the results.
+     * @param setup Called with every mouse before it starts.
+     * @throws std::invalid_argument if the name is already registered.
+     */
+    template <
+        template <int, typename, typename, typename> class M,
+        typename C = FloodFillCell, typename E = Edge,
+        typename Setup = NoMouseSetup>
+    void addMouse(std::string name, Setup setup = {}) {
+        addEntry(makeEntry<M, C, E>(
+            std::move(name), options_.maxCycles, std::move(setup)));
+    }
+
+    /**
+     * @brief Registers a mouse algorithm.
+     *
+     * @throws std::invalid_argument if the name is already registered.
+     */
+    void addEntry(TournamentEntry entry);
+
+    [[nodiscard]] const std::vector<TournamentEntry>& getEntries() const {
+        return entries_;
+    }
+
+    [[nodiscard]] const TournamentOptions& getOptions() const {
+        return options_;
+    }
+
+    /**
+     * @brief Generates the mazes and runs every mouse in each of them.
+     *
+     * @return The results ordered by maze, then by registration order.
+     */
+    [[nodiscard]] std::vector<TournamentResult> run() const;
+
+    /**
+     * @brief Writes one CSV row per run, with a header.
+     */
+    static void writeCsv(
+        std::ostream& os, const std::vector<TournamentResult>& results);
+
+    /**
+     * @brief Writes the runs and a per-mouse summary as a JSON document.
+     */
+    static void writeJson(
+        std::ostream& os, const std::vector<TournamentResult>& results);
+
+ private:
+    TournamentOptions options_;
+
+    std::vector<TournamentEntry> entries_;
+};
+
+}  // namespace Mazemouse
+
+#endif
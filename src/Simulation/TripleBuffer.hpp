@@ -0,0 +1,94 @@
+#ifndef TRIPLE_BUFFER_HPP
+#define TRIPLE_BUFFER_HPP
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace Mazemouse {
+
+/**
+ * @brief A lock-free triple buffer that passes the latest value from one
+ * writer thread to one reader thread.
+ *
+ * The writer fills `back()` and publishes it with `publish()`; the reader
+ * takes the latest published value with `read()`. Neither side ever waits:
+ * the writer always has a slot of its own to fill, the reader keeps the slot
+ * it has read until it reads again, and the third slot holds the latest
+ * published value in between. Values published while the reader does not
+ * read are skipped.
+ *
+ * Every slot is written in place, so a value that allocates, such as a
+ * `std::vector`, only allocates until every slot has reached its size.
+ *
+ * @tparam T The type of the values.
+ */
+template <typename T>
+class TripleBuffer {
+ public:
+    TripleBuffer() = default;
+
+    /**
+     * @brief Creates a buffer with every slot set to the given value.
+     */
+    explicit TripleBuffer(const T& value) : slots_{ value, value, value } {}
+
+    TripleBuffer(const TripleBuffer&) = delete;
+
+    TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+    /**
+     * @brief Returns the slot the writer fills next. Writer thread only.
+     */
+    T& back() { return slots_[back_]; }
+
+    /**
+     * @brief Publishes `back()` as the latest value and hands the writer a
+     * free slot. Writer thread only.
+     */
+    void publish() {
+        back_ = middle_.exchange(back_ | FRESH, std::memory_order_acq_rel) &
+                INDEX_MASK;
+    }
+
+    /**
+     * @brief Takes the latest published value if there is one newer than
+     * the last read, and returns it. Reader thread only.
+     */
+    const T& read() {
+        if (middle_.load(std::memory_order_relaxed) & FRESH) {
+            front_ = middle_.exchange(front_, std::memory_order_acq_rel) &
+                     INDEX_MASK;
+        }
+
+        return slots_[front_];
+    }
+
+    /**
+     * @brief Returns whether a value has been published since the last
+     * read. Reader thread only.
+     */
+    [[nodiscard]] bool hasFresh() const {
+        return middle_.load(std::memory_order_relaxed) & FRESH;
+    }
+
+ private:
+    static constexpr std::uint8_t INDEX_MASK = 3;
+
+    /**
+     * Marks the middle slot as published and not read yet.
+     */
+    static constexpr std::uint8_t FRESH = 4;
+
+    std::array<T, 3> slots_{};
+
+    std::uint8_t back_{ 0 };
+
+    std::atomic<std::uint8_t> middle_{ 1 };
+
+    std::uint8_t front_{ 2 };
+};
+
+}  // namespace Mazemouse
+
+#endif
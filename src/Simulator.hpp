@@ -3,5 +3,6 @@
 
 #include "Simulator/Game.hpp"
 #include "Simulator/MazePlugin.hpp"
+#include "Simulator/TiledViewerPlugin.hpp"
 
 #endif
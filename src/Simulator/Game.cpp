@@ -1,7 +1,28 @@
 #include "Game.hpp"
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
 
 namespace MazemouseSimulator {
 
+namespace {
+
+using ProfileClock = std::chrono::steady_clock;
+
+double elapsedUs(const ProfileClock::time_point start) {
+    return std::chrono::duration<double, std::micro>(
+               ProfileClock::now() - start)
+        .count();
+}
+
+}  // namespace
+
+int nextPluginTypeId() {
+    static int next_id = 0;
+    return next_id++;
+}
+
 Game Game::create(const std::function<void(GameOptions&)>& fn) {
     auto options = GameOptions();
     fn(options);
@@ -9,7 +30,7 @@ Game Game::create(const std::function<void(GameOptions&)>& fn) {
     return Game(options);
 }
 
-void Game::run() const {
+void Game::run() {
     static const auto BACKGROUND_COLOR = sf::Color(240, 235, 216);
 
     sf::RenderWindow window(
@@ -18,26 +39,125 @@ void Game::run() const {
     window.setVerticalSyncEnabled(options_.verticalSyncEnabled);
     window.setFramerateLimit(options_.fps);
 
+    const auto timestep_ms = static_cast<double>(options_.timestepMs);
+    const auto frame_budget_us = 1'000'000 / options_.fps;
+    double backlog_ms = 0;
     sf::Clock clock;
     while (window.isOpen()) {
         sf::Event event{};
         while (window.pollEvent(event)) {
-            if (event.type == sf::Event::Closed)
+            if (event.type == sf::Event::Closed) {
                 window.close();
+            } else if (event.type == sf::Event::KeyPressed) {
+                handleKeyPressed(event.key.code);
+            }
         }
 
-        const auto dt = clock.restart().asMilliseconds();
-        for (const auto& plugin : plugins_) {
-            plugin->update(dt);
+        const auto frame_ms =
+            static_cast<double>(clock.restart().asMicroseconds()) / 1000;
+        float alpha = 1;
+        if (time_scale_ == UNLIMITED_TIME_SCALE) {
+            const sf::Clock frame_clock;
+            do {
+                for (int i = 0; i < UNLIMITED_STEPS_PER_CHECK; ++i) {
+                    step();
+                }
+            } while (frame_clock.getElapsedTime().asMicroseconds() <
+                     frame_budget_us);
+            backlog_ms = 0;
+        } else {
+            backlog_ms = std::min(
+                backlog_ms + frame_ms * time_scale_,
+                MAX_FRAME_BACKLOG_MS * time_scale_);
+            while (backlog_ms >= timestep_ms) {
+                step();
+                backlog_ms -= timestep_ms;
+            }
+            alpha = static_cast<float>(backlog_ms / timestep_ms);
         }
 
         window.clear(BACKGROUND_COLOR);
-        for (const auto& plugin : plugins_) {
+        for (std::size_t i = 0; i < plugins_.size(); ++i) {
+            const auto& plugin = plugins_[i];
+            const auto start = ProfileClock::now();
+            plugin->renderFrame(alpha);
+            plugin->render();
             plugin->draw(window, {});
+
+            auto& profile = profiles_[i];
+            const auto draw_us = elapsedUs(start);
+            ++profile.frames;
+            profile.drawUs += draw_us;
+            profile.recentDrawUs +=
+                PROFILE_SMOOTHING * (draw_us - profile.recentDrawUs);
+            profile.recentUpdateUs +=
+                PROFILE_SMOOTHING *
+                (profile.frameUpdateUs - profile.recentUpdateUs);
+            profile.frameUpdateUs = 0;
         }
 
         window.display();
     }
+
+    if (options_.dumpProfileOnExit) {
+        dumpProfile(std::cout);
+    }
+}
+
+void Game::step() {
+    for (std::size_t i = 0; i < plugins_.size(); ++i) {
+        const auto start = ProfileClock::now();
+        plugins_[i]->update(options_.timestepMs);
+
+        auto& profile = profiles_[i];
+        const auto update_us = elapsedUs(start);
+        ++profile.updates;
+        profile.updateUs += update_us;
+        profile.frameUpdateUs += update_us;
+    }
+}
+
+void Game::handleKeyPressed(const sf::Keyboard::Key key) {
+    switch (key) {
+        case sf::Keyboard::Num1:
+            time_scale_ = 1;
+            break;
+        case sf::Keyboard::Num2:
+            time_scale_ = 10;
+            break;
+        case sf::Keyboard::Num3:
+            time_scale_ = 100;
+            break;
+        case sf::Keyboard::Num4:
+            time_scale_ = UNLIMITED_TIME_SCALE;
+            break;
+        case sf::Keyboard::P:
+            profile_overlay_shown_ = !profile_overlay_shown_;
+            break;
+        case sf::Keyboard::D:
+            dumpProfile(std::cout);
+            break;
+        default:
+            break;
+    }
+}
+
+void Game::dumpProfile(std::ostream& os) const {
+    const auto average = [](const double total, const long count) {
+        return count == 0 ? 0 : total / static_cast<double>(count);
+    };
+
+    os << std::left << std::setw(34) << "plugin" << std::right
+       << std::setw(12) << "updates" << std::setw(12) << "update us"
+       << std::setw(10) << "frames" << std::setw(12) << "draw us\n";
+    for (const auto& profile : profiles_) {
+        os << std::left << std::setw(34) << profile.name << std::right
+           << std::setw(12) << profile.updates << std::fixed
+           << std::setprecision(3) << std::setw(12)
+           << average(profile.updateUs, profile.updates) << std::setw(10)
+           << profile.frames << std::setw(12)
+           << average(profile.drawUs, profile.frames) << '\n';
+    }
 }
 
 }  // namespace MazemouseSimulator
@@ -1,6 +1,9 @@
 #ifndef GAME_HPP
 #define GAME_HPP
 
+#include <functional>
+#include <memory>
+#include <ostream>
 #include <string>
 #include <vector>
 #include <SFML/Graphics.hpp>
@@ -14,19 +17,116 @@ namespace MazemouseSimulator {
 constexpr auto WINDOW_CAPTION = "Mazemouse Simulator";
 constexpr auto REAL_MAZE_SIDE_LENGTH = 16;
 
+/**
+ * The time scale that simulates as many steps as fit in every frame.
+ */
+constexpr auto UNLIMITED_TIME_SCALE = 0;
+
+/**
+ * The most real time, in milliseconds, a frame catches up on. A slower frame
+ * slows the simulation down instead of stalling it with a growing backlog.
+ */
+constexpr auto MAX_FRAME_BACKLOG_MS = 250.0;
+
+/**
+ * The number of steps simulated between clock checks at the unlimited time
+ * scale.
+ */
+constexpr auto UNLIMITED_STEPS_PER_CHECK = 256;
+
+/**
+ * The weight of the latest frame in the smoothed times of the profiler.
+ */
+constexpr auto PROFILE_SMOOTHING = 0.05;
+
 struct GameOptions {
     sf::Vector2u windowSize{};
     int fps{ 30 };
     bool verticalSyncEnabled{ true };
+
+    /**
+     * The fixed simulation timestep in milliseconds, passed to every
+     * `GamePlugin::update()`.
+     */
+    int timestepMs{ 1 };
+
+    /**
+     * The simulated milliseconds per real millisecond at start, or
+     * `UNLIMITED_TIME_SCALE`.
+     */
+    int timeScale{ 1 };
+
+    /**
+     * Whether the profile overlay is shown at start; the key P toggles it.
+     */
+    bool profileOverlayShown{ false };
+
+    /**
+     * Whether `run()` dumps the profile to the standard output once the
+     * window is closed. The key D dumps it at any time.
+     */
+    bool dumpProfileOnExit{ false };
+};
+
+/**
+ * @brief The time a plugin has taken, in microseconds.
+ */
+struct PluginProfile {
+    std::string name;
+
+    /**
+     * The number of `update()` calls and their total time.
+     */
+    long updates{ 0 };
+
+    double updateUs{ 0 };
+
+    /**
+     * The number of frames drawn and the total time of `renderFrame()`,
+     * `render()` and `draw()` in them.
+     */
+    long frames{ 0 };
+
+    double drawUs{ 0 };
+
+    /**
+     * The update and draw times per frame, smoothed over recent frames.
+     */
+    double recentUpdateUs{ 0 };
+
+    double recentDrawUs{ 0 };
+
+    /**
+     * The update time of the current frame so far.
+     */
+    double frameUpdateUs{ 0 };
 };
 
+/**
+ * @brief Returns a small number identifying a plugin type, assigned on
+ * first use.
+ */
+int nextPluginTypeId();
+
+template <typename P>
+int pluginTypeId() {
+    static const int id = nextPluginTypeId();
+    return id;
+}
+
 class Game;
 
+/**
+ * @brief A layer of the window, retained in its own texture.
+ *
+ * The texture is created once and only redrawn by `render()` after
+ * `markDirty()`, so an unchanged layer costs one sprite draw per frame.
+ */
 class GameObject : public virtual sf::Drawable {
  public:
-    explicit GameObject(const sf::Vector2u size) : size_(size) {
-        texture_.create(size.x, size.y);
-        sprite_.setTexture(texture_);
+    explicit GameObject(const sf::Vector2u size) {
+        render_texture_.create(size.x, size.y);
+        sprite_.setTexture(render_texture_.getTexture());
     }
 
     void draw(sf::RenderTarget& target, const sf::RenderStates states)
@@ -34,25 +134,57 @@ class GameObject : public virtual sf::Drawable {
         target.draw(sprite_, states);
     }
 
+    /**
+     * @brief Redraws the texture if the object is dirty.
+     */
     void render() {
-        sf::RenderTexture render_texture;
-        render_texture.create(size_.x, size_.y);
-        renderOnTexture(render_texture);
-        render_texture.display();
+        if (!dirty_) {
+            return;
+        }
+
+        render_texture_.clear(sf::Color::Transparent);
+        renderOnTexture(render_texture_);
+        render_texture_.display();
+        dirty_ = false;
+    }
 
-        texture_ = render_texture.getTexture();
-        sprite_.setTexture(texture_);
+    /**
+     * @brief Draws over the texture without redrawing it, for objects that
+     * change a little at a time. It is skipped while the object is dirty,
+     * since the next `render()` redraws everything anyway.
+     */
+    void renderOver(
+        const sf::Drawable& drawable,
+        const sf::RenderStates& states = sf::RenderStates::Default) {
+        if (dirty_) {
+            return;
+        }
+
+        render_texture_.draw(drawable, states);
+        render_texture_.display();
     }
 
+    /**
+     * @brief Makes the next `render()` redraw the texture, once anything it
+     * shows has changed.
+     */
+    void markDirty() { dirty_ = true; }
+
+    [[nodiscard]] bool isDirty() const { return dirty_; }
+
     sf::Sprite& getSprite() { return sprite_; }
 
+    [[nodiscard]] const sf::Sprite& getSprite() const { return sprite_; }
+
  protected:
     virtual void renderOnTexture(sf::RenderTexture& render_texture) = 0;
 
  private:
-    sf::Vector2u size_;
-    sf::Texture texture_;
+    sf::RenderTexture render_texture_;
     sf::Sprite sprite_;
+
+    // Every object is drawn on its first frame
+    bool dirty_{ true };
 };
 
 class GamePlugin : public GameObject {
@@ -66,7 +198,23 @@ class GamePlugin : public GameObject {
 
     virtual std::string getName() = 0;
 
+    /**
+     * @brief Advances the plugin by one simulation step.
+     *
+     * @param dt The timestep in milliseconds, always
+     * `GameOptions::timestepMs`, so that a run is the same at any frame rate
+     * and time scale.
+     */
     virtual void update(int dt) = 0;
+
+    /**
+     * @brief Prepares the plugin to be drawn in the next frame, calling
+     * `markDirty()` if its texture has to be redrawn.
+     *
+     * @param alpha How far the frame lies from the previous simulation step
+     * to the current one, between 0 and 1.
+     */
+    virtual void renderFrame(float alpha) {}
 };
 
 struct GameCell : Cell {};
@@ -83,8 +231,36 @@ class Game {
 
     std::vector<std::shared_ptr<GamePlugin>> plugins_{};
 
+    /**
+     * The plugins indexed by `pluginTypeId()`, or null for types not in use.
+     */
+    std::vector<GamePlugin*> plugins_by_type_{};
+
+    /**
+     * The profile of every plugin, in the order of `plugins_`.
+     */
+    std::vector<PluginProfile> profiles_{};
+
+    int time_scale_;
+
+    bool profile_overlay_shown_;
+
+    /**
+     * @brief Advances every plugin by one simulation step, timing each.
+     */
+    void step();
+
+    /**
+     * @brief Switches the time scale with the keys 1 (1x), 2 (10x), 3 (100x)
+     * and 4 (unlimited), toggles the profile overlay with P and dumps the
+     * profile with D.
+     */
+    void handleKeyPressed(sf::Keyboard::Key key);
+
  public:
-    explicit Game(const GameOptions options) : options_(options) {}
+    explicit Game(const GameOptions options) :
+        options_(options), time_scale_(options.timeScale),
+        profile_overlay_shown_(options.profileOverlayShown) {}
 
     static Game create(const std::function<void(GameOptions&)>& fn);
 
@@ -94,22 +270,97 @@ class Game {
         return real_maze_;
     }
 
-    void run() const;
-
+    [[nodiscard]] int getTimeScale() const { return time_scale_; }
+
+    /**
+     * @brief Sets the simulated milliseconds per real millisecond, or
+     * `UNLIMITED_TIME_SCALE` to simulate as fast as the frames allow. The
+     * steps stay the same, so a run does not depend on it.
+     */
+    void setTimeScale(const int timeScale) { time_scale_ = timeScale; }
+
+    /**
+     * @brief Opens the window and runs the simulation at fixed timesteps
+     * until the window is closed.
+     *
+     * Every frame simulates as many steps as the real time elapsed, scaled by
+     * the time scale, and the plugins draw themselves between the last two
+     * steps. Only the plugins marked dirty redraw their textures; the others
+     * are composed from the textures of earlier frames.
+     */
+    void run();
+
+    /**
+     * @brief Creates a plugin and adds it on top of the others.
+     *
+     * @return The plugin, which `getPlugin<PluginType>()` also finds in
+     * constant time. A type used twice is found as its last plugin.
+     */
     template <typename PluginType, typename... Args>
-    void usePlugin(Args&&... args) {
-        auto plugin =
-            std::make_shared<PluginType>(this, std::forward<Args>(args)...);
-        plugins_.push_back(plugin);
-    }
+    std::shared_ptr<PluginType> usePlugin(Args&&... args);
+
+    /**
+     * @brief Returns the plugin of a type added by `usePlugin()`, or null.
+     * It takes constant time and allocates nothing.
+     */
+    template <typename P>
+    [[nodiscard]] P* getPlugin() const;
 
+    /**
+     * @brief Returns the first plugin with the given name, or null. It scans
+     * every plugin; prefer `getPlugin<P>()`.
+     */
     template <typename P>
     [[nodiscard]] std::shared_ptr<P> getPlugin(const std::string& name) const;
+
+    [[nodiscard]] const std::vector<PluginProfile>& getProfiles() const {
+        return profiles_;
+    }
+
+    [[nodiscard]] bool isProfileOverlayShown() const {
+        return profile_overlay_shown_;
+    }
+
+    void setProfileOverlayShown(const bool shown) {
+        profile_overlay_shown_ = shown;
+    }
+
+    /**
+     * @brief Writes the average update and draw time of every plugin as a
+     * table.
+     */
+    void dumpProfile(std::ostream& os) const;
 };
 
 inline GamePlugin::GamePlugin(Game* game) :
     GameObject(game->getOptions().windowSize), game_(game) {}
 
+template <typename PluginType, typename... Args>
+std::shared_ptr<PluginType> Game::usePlugin(Args&&... args) {
+    auto plugin =
+        std::make_shared<PluginType>(this, std::forward<Args>(args)...);
+    plugins_.push_back(plugin);
+    profiles_.push_back({ plugin->getName() });
+
+    const auto id = static_cast<std::size_t>(pluginTypeId<PluginType>());
+    if (id >= plugins_by_type_.size()) {
+        plugins_by_type_.resize(id + 1, nullptr);
+    }
+    plugins_by_type_[id] = plugin.get();
+
+    return plugin;
+}
+
+template <typename P>
+P* Game::getPlugin() const {
+    const auto id = static_cast<std::size_t>(pluginTypeId<P>());
+    if (id >= plugins_by_type_.size()) {
+        return nullptr;
+    }
+
+    return static_cast<P*>(plugins_by_type_[id]);
+}
+
 template <typename P>
 std::shared_ptr<P> Game::getPlugin(const std::string& name) const {
     for (const auto& plugin : plugins_) {
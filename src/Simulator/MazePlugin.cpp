@@ -1,5 +1,8 @@
 #include "MazePlugin.hpp"
-#include <random>
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+#include "../Maze/MazeGenerator.hpp"
 
 namespace MazemouseSimulator {
 
@@ -51,175 +54,129 @@ void PeripheralWallMazePlugin::renderOnTexture(
     render_texture.draw(rectangle_horizontal);
 }
 
-void FloorMazePlugin::renderOnTexture(sf::RenderTexture& render_texture) {
+std::size_t MazePlugin::edgeQuadIndex(const Vector2& cell, const Dir4 dir) {
+    constexpr auto S = REAL_MAZE_SIDE_LENGTH;
+    switch (dir) {
+        case Dir4::Up:
+            return edgeQuadIndex({ cell.x, cell.y - 1 }, Dir4::Down);
+        case Dir4::Left:
+            return edgeQuadIndex({ cell.x - 1, cell.y }, Dir4::Right);
+        case Dir4::Right:
+            return cell.y * (S - 1) + cell.x;
+        case Dir4::Down:
+            return S * (S - 1) + cell.y * S + cell.x;
+    }
+    return 0;
+}
+
+void MazePlugin::setQuad(
+    sf::VertexArray& vertices, const std::size_t quad,
+    const sf::Vector2f& position, const sf::Vector2f& size,
+    const sf::Color& color) {
+    auto* const corners = &vertices[4 * quad];
+    corners[0].position = position;
+    corners[1].position = { position.x + size.x, position.y };
+    corners[2].position = position + size;
+    corners[3].position = { position.x, position.y + size.y };
+    setQuadColor(vertices, quad, color);
+}
+
+void MazePlugin::setQuadColor(
+    sf::VertexArray& vertices, const std::size_t quad,
+    const sf::Color& color) {
+    for (std::size_t i = 4 * quad; i < 4 * quad + 4; ++i) {
+        vertices[i].color = color;
+    }
+}
+
+FloorMazePlugin::FloorMazePlugin(Game* game) :
+    MazePlugin(game, MAZE_MARGIN_PIXEL) {
     static const std::vector colors{ sf::Color(255, 221, 210),
                                      sf::Color(131, 197, 190) };
+    static const auto GOAL_AREA_COLOR = sf::Color(239, 71, 111, 125);
     static const sf::Vector2f cellSize{ CELL_SIDE_LENGTH_PIXEL,
                                         CELL_SIDE_LENGTH_PIXEL };
 
     for (unsigned col = 0; col < REAL_MAZE_SIDE_LENGTH; ++col) {
         for (unsigned row = 0; row < REAL_MAZE_SIDE_LENGTH; ++row) {
-            sf::RectangleShape square(cellSize);
-            square.setPosition(
-                static_cast<float>(col) * CELL_SIDE_LENGTH_PIXEL,
-                static_cast<float>(row) * CELL_SIDE_LENGTH_PIXEL);
-            square.setFillColor(colors[(col + row) % colors.size()]);
-            render_texture.draw(square);
+            setQuad(
+                tiles_, row * REAL_MAZE_SIDE_LENGTH + col,
+                { static_cast<float>(col) * CELL_SIDE_LENGTH_PIXEL,
+                  static_cast<float>(row) * CELL_SIDE_LENGTH_PIXEL },
+                cellSize, colors[(col + row) % colors.size()]);
         }
     }
 
-    renderGoalArea(render_texture);
+    // The goal area is blended over the four tiles in the centre
+    constexpr auto G = CELL_SIDE_LENGTH_PIXEL * (REAL_MAZE_SIDE_LENGTH / 2 - 1);
+    setQuad(
+        tiles_, NUM_TILES - 1, { G, G },
+        { CELL_SIDE_LENGTH_PIXEL * 2, CELL_SIDE_LENGTH_PIXEL * 2 },
+        GOAL_AREA_COLOR);
 }
 
-void FloorMazePlugin::renderGoalArea(sf::RenderTexture& render_texture) {
-    static const auto COLOR = sf::Color(239, 71, 111, 125);
-
-    constexpr auto G = CELL_SIDE_LENGTH_PIXEL * (REAL_MAZE_SIDE_LENGTH / 2 - 1);
-    sf::RectangleShape goalArea(
-        { CELL_SIDE_LENGTH_PIXEL * 2, CELL_SIDE_LENGTH_PIXEL * 2 });
-    goalArea.setPosition(G, G);
-    goalArea.setFillColor(COLOR);
-    render_texture.draw(goalArea);
+void FloorMazePlugin::renderOnTexture(sf::RenderTexture& render_texture) {
+    render_texture.draw(tiles_);
 }
 
-void WallMazePlugin::renderOnTexture(sf::RenderTexture& render_texture) {
-    static const auto COLOR = sf::Color::Black;
+WallMazePlugin::WallMazePlugin(Game* game) :
+    MazePlugin(game, MAZE_MARGIN_PIXEL) {
     static constexpr auto WALL_THICKNESS_HALF_PIXEL = WALL_THICKNESS_PIXEL / 2;
 
-    const auto& maze = game_->getRealMaze();
-    sf::RectangleShape rectangle_vertical(
-        { WALL_THICKNESS_PIXEL, CELL_SIDE_LENGTH_PIXEL });
-    rectangle_vertical.setFillColor(COLOR);
-    sf::RectangleShape rectangle_horizontal(
-        { CELL_SIDE_LENGTH_PIXEL, WALL_THICKNESS_PIXEL });
-    rectangle_horizontal.setFillColor(COLOR);
-
-    // Vertical walls
-    for (int col = 0; col < REAL_MAZE_SIDE_LENGTH - 1; ++col) {
+    // The quads are placed once; walls are shown by their color
+    for (int col = 0; col < REAL_MAZE_SIDE_LENGTH; ++col) {
         for (int row = 0; row < REAL_MAZE_SIDE_LENGTH; ++row) {
-            if (maze.edge({ col, row }, Dir4::Right).hasWall) {
-                rectangle_vertical.setPosition(
+            if (col < REAL_MAZE_SIDE_LENGTH - 1) {
+                setQuad(
+                    walls_, edgeQuadIndex({ col, row }, Dir4::Right),
                     { static_cast<float>(col + 1) * CELL_SIDE_LENGTH_PIXEL -
                           WALL_THICKNESS_HALF_PIXEL,
-                      static_cast<float>(row) * CELL_SIDE_LENGTH_PIXEL });
-                render_texture.draw(rectangle_vertical);
+                      static_cast<float>(row) * CELL_SIDE_LENGTH_PIXEL },
+                    { WALL_THICKNESS_PIXEL, CELL_SIDE_LENGTH_PIXEL },
+                    sf::Color::Transparent);
             }
-        }
-    }
-
-    // Horizontal walls
-    for (int col = 0; col < REAL_MAZE_SIDE_LENGTH; ++col) {
-        for (int row = 0; row < REAL_MAZE_SIDE_LENGTH - 1; ++row) {
-            if (maze.edge({ col, row }, Dir4::Down).hasWall) {
-                rectangle_horizontal.setPosition({
-                    static_cast<float>(col) * CELL_SIDE_LENGTH_PIXEL,
-                    static_cast<float>(row + 1) * CELL_SIDE_LENGTH_PIXEL -
-                        WALL_THICKNESS_HALF_PIXEL,
-                });
-                render_texture.draw(rectangle_horizontal);
+            if (row < REAL_MAZE_SIDE_LENGTH - 1) {
+                setQuad(
+                    walls_, edgeQuadIndex({ col, row }, Dir4::Down),
+                    { static_cast<float>(col) * CELL_SIDE_LENGTH_PIXEL,
+                      static_cast<float>(row + 1) * CELL_SIDE_LENGTH_PIXEL -
+                          WALL_THICKNESS_HALF_PIXEL },
+                    { CELL_SIDE_LENGTH_PIXEL, WALL_THICKNESS_PIXEL },
+                    sf::Color::Transparent);
             }
         }
     }
-}
 
-void WallMazePlugin::carvePaths(const int seed) const {
-    const auto& maze = game_->getRealMaze();
-    constexpr auto S = REAL_MAZE_SIDE_LENGTH;
+    carvePaths(MAZE_PATH_CURVING_SEED);
+}
 
-    std::mt19937 rng(seed);
-    std::vector visited(S * S, false);
-    std::stack<Vector2> cell_stack;
-    Vector2 current(0, 15);
-    cell_stack.push(current);
-    visited[current.y * S + current.x] = true;
-
-    constexpr int halfSide = S / 2;
-    const std::vector centerCells = {
-        Vector2(halfSide - 1, halfSide - 1),
-        Vector2(halfSide - 1, halfSide),
-        Vector2(halfSide, halfSide),
-        Vector2(halfSide, halfSide - 1),
-    };
-    bool reached_center = false;
+void WallMazePlugin::renderOnTexture(sf::RenderTexture& render_texture) {
+    render_texture.draw(walls_);
+}
 
-    while (!cell_stack.empty()) {
-        current = cell_stack.top();
+void WallMazePlugin::carvePaths(const int seed) {
+    auto& maze = game_->getRealMaze();
+    Mazemouse::carvePaths(maze, seed);
 
-        // Check if we've reached any of the center cells
-        for (const auto& centerCell : centerCells) {
-            if (current == centerCell) {
-                reached_center = true;
-                break;
+    const auto showWall = [&](const Vector2& cell, const Dir4 dir) {
+        setQuadColor(
+            walls_, edgeQuadIndex(cell, dir),
+            maze.edge(cell, dir).hasWall ? sf::Color::Black
+                                         : sf::Color::Transparent);
+    };
+    for (int col = 0; col < REAL_MAZE_SIDE_LENGTH; ++col) {
+        for (int row = 0; row < REAL_MAZE_SIDE_LENGTH; ++row) {
+            if (col < REAL_MAZE_SIDE_LENGTH - 1) {
+                showWall({ col, row }, Dir4::Right);
             }
-        }
-
-        // Get possible directions
-        std::vector<Dir4> possible_dirs;
-        for (int i = 0; i < 4; i++) {
-            auto dir = static_cast<Dir4>(i);
-            const auto [x, y] = current + get_vector(static_cast<Dir4>(i));
-
-            // Check if the next cell is within bounds
-            if (x >= 0 && x < S && y >= 0 && y < S) {
-                if (!visited[y * S + x]) {
-                    possible_dirs.push_back(dir);
-                }
+            if (row < REAL_MAZE_SIDE_LENGTH - 1) {
+                showWall({ col, row }, Dir4::Down);
             }
         }
-
-        if (!possible_dirs.empty()) {
-            std::uniform_int_distribution dist(
-                0, static_cast<int>(possible_dirs.size()) - 1);
-            const Dir4 chosenDir = possible_dirs[dist(rng)];
-            maze.edge(current, chosenDir).hasWall = false;
-
-            Vector2 next = current + get_vector(chosenDir);
-            visited[next.y * S + next.x] = true;
-            cell_stack.push(next);
-        } else {
-            cell_stack.pop();
-        }
-    }
-
-    if (!reached_center) {
-        std::vector visited2(S * S, false);
-        std::function<bool(Vector2)> findPath = [&](const Vector2 pos) -> bool {
-            visited2[pos.y * S + pos.x] = true;
-
-            for (const auto& centerCell : centerCells) {
-                if (pos == centerCell)
-                    return true;
-            }
-
-            // Try all directions
-            for (int i = 0; i < 4; i++) {
-                const auto dir = static_cast<Dir4>(i);
-                const Vector2 next = pos + get_vector(dir);
-
-                if (next.x >= 0 && next.x < S && next.y >= 0 && next.y < S &&
-                    !visited2[next.y * S + next.x]) {
-                    const Edge& currentEdge = maze.edge(pos, dir);
-                    currentEdge.hasWall = false;
-
-                    if (findPath(next))
-                        return true;
-
-                    currentEdge.hasWall = true;
-                }
-            }
-            return false;
-        };
-
-        findPath(Vector2(0, 15));
-    }
-
-    // Connect center cells to each other
-    auto dir = Dir4::Down;
-    for (auto centerCell : centerCells) {
-        maze.edge(centerCell, dir).hasWall = false;
-        dir = dir + Dir4::Left;
     }
+    markDirty();
 }
+
 MouseMazePlugin::MouseMazePlugin(Game* game) :
     MazePlugin(game, MAZE_MARGIN_PIXEL) {
     // Setup entity
@@ -227,24 +184,72 @@ MouseMazePlugin::MouseMazePlugin(Game* game) :
     entity_position_ = position;
     entity_destination_ = position;
     teleport(position);
+    previous_position_pixel_ = entity_position_pixel_;
+    render_position_pixel_ = entity_position_pixel_;
+
+    // Setup the trail, which runs between the centres of the cells
+    for (int col = 0; col < REAL_MAZE_SIDE_LENGTH; ++col) {
+        for (int row = 0; row < REAL_MAZE_SIDE_LENGTH; ++row) {
+            const sf::Vector2f centre = {
+                static_cast<float>(col + 0.5) * CELL_SIDE_LENGTH_PIXEL,
+                static_cast<float>(row + 0.5) * CELL_SIDE_LENGTH_PIXEL
+            };
+            if (col < REAL_MAZE_SIDE_LENGTH - 1) {
+                setQuad(
+                    trail_, edgeQuadIndex({ col, row }, Dir4::Right), centre,
+                    { CELL_SIDE_LENGTH_PIXEL, 2 }, sf::Color::Transparent);
+            }
+            if (row < REAL_MAZE_SIDE_LENGTH - 1) {
+                setQuad(
+                    trail_, edgeQuadIndex({ col, row }, Dir4::Down), centre,
+                    { 2, CELL_SIDE_LENGTH_PIXEL }, sf::Color::Transparent);
+            }
+        }
+    }
 
     // Start the mouse
     state = MouseState::Exploring;
 }
 
 bool MouseMazePlugin::hardwareCheckWall(const Dir4 dir) {
-    return !game_->getRealMaze().isOpen(position, getAbsoluteDir(dir));
+    clock_.sensorRead();
+
+    const auto& maze = game_->getRealMaze();
+    return !maze.isOpenAt(maze.cellIndex(position), getAbsoluteDir(dir));
 }
 
 void MouseMazePlugin::hardwareMoveForward(const int length) {
-    entity_destination_ = position + length * get_vector(entity_orientation_);
-    running_ = true;
+    entity_destination_ = position;
+    for (int i = 0; i < length; ++i) {
+        travel(entity_destination_, entity_orientation_);
+        entity_destination_ =
+            entity_destination_ + get_vector(entity_orientation_);
+    }
+
+    const auto velocity = this->state == MouseState::RushingToFinish
+                              ? MOUSE_RUSHING_VELOCITY
+                              : MOUSE_EXPLORING_VELOCITY;
+    startMotion(
+        static_cast<double>(length) * CELL_SIDE_LENGTH_PIXEL / velocity /
+        1000);
 }
 
 void MouseMazePlugin::hardwareTurn(Dir4 relative_dir) {
     entity_orientation_ = orientation;
 }
 
+void MouseMazePlugin::hardwareRunPrimitive(const MotionPrimitive& primitive) {
+    entity_destination_ = position;
+    for (int i = 0; i < primitive.cells; ++i) {
+        const auto dir = primitive.cellDir(i);
+        travel(entity_destination_, dir);
+        entity_destination_ = entity_destination_ + get_vector(dir);
+    }
+
+    // Primitives are animated along the chord of their path
+    startMotion(primitive.duration);
+}
+
 void MouseMazePlugin::nextExploringCycle() {
     SemiFinishedMouse::nextExploringCycle();
 }
@@ -253,160 +258,142 @@ void MouseMazePlugin::moveForward(const int length) {
     FloodFillMouse::moveForward(length);
 }
 
+void MouseMazePlugin::draw(
+    sf::RenderTarget& target, sf::RenderStates states) const {
+    MazePlugin::draw(target, states);
+
+    states.transform *= getSprite().getTransform();
+    renderMouse(target, states);
+}
+
 void MouseMazePlugin::renderOnTexture(sf::RenderTexture& render_texture) {
-    renderEdges(render_texture);
-    renderMouse(render_texture);
+    // Quads replace the pixels below them, so that patching a quad over the
+    // retained trail gives the same pixels as a redraw
+    render_texture.draw(trail_, sf::BlendNone);
+    trail_patch_.clear();
 }
 
 void MouseMazePlugin::update(const int dt) {
     MazePlugin::update(dt);
-    render();
-
-    if (!running_) {
-        if (state == MouseState::Exploring ||
-            state == MouseState::ReturningToStart) {
-            nextExploringCycle();
-        } else if (state == MouseState::RushingToFinish) {
-            nextRushingCycle();
-        } else if (state == MouseState::Stopped) {
-            running_ = false;
-            return;
-        }
+    previous_position_pixel_ = entity_position_pixel_;
+
+    // Every event within the step fires at its own time, so a step may
+    // complete several cycles
+    if (clock_.empty() && state != MouseState::Stopped) {
+        runCycle();
+    }
+    clock_.runUntil(
+        clock_.now() + static_cast<double>(dt) / 1000,
+        [&](const ScheduledEvent& event) { handleEvent(event); });
+
+    if (clock_.now() < motion_end_time_) {
+        const auto progress = static_cast<float>(
+            (clock_.now() - motion_start_time_) /
+            (motion_end_time_ - motion_start_time_));
+        entity_position_pixel_ =
+            motion_origin_pixel_ +
+            (cellCenterPixel(entity_destination_) - motion_origin_pixel_) *
+                progress;
     }
+}
 
-    const auto velocity = this->state == MouseState::RushingToFinish
-                              ? MOUSE_RUSHING_VELOCITY
-                              : MOUSE_EXPLORING_VELOCITY;
-    const auto deltaX = entity_destination_.x - entity_position_.x;
-    const auto deltaY = entity_destination_.y - entity_position_.y;
-
-    int step;
-    if (deltaX != 0) {
-        const auto velocitySign = static_cast<float>(deltaX > 0 ? 1 : -1);
-        entity_position_pixel_.x +=
-            static_cast<float>(dt) * velocity * velocitySign;
-        step = std::abs(deltaX);
-    } else if (deltaY != 0) {
-        const auto velocitySign = static_cast<float>(deltaY > 0 ? 1 : -1);
-        entity_position_pixel_.y +=
-            static_cast<float>(dt) * velocity * velocitySign;
-        step = std::abs(deltaY);
-    } else {
-        running_ = false;
-        return;
+void MouseMazePlugin::runCycle() {
+    if (state == MouseState::Exploring ||
+        state == MouseState::ReturningToStart) {
+        nextExploringCycle();
+    } else if (state == MouseState::RushingToFinish) {
+        nextRushingCycle();
     }
+    clock_.endCycle();
+}
 
-    moving_time_ms_ += dt;
-    const auto maxMovingTimeMs =
-        static_cast<unsigned>(std::floor(CELL_SIDE_LENGTH_PIXEL / velocity)) *
-        step;
-    if (moving_time_ms_ > maxMovingTimeMs) {
-        auto dirVector = entity_destination_ - entity_position_;
-        if (dirVector.x != 0) {
-            dirVector.x = dirVector.x > 0 ? 1 : -1;
-        }
-        if (dirVector.y != 0) {
-            dirVector.y = dirVector.y > 0 ? 1 : -1;
-        }
+void MouseMazePlugin::startMotion(const double duration) {
+    motion_end_time_ = clock_.motion(duration);
+    motion_start_time_ = motion_end_time_ - duration;
+    motion_origin_pixel_ = cellCenterPixel(position);
+}
 
-        const auto dir = get_dir(dirVector);
-        game_->getRealMaze().edge(entity_position_, dir).num_traveled++;
+void MouseMazePlugin::handleEvent(const ScheduledEvent& event) {
+    if (event.event == SimulationEvent::MotionComplete) {
         teleport(entity_destination_);
-        moving_time_ms_ = 0;
-
-        // Stop the mouse
-        running_ = false;
+    }
+    if (clock_.empty() && state != MouseState::Stopped) {
+        runCycle();
     }
 }
 
-void MouseMazePlugin::renderEdges(sf::RenderTexture& render_texture) const {
-    const auto maze = game_->getRealMaze();
-    auto rectangle_vertical = sf::RectangleShape({ 2, CELL_SIDE_LENGTH_PIXEL });
-    auto rectangle_horizontal =
-        sf::RectangleShape({ CELL_SIDE_LENGTH_PIXEL, 2 });
+void MouseMazePlugin::renderFrame(const float alpha) {
+    render_position_pixel_ =
+        previous_position_pixel_ +
+        (entity_position_pixel_ - previous_position_pixel_) * alpha;
 
-    // Vertical edges
-    for (int col = 0; col < REAL_MAZE_SIDE_LENGTH; ++col) {
-        for (int row = 0; row < REAL_MAZE_SIDE_LENGTH - 1; ++row) {
-            const auto num_traveled =
-                maze.edge({ col, row }, Dir4::Down).num_traveled;
-
-            if (num_traveled > 0) {
-                rectangle_vertical.setPosition(
-                    { static_cast<float>(col + 0.5) * CELL_SIDE_LENGTH_PIXEL,
-                      static_cast<float>(row + 0.5) * CELL_SIDE_LENGTH_PIXEL });
-                rectangle_vertical.setFillColor(sf::Color(
-                    255, 255, 255, std::min(255, 215 + num_traveled * 10)));
-                render_texture.draw(rectangle_vertical);
-            }
-        }
-    }
-
-    // Horizontal edges
-    for (int col = 0; col < REAL_MAZE_SIDE_LENGTH - 1; ++col) {
-        for (int row = 0; row < REAL_MAZE_SIDE_LENGTH; ++row) {
-            const auto num_traveled =
-                maze.edge({ col, row }, Dir4::Right).num_traveled;
-            if (num_traveled > 0) {
-                rectangle_horizontal.setPosition(
-                    { static_cast<float>(col + 0.5) * CELL_SIDE_LENGTH_PIXEL,
-                      static_cast<float>(row + 0.5) * CELL_SIDE_LENGTH_PIXEL });
-                rectangle_horizontal.setFillColor(sf::Color(
-                    255, 255, 255, std::min(255, 215 + num_traveled * 10)));
-                render_texture.draw(rectangle_horizontal);
-            }
-        }
+    if (trail_patch_.getVertexCount() > 0) {
+        renderOver(trail_patch_, sf::BlendNone);
+        trail_patch_.clear();
     }
 }
 
-void MouseMazePlugin::renderMouse(sf::RenderTexture& render_texture) const {
+void MouseMazePlugin::renderMouse(
+    sf::RenderTarget& target, const sf::RenderStates& states) const {
     static const auto MOUSE_COLOR = sf::Color::Black;
 
     auto circle = sf::CircleShape(MOUSE_RADIUS, 3);
     circle.setFillColor(MOUSE_COLOR);
     circle.setOrigin(MOUSE_RADIUS, MOUSE_RADIUS);
-    circle.setPosition(entity_position_pixel_.x, entity_position_pixel_.y);
+    circle.setPosition(render_position_pixel_.x, render_position_pixel_.y);
     circle.rotate(static_cast<float>(orientation) * 90);
 
-    render_texture.draw(circle);
+    target.draw(circle, states);
+}
+
+void MouseMazePlugin::travel(const Vector2& cell, const Dir4 dir) {
+    const auto& edge = game_->getRealMaze().edge(cell, dir);
+    const auto num_traveled = ++edge.num_traveled;
+    const auto quad = edgeQuadIndex(cell, dir);
+    setQuadColor(
+        trail_, quad,
+        sf::Color(255, 255, 255, std::min(255, 215 + num_traveled * 10)));
+
+    // Once a patch would be as large as the trail, the trail is redrawn
+    if (trail_patch_.getVertexCount() >= trail_.getVertexCount()) {
+        trail_patch_.clear();
+        markDirty();
+        return;
+    }
+    for (std::size_t i = 4 * quad; i < 4 * quad + 4; ++i) {
+        trail_patch_.append(trail_[i]);
+    }
 }
 
 void MouseMazePlugin::teleport(const Vector2& position) {
     this->entity_position_ = position;
-    entity_position_pixel_ = {
-        (0.5f + static_cast<float>(position.x)) * CELL_SIDE_LENGTH_PIXEL,
-        (0.5f + static_cast<float>(position.y)) * CELL_SIDE_LENGTH_PIXEL
-    };
+    entity_position_pixel_ = cellCenterPixel(position);
+}
+
+sf::Vector2f MouseMazePlugin::cellCenterPixel(const Vector2& cell) {
+    return { (0.5f + static_cast<float>(cell.x)) * CELL_SIDE_LENGTH_PIXEL,
+             (0.5f + static_cast<float>(cell.y)) * CELL_SIDE_LENGTH_PIXEL };
+}
+
+void StateDisplayMazePlugin::renderFrame(float alpha) {
+    const auto state = game_->getPlugin<MouseMazePlugin>()->getState();
+    if (state != shown_state_) {
+        shown_state_ = state;
+        markDirty();
+    }
 }
 
 void StateDisplayMazePlugin::renderOnTexture(
     sf::RenderTexture& render_texture) {
-    const auto state =
-        this->game_->getPlugin<MouseMazePlugin>(MOUSE_MAZE_PLUGIN_NAME)
-            ->getState();
-
     auto text = sf::Text();
     text.setFont(font);
-    text.setString(getStringByState(state));
+    text.setString(toString(shown_state_));
     text.setCharacterSize(30);
-    text.setFillColor(getColorByState(state));
+    text.setFillColor(getColorByState(shown_state_));
 
     render_texture.draw(text);
 }
 
-std::string StateDisplayMazePlugin::getStringByState(const MouseState& state) {
-    switch (state) {
-        case MouseState::Stopped:
-            return "STOPPED";
-        case MouseState::Exploring:
-            return "EXPLORING";
-        case MouseState::ReturningToStart:
-            return "RETURNING TO START";
-        case MouseState::RushingToFinish:
-            return "RUSHING TO FINISH";
-    }
-}
-
 sf::Color StateDisplayMazePlugin::getColorByState(const MouseState& state) {
     static const auto COLOR_STOPPED = sf::Color(239, 71, 111);
     static const auto COLOR_EXPLORING = sf::Color(255, 209, 102);
@@ -425,4 +412,56 @@ sf::Color StateDisplayMazePlugin::getColorByState(const MouseState& state) {
     }
 }
 
+ProfileOverlayMazePlugin::ProfileOverlayMazePlugin(Game* game) :
+    MazePlugin(game, 15) {
+    font_.loadFromFile(ROBOTO_SLAB_REGULAR_FONT_PATH);
+    getSprite().setPosition({ 15, 55 });
+}
+
+void ProfileOverlayMazePlugin::renderFrame(float alpha) {
+    const auto shown = game_->isProfileOverlayShown();
+    if (shown && (!was_shown_ ||
+                  refresh_clock_.getElapsedTime().asMilliseconds() >=
+                      PROFILE_OVERLAY_REFRESH_MS)) {
+        refresh_clock_.restart();
+        markDirty();
+    }
+    was_shown_ = shown;
+}
+
+void ProfileOverlayMazePlugin::draw(
+    sf::RenderTarget& target, const sf::RenderStates states) const {
+    if (game_->isProfileOverlayShown()) {
+        MazePlugin::draw(target, states);
+    }
+}
+
+void ProfileOverlayMazePlugin::renderOnTexture(
+    sf::RenderTexture& render_texture) {
+    static const auto BACKGROUND_COLOR = sf::Color(13, 19, 33, 200);
+    static constexpr auto LINE_HEIGHT_PIXEL = 18;
+
+    std::ostringstream lines;
+    lines << "ms per frame    update    draw\n" << std::fixed
+          << std::setprecision(3);
+    for (const auto& profile : game_->getProfiles()) {
+        lines << profile.name << "    " << profile.recentUpdateUs / 1000
+              << "    " << profile.recentDrawUs / 1000 << '\n';
+    }
+
+    const auto num_lines = game_->getProfiles().size() + 1;
+    sf::RectangleShape background(
+        { 520, static_cast<float>(num_lines * LINE_HEIGHT_PIXEL + 10) });
+    background.setFillColor(BACKGROUND_COLOR);
+    render_texture.draw(background);
+
+    auto text = sf::Text();
+    text.setFont(font_);
+    text.setString(lines.str());
+    text.setCharacterSize(14);
+    text.setFillColor(sf::Color::White);
+    text.setPosition(5, 5);
+    render_texture.draw(text);
+}
+
 }  // namespace MazemouseSimulator
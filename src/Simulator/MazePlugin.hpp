@@ -3,6 +3,8 @@
 
 #include "../Maze/Maze.hpp"
 #include "../Mouse/SemiFinishedMouse.hpp"
+#include "../Simulation/EventClock.hpp"
+#include "../Simulation/Simulation.hpp"
 #include "Game.hpp"
 
 using namespace Mazemouse;
@@ -16,6 +18,13 @@ constexpr auto MOUSE_RADIUS = CELL_SIDE_LENGTH_PIXEL / 3;
 constexpr auto MOUSE_EXPLORING_VELOCITY = 288.f / 1000;
 constexpr auto MOUSE_RUSHING_VELOCITY = 576.f / 1000;
 
+/**
+ * The number of edges between two cells of the real maze, each of which has
+ * a quad in the wall and trail layers.
+ */
+constexpr auto NUM_INTERIOR_EDGES =
+    2 * REAL_MAZE_SIDE_LENGTH * (REAL_MAZE_SIDE_LENGTH - 1);
+
 const auto ROBOTO_SLAB_REGULAR_FONT_PATH = "../assets/RobotoSlab-Regular.ttf";
 
 const auto PERIPHERAL_WALL_MAZE_PLUGIN_NAME =
@@ -24,6 +33,12 @@ const auto FLOOR_MAZE_PLUGIN_NAME = "FLOOR_MAZE_PLUGIN_NAME";
 const auto WALL_MAZE_PLUGIN_NAME = "WALL_MAZE_PLUGIN_NAME";
 const auto MOUSE_MAZE_PLUGIN_NAME = "MOUSE_MAZE_PLUGIN_NAME";
 const auto STATE_DISPLAY_PLUGIN_NAME = "STATE_DISPLAY_PLUGIN_NAME";
+const auto PROFILE_OVERLAY_PLUGIN_NAME = "PROFILE_OVERLAY_PLUGIN_NAME";
+
+/**
+ * How often the profile overlay redraws its numbers, in milliseconds.
+ */
+constexpr auto PROFILE_OVERLAY_REFRESH_MS = 500;
 
 constexpr auto MAZE_PATH_CURVING_SEED = 10086;
 
@@ -45,13 +60,31 @@ class MazePlugin : public GamePlugin {
 
  protected:
     int marginPixel_;
+
+    /**
+     * @brief Returns the quad of an edge between two cells of the real maze
+     * in the wall and trail layers: first the right edges, then the bottom
+     * edges, each row by row.
+     */
+    [[nodiscard]] static std::size_t edgeQuadIndex(
+        const Vector2& cell, Dir4 dir);
+
+    /**
+     * @brief Sets the corners and color of a quad in a vertex array of
+     * `sf::Quads`.
+     */
+    static void setQuad(
+        sf::VertexArray& vertices, std::size_t quad,
+        const sf::Vector2f& position, const sf::Vector2f& size,
+        const sf::Color& color);
+
+    static void setQuadColor(
+        sf::VertexArray& vertices, std::size_t quad, const sf::Color& color);
 };
 
 class PeripheralWallMazePlugin final : public MazePlugin {
  public:
-    explicit PeripheralWallMazePlugin(Game* game) : MazePlugin(game, 0) {
-        render();
-    }
+    explicit PeripheralWallMazePlugin(Game* game) : MazePlugin(game, 0) {}
 
     std::string getName() override { return PERIPHERAL_WALL_MAZE_PLUGIN_NAME; }
 
@@ -66,24 +99,26 @@ class PeripheralWallMazePlugin final : public MazePlugin {
 
 class FloorMazePlugin final : public MazePlugin {
  public:
-    explicit FloorMazePlugin(Game* game) : MazePlugin(game, MAZE_MARGIN_PIXEL) {
-        render();
-    }
+    explicit FloorMazePlugin(Game* game);
 
     std::string getName() override { return FLOOR_MAZE_PLUGIN_NAME; }
 
  protected:
     void renderOnTexture(sf::RenderTexture& render_texture) override;
 
-    static void renderGoalArea(sf::RenderTexture& render_texture);
+ private:
+    static constexpr auto NUM_TILES =
+        REAL_MAZE_SIDE_LENGTH * REAL_MAZE_SIDE_LENGTH + 1;
+
+    /**
+     * The tiles of every cell, then the goal area.
+     */
+    sf::VertexArray tiles_{ sf::Quads, 4 * NUM_TILES };
 };
 
 class WallMazePlugin final : public MazePlugin {
  public:
-    explicit WallMazePlugin(Game* game) : MazePlugin(game, MAZE_MARGIN_PIXEL) {
-        carvePaths(MAZE_PATH_CURVING_SEED);
-        render();
-    }
+    explicit WallMazePlugin(Game* game);
 
     std::string getName() override { return WALL_MAZE_PLUGIN_NAME; }
 
@@ -91,7 +126,16 @@ class WallMazePlugin final : public MazePlugin {
     void renderOnTexture(sf::RenderTexture& render_texture) override;
 
  public:
-    void carvePaths(int seed) const;
+    /**
+     * @brief Carves a new real maze and redraws the walls in the next frame.
+     */
+    void carvePaths(int seed);
+
+ private:
+    /**
+     * A quad for every interior edge, transparent where there is no wall.
+     */
+    sf::VertexArray walls_{ sf::Quads, 4 * NUM_INTERIOR_EDGES };
 };
 
 class MouseMazePlugin final : public MazePlugin,
@@ -107,21 +151,46 @@ class MouseMazePlugin final : public MazePlugin,
 
     void hardwareTurn(Dir4 relative_dir) override;
 
+    void hardwareRunPrimitive(const MotionPrimitive& primitive) override;
+
     void nextExploringCycle() override;
 
     void moveForward(int length) override;
 
     [[nodiscard]] MouseState getState() const { return state; }
 
+    /**
+     * @brief Draws the cached trail, then the mouse on top of it.
+     */
+    void draw(sf::RenderTarget& target, sf::RenderStates states)
+        const override;
+
  protected:
     void renderOnTexture(sf::RenderTexture& render_texture) override;
 
     void update(int dt) override;
 
- private:
-    bool running_{ false };
+    void renderFrame(float alpha) override;
 
-    unsigned moving_time_ms_{ 0 };
+ private:
+    /**
+     * Schedules the mouse's sensor reads, planning and motions, and drives
+     * its cycles: the next cycle starts when the last event of the previous
+     * one fires.
+     */
+    EventClock clock_{};
+
+    /**
+     * A quad for every interior edge, transparent until the mouse has
+     * traveled through it.
+     */
+    sf::VertexArray trail_{ sf::Quads, 4 * NUM_INTERIOR_EDGES };
+
+    /**
+     * The trail quads patched since the last frame, which the next frame
+     * draws over the retained trail instead of redrawing all of it.
+     */
+    sf::VertexArray trail_patch_{ sf::Quads };
 
     Dir4 entity_orientation_{ Dir4::Up };
 
@@ -131,11 +200,51 @@ class MouseMazePlugin final : public MazePlugin,
 
     sf::Vector2f entity_position_pixel_{ 0, 0 };
 
-    void renderEdges(sf::RenderTexture& render_texture) const;
+    /**
+     * `entity_position_pixel_` before the last simulation step.
+     */
+    sf::Vector2f previous_position_pixel_{ 0, 0 };
+
+    /**
+     * Where the mouse is drawn, between the last two simulation steps.
+     */
+    sf::Vector2f render_position_pixel_{ 0, 0 };
+
+    /**
+     * The simulated times, in seconds, the current motion starts and
+     * finishes at.
+     */
+    double motion_start_time_{ 0 };
+
+    double motion_end_time_{ 0 };
+
+    sf::Vector2f motion_origin_pixel_{ 0, 0 };
+
+    /**
+     * @brief Runs one cycle of the mouse, which schedules its events.
+     */
+    void runCycle();
+
+    /**
+     * @brief Schedules a motion of the given duration in seconds towards
+     * `entity_destination_`.
+     */
+    void startMotion(double duration);
+
+    void handleEvent(const ScheduledEvent& event);
 
-    void renderMouse(sf::RenderTexture& render_texture) const;
+    /**
+     * @brief Counts a travel through an edge of the real maze and patches its
+     * quad in the trail and in `trail_patch_`.
+     */
+    void travel(const Vector2& cell, Dir4 dir);
+
+    void renderMouse(
+        sf::RenderTarget& target, const sf::RenderStates& states) const;
 
     void teleport(const Vector2& position);
+
+    [[nodiscard]] static sf::Vector2f cellCenterPixel(const Vector2& cell);
 };
 
 class StateDisplayMazePlugin final : public MazePlugin {
@@ -146,16 +255,47 @@ class StateDisplayMazePlugin final : public MazePlugin {
 
     std::string getName() override { return STATE_DISPLAY_PLUGIN_NAME; }
 
-    void update(int dt) override { render(); }
+    void update(int dt) override {}
+
+    void renderFrame(float alpha) override;
+
+    static sf::Color getColorByState(const MouseState& state);
 
  protected:
     void renderOnTexture(sf::RenderTexture& render_texture) override;
 
-    static std::string getStringByState(const MouseState& state);
+    sf::Font font;
 
-    static sf::Color getColorByState(const MouseState& state);
+    /**
+     * The state shown by the texture.
+     */
+    MouseState shown_state_{ MouseState::Stopped };
+};
 
-    sf::Font font;
+/**
+ * @brief Shows the smoothed update and draw time of every plugin per frame,
+ * while `Game::isProfileOverlayShown()`.
+ */
+class ProfileOverlayMazePlugin final : public MazePlugin {
+ public:
+    explicit ProfileOverlayMazePlugin(Game* game);
+
+    std::string getName() override { return PROFILE_OVERLAY_PLUGIN_NAME; }
+
+    void renderFrame(float alpha) override;
+
+    void draw(sf::RenderTarget& target, sf::RenderStates states)
+        const override;
+
+ protected:
+    void renderOnTexture(sf::RenderTexture& render_texture) override;
+
+ private:
+    sf::Font font_;
+
+    sf::Clock refresh_clock_;
+
+    bool was_shown_{ false };
 };
 
 }  // namespace MazemouseSimulator
@@ -0,0 +1,231 @@
+#include "TiledViewerPlugin.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include "../Maze/MazeGenerator.hpp"
+#include "../Simulation/Tournament.hpp"
+
+namespace MazemouseSimulator {
+
+namespace {
+
+void appendQuad(
+    sf::VertexArray& vertices, const sf::Vector2f& position,
+    const sf::Vector2f& size, const sf::Color& color) {
+    vertices.append({ position, color });
+    vertices.append({ { position.x + size.x, position.y }, color });
+    vertices.append({ position + size, color });
+    vertices.append({ { position.x, position.y + size.y }, color });
+}
+
+sf::Color trailColor(const int num_traveled) {
+    return num_traveled == 0
+               ? sf::Color::Transparent
+               : sf::Color(
+                     255, 255, 255, std::min(255, 215 + num_traveled * 10));
+}
+
+}  // namespace
+
+TiledViewerPlugin::TiledViewerPlugin(
+    Game* game, std::vector<TiledRun> runs, const int mazeSize) :
+    MazePlugin(game, 0), runs_(std::move(runs)), maze_size_(mazeSize),
+    num_edges_(0), columns_(0), tile_pixel_(0), cell_pixel_(0),
+    time_scale_(game->getTimeScale()) {
+    const int num_runs = static_cast<int>(runs_.size());
+    if (num_runs < MIN_TILED_RUNS || num_runs > MAX_TILED_RUNS) {
+        throw std::invalid_argument(
+            "TiledViewerPlugin(): the number of runs must be between 4 and "
+            "64");
+    }
+    font_.loadFromFile(ROBOTO_SLAB_REGULAR_FONT_PATH);
+
+    columns_ =
+        static_cast<int>(std::ceil(std::sqrt(static_cast<double>(num_runs))));
+    // Square tiles in a square grid, which fits the shorter side of the
+    // window
+    const auto& window_size = game->getOptions().windowSize;
+    const auto window_pixel =
+        static_cast<float>(std::min(window_size.x, window_size.y));
+    tile_pixel_ = window_pixel / static_cast<float>(columns_);
+    cell_pixel_ = (tile_pixel_ - 2 * TILE_PADDING_PIXEL -
+                   TILE_LABEL_HEIGHT_PIXEL) /
+                  static_cast<float>(maze_size_);
+
+    // The built-in tournament entries know how to create every mouse by name
+    const auto entries = Mazemouse::builtInMice(SIMULATION_MAX_CYCLES);
+
+    mice_.resize(3 * num_runs);
+    for (int tile = 0; tile < num_runs; ++tile) {
+        const auto& run = runs_[tile];
+        const auto entry = std::find_if(
+            entries.begin(), entries.end(),
+            [&](const auto& e) { return e.name == run.mouse; });
+        if (entry == entries.end() || !entry->factory) {
+            throw std::invalid_argument(
+                "TiledViewerPlugin(): unknown mouse: " + run.mouse);
+        }
+
+        SimulationMaze maze(maze_size_, maze_size_);
+        Mazemouse::carvePaths(maze, run.seed);
+        num_edges_ = maze.numEdges();
+        addWalls(tile, maze);
+        addTrail(tile, maze);
+        shown_traveled_.emplace_back(num_edges_, 0);
+
+        simulations_.push_back(std::make_unique<LiveSimulation>(
+            run.mouse + " #" + std::to_string(run.seed),
+            entry->factory(maze), time_scale_));
+        showSnapshot(tile, simulations_.back()->latest());
+    }
+}
+
+void TiledViewerPlugin::renderFrame(const float alpha) {
+    if (game_->getTimeScale() != time_scale_) {
+        time_scale_ = game_->getTimeScale();
+        for (const auto& simulation : simulations_) {
+            simulation->setTimeScale(time_scale_);
+        }
+    }
+
+    for (int tile = 0; tile < static_cast<int>(simulations_.size()); ++tile) {
+        auto& simulation = *simulations_[tile];
+        if (simulation.hasFresh()) {
+            showSnapshot(tile, simulation.latest());
+        }
+    }
+}
+
+void TiledViewerPlugin::draw(
+    sf::RenderTarget& target, const sf::RenderStates states) const {
+    MazePlugin::draw(target, states);
+    target.draw(trails_, states);
+    target.draw(mice_, states);
+}
+
+void TiledViewerPlugin::renderOnTexture(sf::RenderTexture& render_texture) {
+    render_texture.draw(walls_);
+
+    auto text = sf::Text();
+    text.setFont(font_);
+    text.setCharacterSize(TILE_LABEL_HEIGHT_PIXEL - 4);
+    text.setFillColor(sf::Color::Black);
+    for (int tile = 0; tile < static_cast<int>(simulations_.size()); ++tile) {
+        const auto origin = mazeOrigin(tile);
+        text.setString(simulations_[tile]->getLabel());
+        text.setPosition(origin.x, origin.y - TILE_LABEL_HEIGHT_PIXEL);
+        render_texture.draw(text);
+    }
+}
+
+sf::Vector2f TiledViewerPlugin::mazeOrigin(const int tile) const {
+    return { static_cast<float>(tile % columns_) * tile_pixel_ +
+                 TILE_PADDING_PIXEL,
+             static_cast<float>(tile / columns_) * tile_pixel_ +
+                 TILE_PADDING_PIXEL + TILE_LABEL_HEIGHT_PIXEL };
+}
+
+sf::Vector2f TiledViewerPlugin::cellCentre(
+    const int tile, const Vector2& cell) const {
+    const auto origin = mazeOrigin(tile);
+    return { origin.x + (static_cast<float>(cell.x) + 0.5f) * cell_pixel_,
+             origin.y + (static_cast<float>(cell.y) + 0.5f) * cell_pixel_ };
+}
+
+void TiledViewerPlugin::addWalls(const int tile, const SimulationMaze& maze) {
+    static const auto FLOOR_COLOR = sf::Color(255, 221, 210);
+    static const auto WALL_COLOR = sf::Color(13, 19, 33);
+
+    const auto origin = mazeOrigin(tile);
+    const auto maze_pixel = cell_pixel_ * static_cast<float>(maze_size_);
+    const auto thickness = std::max(1.f, cell_pixel_ / 9);
+    const auto half = thickness / 2;
+
+    appendQuad(walls_, origin, { maze_pixel, maze_pixel }, FLOOR_COLOR);
+    appendQuad(
+        walls_, { origin.x - half, origin.y - half },
+        { maze_pixel + thickness, thickness }, WALL_COLOR);
+    appendQuad(
+        walls_, { origin.x - half, origin.y + maze_pixel - half },
+        { maze_pixel + thickness, thickness }, WALL_COLOR);
+    appendQuad(
+        walls_, { origin.x - half, origin.y - half },
+        { thickness, maze_pixel + thickness }, WALL_COLOR);
+    appendQuad(
+        walls_, { origin.x + maze_pixel - half, origin.y - half },
+        { thickness, maze_pixel + thickness }, WALL_COLOR);
+
+    for (int x = 0; x < maze_size_; ++x) {
+        for (int y = 0; y < maze_size_; ++y) {
+            const sf::Vector2f corner = {
+                origin.x + static_cast<float>(x) * cell_pixel_,
+                origin.y + static_cast<float>(y) * cell_pixel_
+            };
+            const Vector2 cell = { x, y };
+            if (x < maze_size_ - 1 && maze.edge(cell, Dir4::Right).hasWall) {
+                appendQuad(
+                    walls_, { corner.x + cell_pixel_ - half, corner.y },
+                    { thickness, cell_pixel_ }, WALL_COLOR);
+            }
+            if (y < maze_size_ - 1 && maze.edge(cell, Dir4::Down).hasWall) {
+                appendQuad(
+                    walls_, { corner.x, corner.y + cell_pixel_ - half },
+                    { cell_pixel_, thickness }, WALL_COLOR);
+            }
+        }
+    }
+}
+
+void TiledViewerPlugin::addTrail(const int tile, const SimulationMaze& maze) {
+    const auto thickness = std::max(1.f, cell_pixel_ / 18);
+    trails_.resize(4 * static_cast<std::size_t>(tile + 1) * num_edges_);
+
+    for (int x = 0; x < maze_size_; ++x) {
+        for (int y = 0; y < maze_size_; ++y) {
+            const auto centre = cellCentre(tile, { x, y });
+            if (x < maze_size_ - 1) {
+                setQuad(
+                    trails_,
+                    tile * num_edges_ + maze.edgeIndex({ x, y }, Dir4::Right),
+                    { centre.x, centre.y - thickness / 2 },
+                    { cell_pixel_, thickness },
+                    sf::Color::Transparent);
+            }
+            if (y < maze_size_ - 1) {
+                setQuad(
+                    trails_,
+                    tile * num_edges_ + maze.edgeIndex({ x, y }, Dir4::Down),
+                    { centre.x - thickness / 2, centre.y },
+                    { thickness, cell_pixel_ },
+                    sf::Color::Transparent);
+            }
+        }
+    }
+}
+
+void TiledViewerPlugin::showSnapshot(
+    const int tile, const SimulationSnapshot& snapshot) {
+    auto& shown = shown_traveled_[tile];
+    for (int i = 0; i < num_edges_; ++i) {
+        if (snapshot.numTraveled[i] != shown[i]) {
+            shown[i] = snapshot.numTraveled[i];
+            setQuadColor(trails_, tile * num_edges_ + i, trailColor(shown[i]));
+        }
+    }
+
+    // A triangle pointing towards the orientation of the mouse
+    const auto centre = cellCentre(tile, snapshot.position);
+    const auto forward = get_vector(snapshot.orientation);
+    const sf::Vector2f ahead = { static_cast<float>(forward.x),
+                                 static_cast<float>(forward.y) };
+    const sf::Vector2f side = { -ahead.y, ahead.x };
+    const auto radius = cell_pixel_ / 3;
+    const auto color =
+        StateDisplayMazePlugin::getColorByState(snapshot.state);
+    auto* const corners = &mice_[3 * tile];
+    corners[0] = { centre + ahead * radius, color };
+    corners[1] = { centre - ahead * radius + side * radius, color };
+    corners[2] = { centre - ahead * radius - side * radius, color };
+}
+
+}  // namespace MazemouseSimulator
@@ -0,0 +1,138 @@
+#ifndef TILED_VIEWER_PLUGIN_HPP
+#define TILED_VIEWER_PLUGIN_HPP
+
+#include <memory>
+#include <string>
+#include <vector>
+#include "../Simulation/LiveSimulation.hpp"
+#include "MazePlugin.hpp"
+
+namespace MazemouseSimulator {
+
+const auto TILED_VIEWER_PLUGIN_NAME = "TILED_VIEWER_PLUGIN_NAME";
+
+constexpr auto MIN_TILED_RUNS = 4;
+constexpr auto MAX_TILED_RUNS = 64;
+
+constexpr auto TILE_PADDING_PIXEL = 6;
+constexpr auto TILE_LABEL_HEIGHT_PIXEL = 16;
+
+/**
+ * @brief One run of the tiled viewer.
+ */
+struct TiledRun {
+    /**
+     * The name of a tournament mouse, e.g. "flood-fill".
+     */
+    std::string mouse;
+
+    /**
+     * The seed the real maze is carved with.
+     */
+    int seed{ MAZE_PATH_CURVING_SEED };
+};
+
+/**
+ * @brief Watches many runs side by side, one tile per run.
+ *
+ * Every run is a `LiveSimulation` on a worker thread of its own, paced at
+ * the time scale of the game. The plugin only reads their latest snapshots,
+ * so drawing never holds up a simulation. The maze backgrounds, walls and
+ * labels are retained in the plugin's texture; the trails and mice of all
+ * tiles are one vertex array each, patched from the snapshots that have
+ * changed since the last frame.
+ */
+class TiledViewerPlugin final : public MazePlugin {
+ public:
+    /**
+     * @brief Carves the real mazes and starts every run.
+     *
+     * @param runs The runs to show, between `MIN_TILED_RUNS` and
+     * `MAX_TILED_RUNS`.
+     * @param mazeSize The side length of the real mazes.
+     * @throws std::invalid_argument if the number of runs is out of range or
+     * a mouse is not a tournament mouse.
+     */
+    TiledViewerPlugin(Game* game, std::vector<TiledRun> runs, int mazeSize);
+
+    std::string getName() override { return TILED_VIEWER_PLUGIN_NAME; }
+
+    void update(int dt) override {}
+
+    void renderFrame(float alpha) override;
+
+    void draw(sf::RenderTarget& target, sf::RenderStates states)
+        const override;
+
+ protected:
+    void renderOnTexture(sf::RenderTexture& render_texture) override;
+
+ private:
+    std::vector<TiledRun> runs_;
+
+    int maze_size_;
+
+    int num_edges_;
+
+    /**
+     * The number of tiles in every row of the grid.
+     */
+    int columns_;
+
+    /**
+     * The side length of a tile, and of a cell within it, in pixels.
+     */
+    float tile_pixel_;
+
+    float cell_pixel_;
+
+    std::vector<std::unique_ptr<LiveSimulation>> simulations_;
+
+    /**
+     * The trail counts drawn for every tile, to patch only what changed.
+     */
+    std::vector<std::vector<int>> shown_traveled_;
+
+    /**
+     * The maze backgrounds and walls of all tiles.
+     */
+    sf::VertexArray walls_{ sf::Quads };
+
+    /**
+     * A quad for every interior edge of every tile.
+     */
+    sf::VertexArray trails_{ sf::Quads };
+
+    /**
+     * A triangle for the mouse of every tile, colored by its state.
+     */
+    sf::VertexArray mice_{ sf::Triangles };
+
+    sf::Font font_;
+
+    int time_scale_;
+
+    /**
+     * @brief Returns the top-left corner of the maze of a tile.
+     */
+    [[nodiscard]] sf::Vector2f mazeOrigin(int tile) const;
+
+    /**
+     * @brief Returns the centre of a cell of a tile.
+     */
+    [[nodiscard]] sf::Vector2f cellCentre(
+        int tile, const Vector2& cell) const;
+
+    void addWalls(int tile, const SimulationMaze& maze);
+
+    void addTrail(int tile, const SimulationMaze& maze);
+
+    /**
+     * @brief Updates the trail and mouse of a tile from a snapshot.
+     */
+    void showSnapshot(int tile, const SimulationSnapshot& snapshot);
+};
+
+}  // namespace MazemouseSimulator
+
+#endif
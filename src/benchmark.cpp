@@ -0,0 +1,256 @@
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+#include "Maze/MazeGenerator.hpp"
+#include "Mouse/CompactMouse.hpp"
+#include "Mouse/TimeOptimalMouse.hpp"
+#include "Simulation/BatchSimulation.hpp"
+#include "Simulation/Tournament.hpp"
+
+using namespace Mazemouse;
+
+namespace {
+
+struct BenchmarkOptions {
+    int numMazes{ 200 };
+
+    int size{ 16 };
+
+    int seed{ 10086 };
+
+    int repeat{ 5 };
+};
+
+void printUsage(const char* program) {
+    std::cerr << "Usage: " << program << " [options]\n"
+              << "  --mazes <n>     number of mazes to generate (200)\n"
+              << "  --size <n>      maze side length (16)\n"
+              << "  --seed <n>      seed of the first maze (10086)\n"
+              << "  --repeat <n>    runs of every maze per binding (5)\n";
+}
+
+/**
+ * @brief Runs a simulation of a mouse in every maze and returns the time per
+ * cycle. The simulations are created before the clock starts, so only their
+ * `run()` is timed.
+ *
+ * @param mouseMaze The maze of every mouse, if it has a runtime size.
+ */
+template <typename Mouse, typename Setup, typename... MazeArgs>
+double timeRuns(
+    const std::vector<SimulationMaze>& mazes, const int repeat, Setup setup,
+    const MazeArgs&... mouseMaze) {
+    std::vector<std::unique_ptr<Simulation<Mouse>>> simulations;
+    simulations.reserve(mazes.size());
+    long cycles = 0;
+    std::chrono::steady_clock::duration elapsed{};
+    for (int r = 0; r < repeat; ++r) {
+        simulations.clear();
+        for (const auto& maze : mazes) {
+            simulations.push_back(std::make_unique<Simulation<Mouse>>(
+                maze, Vector2{ 0, maze.height() - 1 },
+                MOUSE_STARTING_ORIENTATION, mouseMaze...));
+            setup(*simulations.back());
+        }
+
+        const auto start = std::chrono::steady_clock::now();
+        for (const auto& simulation : simulations) {
+            cycles += simulation->run(SIMULATION_MAX_CYCLES).cycles;
+        }
+        elapsed += std::chrono::steady_clock::now() - start;
+    }
+
+    return std::chrono::duration<double, std::nano>(elapsed).count() /
+           static_cast<double>(cycles);
+}
+
+/**
+ * @brief Runs a mouse in every maze and returns the time per cycle, with
+ * the compile-time sized mouse like `simulate()` if the mazes have its size.
+ */
+template <
+    template <int, typename, typename, typename> class M, typename C,
+    typename Hw, typename Setup>
+double timeCycles(
+    const std::vector<SimulationMaze>& mazes, const int repeat,
+    Setup setup) {
+    const int width = mazes.front().width(), height = mazes.front().height();
+    if (width == TOURNAMENT_STATIC_SIZE && height == TOURNAMENT_STATIC_SIZE) {
+        return timeRuns<M<TOURNAMENT_STATIC_SIZE, C, Edge, Hw>>(
+            mazes, repeat, setup);
+    }
+
+    return timeRuns<M<DYNAMIC_SIZE, C, Edge, Hw>>(
+        mazes, repeat, setup, Maze<DYNAMIC_SIZE, C, Edge>(width, height));
+}
+
+/**
+ * @brief Prints the cycle time of a mouse with virtual and with static
+ * hardware calls.
+ */
+template <
+    template <int, typename, typename, typename> class M, typename C,
+    typename Setup = NoMouseSetup>
+void compare(
+    const std::string& name, const std::vector<SimulationMaze>& mazes,
+    const int repeat, Setup setup = {}) {
+    const double virtual_ns =
+        timeCycles<M, C, MouseHardwareInterface>(mazes, repeat, setup);
+    const double static_ns =
+        timeCycles<M, C, StaticHardware>(mazes, repeat, setup);
+
+    std::cout << std::left << std::setw(22) << name << std::right
+              << std::fixed << std::setprecision(1) << std::setw(12)
+              << virtual_ns << std::setw(12) << static_ns
+              << std::setprecision(2) << std::setw(10)
+              << virtual_ns / static_ns << "x\n";
+}
+
+/**
+ * @brief Runs a `BatchSimulation` in every maze and returns the time per
+ * cycle of a lane, timing only its `run()`.
+ */
+double timeBatchCycles(
+    const std::vector<SimulationMaze>& mazes, const int repeat,
+    const bool useAvx2) {
+    long cycles = 0;
+    std::chrono::steady_clock::duration elapsed{};
+    for (int r = 0; r < repeat; ++r) {
+        BatchSimulation batch(
+            mazes, { 0, mazes.front().height() - 1 },
+            MOUSE_STARTING_ORIENTATION);
+        batch.setUseAvx2(useAvx2);
+
+        const auto start = std::chrono::steady_clock::now();
+        batch.run();
+        elapsed += std::chrono::steady_clock::now() - start;
+        for (const auto& metrics : batch.getAllMetrics()) {
+            cycles += metrics.cycles;
+        }
+    }
+
+    return std::chrono::duration<double, std::nano>(elapsed).count() /
+           static_cast<double>(cycles);
+}
+
+/**
+ * @brief Prints the cycle time of the least-visited `FloodFillMouse` run one
+ * maze at a time with static hardware and in a `BatchSimulation` with either
+ * kernel, and the speedup of the batch over the single runs.
+ */
+void compareBatch(
+    const std::vector<SimulationMaze>& mazes, const int repeat) {
+    const double scalar_ns =
+        timeCycles<FloodFillMouse, FloodFillCell, StaticHardware>(
+            mazes, repeat, NoMouseSetup{});
+    const double avx2_ns = timeBatchCycles(mazes, repeat, true);
+    const double portable_ns = timeBatchCycles(mazes, repeat, false);
+
+    std::cout << '\n'
+              << std::left << std::setw(22) << "batch" << std::right
+              << std::setw(12) << "single ns" << std::setw(12) << "avx2 ns"
+              << std::setw(14) << "portable ns" << std::setw(11)
+              << "speedup\n";
+    std::cout << std::left << std::setw(22) << "flood-fill" << std::right
+              << std::fixed << std::setprecision(1) << std::setw(12)
+              << scalar_ns << std::setw(12) << avx2_ns << std::setw(14)
+              << portable_ns << std::setprecision(2) << std::setw(10)
+              << scalar_ns / (hasAvx2() ? avx2_ns : portable_ns) << "x\n";
+}
+
+/**
+ * @brief Prints the size of every compile-time sized mouse configuration and
+ * the budget it is checked against.
+ */
+void printMemoryFootprints() {
+    std::cout << std::left << std::setw(28) << "configuration" << std::right
+              << std::setw(10) << "bytes" << std::setw(10) << "budget\n";
+    for (const auto& footprint : MEMORY_FOOTPRINTS) {
+        std::cout << std::left << std::setw(28) << footprint.name
+                  << std::right << std::setw(10) << footprint.bytes
+                  << std::setw(10);
+        if (footprint.budget == 0) {
+            std::cout << "-";
+        } else {
+            std::cout << footprint.budget;
+        }
+        std::cout << '\n';
+    }
+    std::cout << '\n';
+}
+
+}  // namespace
+
+int main(const int argc, char* argv[]) {
+    BenchmarkOptions options;
+
+    try {
+        for (int i = 1; i < argc; ++i) {
+            const std::string arg = argv[i];
+            if (arg == "--help" || arg == "-h") {
+                printUsage(argv[0]);
+                return 0;
+            }
+            if (i + 1 >= argc) {
+                throw std::invalid_argument("missing value for " + arg);
+            }
+
+            const std::string value = argv[++i];
+            if (arg == "--mazes") {
+                options.numMazes = std::stoi(value);
+            } else if (arg == "--size") {
+                options.size = std::stoi(value);
+            } else if (arg == "--seed") {
+                options.seed = std::stoi(value);
+            } else if (arg == "--repeat") {
+                options.repeat = std::stoi(value);
+            } else {
+                throw std::invalid_argument("unknown option " + arg);
+            }
+        }
+        if (options.numMazes < 1 || options.size < 2 || options.repeat < 1) {
+            throw std::invalid_argument("invalid option value");
+        }
+    } catch (const std::exception& e) {
+        std::cerr << argv[0] << ": " << e.what() << '\n';
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    std::vector<SimulationMaze> mazes;
+    std::vector<int> seeds;
+    mazes.reserve(options.numMazes);
+    for (int i = 0; i < options.numMazes; ++i) {
+        mazes.emplace_back(options.size, options.size);
+        seeds.push_back(options.seed + i);
+    }
+    generateBatch(mazes, seeds);
+
+    printMemoryFootprints();
+
+    std::cout << std::left << std::setw(22) << "mouse" << std::right
+              << std::setw(12) << "virtual ns" << std::setw(12)
+              << "static ns" << std::setw(11) << "speedup\n";
+
+    const auto flood_fill = [](auto& mouse) {
+        mouse.exploration_mode = ExplorationMode::FloodFill;
+    };
+    const auto until_optimal = [](auto& mouse) {
+        mouse.exploration_mode = ExplorationMode::FloodFillUntilOptimal;
+    };
+    compare<FloodFillMouse, FloodFillCell>("flood-fill", mazes, options.repeat);
+    compare<FloodFillMouse, FloodFillCell>(
+        "flood-fill-distance", mazes, options.repeat, flood_fill);
+    compare<FloodFillMouse, FloodFillCell>(
+        "flood-fill-optimal", mazes, options.repeat, until_optimal);
+    compare<AStarMouse, AStarCell>("astar", mazes, options.repeat);
+    compare<TimeOptimalMouse, AStarCell>(
+        "time-optimal", mazes, options.repeat, flood_fill);
+
+    compareBatch(mazes, options.repeat);
+
+    return 0;
+}
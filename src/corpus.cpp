@@ -0,0 +1,168 @@
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "Maze/MazeCorpus.hpp"
+#include "Maze/MazeGenerator.hpp"
+
+using namespace Mazemouse;
+
+namespace {
+
+/**
+ * The number of mazes generated at a time before they are written out, so
+ * that a large corpus is generated with bounded memory.
+ */
+constexpr int CORPUS_GENERATE_CHUNK = 4096;
+
+using CorpusMaze = Maze<DYNAMIC_SIZE, Cell, Edge>;
+
+struct GenerateOptions {
+    int numMazes{ 1000 };
+    int width{ 16 };
+    int height{ 16 };
+    int seed{ 10086 };
+    MazeAlgorithm algorithm{ MazeAlgorithm::DepthFirst };
+    unsigned numThreads{ 0 };
+};
+
+void printUsage(const char* program) {
+    std::cerr
+        << "Usage: " << program << " generate <corpus> [options]\n"
+        << "       " << program << " import <corpus> <maze files...>\n"
+        << "       " << program << " info <corpus>\n"
+        << "Options of generate:\n"
+        << "  --mazes <n>            number of mazes to generate (1000)\n"
+        << "  --size <n>|<w>x<h>     maze size (16)\n"
+        << "  --seed <n>             seed of the first maze (10086)\n"
+        << "  --generator <name>     dfs, prim, kruskal, wilson, competition\n"
+        << "                         (dfs)\n"
+        << "  --threads <n>          worker threads, 0 for all cores (0)\n"
+        << "Maze files ending in .maz are binary; all others are text.\n";
+}
+
+void parseSize(const std::string& value, GenerateOptions& options) {
+    const auto x = value.find('x');
+    if (x == std::string::npos) {
+        options.width = options.height = std::stoi(value);
+    } else {
+        options.width = std::stoi(value.substr(0, x));
+        options.height = std::stoi(value.substr(x + 1));
+    }
+}
+
+void generate(const std::string& path, const GenerateOptions& options) {
+    MazeCorpusWriter writer(path, options.width, options.height);
+
+    std::vector<CorpusMaze> mazes;
+    std::vector<int> seeds;
+    for (int first = 0; first < options.numMazes;
+         first += CORPUS_GENERATE_CHUNK) {
+        const int count =
+            std::min(CORPUS_GENERATE_CHUNK, options.numMazes - first);
+        mazes.clear();
+        seeds.clear();
+        for (int i = 0; i < count; ++i) {
+            mazes.emplace_back(options.width, options.height);
+            seeds.push_back(options.seed + first + i);
+        }
+        generateBatch(mazes, seeds, options.numThreads, options.algorithm);
+
+        for (int i = 0; i < count; ++i) {
+            writer.write(mazes[i], static_cast<std::uint32_t>(seeds[i]));
+        }
+    }
+    writer.close();
+}
+
+void import(const std::string& path, const std::vector<std::string>& files) {
+    std::vector<ImportedMaze> mazes;
+    int max_width = 2, max_height = 2;
+    for (const auto& file : files) {
+        mazes.push_back(importMazeFile(file));
+        max_width = std::max(max_width, mazes.back().maze.width());
+        max_height = std::max(max_height, mazes.back().maze.height());
+    }
+
+    MazeCorpusWriter writer(path, max_width, max_height);
+    for (const auto& [maze, goal] : mazes) {
+        writer.write(maze, goal);
+    }
+    writer.close();
+}
+
+void info(const std::string& path) {
+    const auto start = std::chrono::steady_clock::now();
+    const MazeCorpus corpus(path);
+    const auto end = std::chrono::steady_clock::now();
+
+    const auto& header = corpus.getHeader();
+    std::cout << "mazes: " << corpus.size() << '\n'
+              << "max size: " << header.maxWidth << 'x' << header.maxHeight
+              << '\n'
+              << "record size: " << header.recordSize << " bytes\n"
+              << "opened in: "
+              << std::chrono::duration<double, std::milli>(end - start)
+                     .count()
+              << " ms\n";
+}
+
+}  // namespace
+
+int main(const int argc, char* argv[]) {
+    try {
+        if (argc >= 2 && (std::string(argv[1]) == "--help" ||
+                          std::string(argv[1]) == "-h")) {
+            printUsage(argv[0]);
+            return 0;
+        }
+        if (argc < 3) {
+            throw std::invalid_argument("missing command or corpus");
+        }
+
+        const std::string command = argv[1];
+        const std::string path = argv[2];
+        if (command == "info") {
+            info(path);
+        } else if (command == "import") {
+            const std::vector<std::string> files(argv + 3, argv + argc);
+            if (files.empty()) {
+                throw std::invalid_argument("no maze files to import");
+            }
+            import(path, files);
+        } else if (command == "generate") {
+            GenerateOptions options;
+            for (int i = 3; i < argc; ++i) {
+                const std::string arg = argv[i];
+                if (i + 1 >= argc) {
+                    throw std::invalid_argument("missing value for " + arg);
+                }
+
+                const std::string value = argv[++i];
+                if (arg == "--mazes") {
+                    options.numMazes = std::stoi(value);
+                } else if (arg == "--size") {
+                    parseSize(value, options);
+                } else if (arg == "--seed") {
+                    options.seed = std::stoi(value);
+                } else if (arg == "--generator") {
+                    options.algorithm = parseMazeAlgorithm(value);
+                } else if (arg == "--threads") {
+                    options.numThreads = std::stoul(value);
+                } else {
+                    throw std::invalid_argument("unknown option " + arg);
+                }
+            }
+            generate(path, options);
+        } else {
+            throw std::invalid_argument("unknown command " + command);
+        }
+    } catch (const std::exception& e) {
+        std::cerr << argv[0] << ": " << e.what() << '\n';
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    return 0;
+}
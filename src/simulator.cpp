@@ -1,8 +1,82 @@
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
 #include "Simulator.hpp"
 
 using namespace MazemouseSimulator;
 
-int main() {
+namespace {
+
+void printUsage(const char* program) {
+    std::cerr
+        << "Usage: " << program << " [options]\n"
+        << "  --tiles <n>            watch n runs side by side, 4 to 64 (off)\n"
+        << "  --mice <a,b,...>       mice of the tiles (flood-fill)\n"
+        << "  --seed <n>             seed of the first tiled maze (10086)\n"
+        << "  --size <n>             side length of the tiled mazes (16)\n";
+}
+
+std::vector<std::string> splitNames(const std::string& value) {
+    std::vector<std::string> names;
+    std::istringstream stream(value);
+    for (std::string name; std::getline(stream, name, ',');) {
+        if (!name.empty()) {
+            names.push_back(name);
+        }
+    }
+    if (names.empty()) {
+        throw std::invalid_argument("no mice in " + value);
+    }
+
+    return names;
+}
+
+}  // namespace
+
+int main(const int argc, char* argv[]) {
+    int num_tiles = 0;
+    std::vector<std::string> mice{ "flood-fill" };
+    int seed = MAZE_PATH_CURVING_SEED;
+    int size = 16;
+
+    std::vector<TiledRun> runs;
+    try {
+        for (int i = 1; i < argc; ++i) {
+            const std::string arg = argv[i];
+            if (arg == "--help" || arg == "-h") {
+                printUsage(argv[0]);
+                return 0;
+            }
+            if (i + 1 >= argc) {
+                throw std::invalid_argument("missing value for " + arg);
+            }
+
+            const std::string value = argv[++i];
+            if (arg == "--tiles") {
+                num_tiles = std::stoi(value);
+            } else if (arg == "--mice") {
+                mice = splitNames(value);
+            } else if (arg == "--seed") {
+                seed = std::stoi(value);
+            } else if (arg == "--size") {
+                size = std::stoi(value);
+            } else {
+                throw std::invalid_argument("unknown option " + arg);
+            }
+        }
+
+        // Every mouse runs in the same maze before the next seed is taken
+        const int num_mice = static_cast<int>(mice.size());
+        for (int i = 0; i < num_tiles; ++i) {
+            runs.push_back({ mice[i % num_mice], seed + i / num_mice });
+        }
+    } catch (const std::exception& e) {
+        std::cerr << argv[0] << ": " << e.what() << '\n';
+        printUsage(argv[0]);
+        return 1;
+    }
+
     auto game = Game::create([](auto& options) {
         const auto [x, y] = MazePlugin::getWindowSize();
         options.windowSize.x = x;
@@ -10,11 +84,25 @@ int main() {
 
         options.fps = 60;
     });
+    if (!runs.empty()) {
+        try {
+            game.usePlugin<TiledViewerPlugin>(std::move(runs), size);
+        } catch (const std::exception& e) {
+            std::cerr << argv[0] << ": " << e.what() << '\n';
+            return 1;
+        }
+        game.usePlugin<ProfileOverlayMazePlugin>();
+        game.run();
+
+        return 0;
+    }
+
     game.usePlugin<FloorMazePlugin>();
     game.usePlugin<WallMazePlugin>();
     game.usePlugin<PeripheralWallMazePlugin>();
     game.usePlugin<MouseMazePlugin>();
     game.usePlugin<StateDisplayMazePlugin>();
+    game.usePlugin<ProfileOverlayMazePlugin>();
     game.run();
 
     return 0;
@@ -0,0 +1,111 @@
+#include <fstream>
+#include <iostream>
+#include <string>
+#include "Simulation/Tournament.hpp"
+
+using namespace Mazemouse;
+
+namespace {
+
+void printUsage(const char* program) {
+    std::cerr
+        << "Usage: " << program << " [options]\n"
+        << "  --mazes <n>            number of mazes to generate (100)\n"
+        << "  --size <n>|<w>x<h>     maze size (16)\n"
+        << "  --seed <n>             seed of the first maze (10086)\n"
+        << "  --generator <name>     dfs, prim, kruskal, wilson, competition\n"
+        << "                         (dfs)\n"
+        << "  --corpus <file>        run in the mazes of a corpus file\n"
+        << "  --threads <n>          worker threads, 0 for all cores (0)\n"
+        << "  --max-cycles <n>       cycle limit per run (1000000)\n"
+        << "  --batch on|off         run the least-visited flood fill in\n"
+        << "                         batches of mazes (off)\n"
+        << "  --format csv|json      output format (csv)\n"
+        << "  --output <file>        output file (stdout)\n";
+}
+
+void parseSize(const std::string& value, TournamentOptions& options) {
+    const auto x = value.find('x');
+    if (x == std::string::npos) {
+        options.width = options.height = std::stoi(value);
+    } else {
+        options.width = std::stoi(value.substr(0, x));
+        options.height = std::stoi(value.substr(x + 1));
+    }
+}
+
+}  // namespace
+
+int main(const int argc, char* argv[]) {
+    TournamentOptions options;
+    std::string format = "csv";
+    std::string output;
+
+    try {
+        for (int i = 1; i < argc; ++i) {
+            const std::string arg = argv[i];
+            if (arg == "--help" || arg == "-h") {
+                printUsage(argv[0]);
+                return 0;
+            }
+            if (i + 1 >= argc) {
+                throw std::invalid_argument("missing value for " + arg);
+            }
+
+            const std::string value = argv[++i];
+            if (arg == "--mazes") {
+                options.numMazes = std::stoi(value);
+            } else if (arg == "--size") {
+                parseSize(value, options);
+            } else if (arg == "--seed") {
+                options.seed = std::stoi(value);
+            } else if (arg == "--generator") {
+                options.algorithm = parseMazeAlgorithm(value);
+            } else if (arg == "--corpus") {
+                options.corpusPath = value;
+            } else if (arg == "--threads") {
+                options.numThreads = std::stoul(value);
+            } else if (arg == "--max-cycles") {
+                options.maxCycles = std::stol(value);
+            } else if (arg == "--batch") {
+                if (value != "on" && value != "off") {
+                    throw std::invalid_argument("invalid --batch " + value);
+                }
+                options.batch = value == "on";
+            } else if (arg == "--format") {
+                format = value;
+            } else if (arg == "--output") {
+                output = value;
+            } else {
+                throw std::invalid_argument("unknown option " + arg);
+            }
+        }
+        if (format != "csv" && format != "json") {
+            throw std::invalid_argument("unknown format " + format);
+        }
+
+        const Tournament tournament(options);
+        const auto results = tournament.run();
+
+        std::ofstream file;
+        if (!output.empty()) {
+            file.open(output);
+            if (!file) {
+                throw std::invalid_argument("cannot open " + output);
+            }
+        }
+        std::ostream& os = output.empty() ? std::cout : file;
+
+        if (format == "json") {
+            Tournament::writeJson(os, results);
+        } else {
+            Tournament::writeCsv(os, results);
+        }
+    } catch (const std::exception& e) {
+        std::cerr << argv[0] << ": " << e.what() << '\n';
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,174 @@
+#include <queue>
+#include <vector>
+#include "../src/Maze/MazeGenerator.hpp"
+#include "../src/Mouse/AStarMouse.hpp"
+#include "../src/Simulation/Simulation.hpp"
+#include "Check.hpp"
+#include "ProbedSimulation.hpp"
+
+using namespace Mazemouse;
+
+namespace {
+
+/**
+ * @brief An `AStarMouse` that checks every route it plans against a
+ * breadth-first search over the edges known to be open.
+ */
+template <
+    int S, DerivedFromAStarCell C, DerivedFromEdge E,
+    typename Hw = MouseHardwareInterface>
+struct ProbedAStarMouse : AStarMouse<S, C, E, Hw> {
+    using AStarMouse<S, C, E, Hw>::AStarMouse;
+    using AStarMouse<S, C, E, Hw>::route;
+
+    /**
+     * @brief Returns the number of cells from the current cell to the nearest
+     * finishing cell over the known open edges, or -1 if none is reachable.
+     */
+    [[nodiscard]] int knownDistanceToFinish() const {
+        std::vector<int> distances(this->maze.numCells(), -1);
+        std::queue<int> queue;
+        const int starting_index = this->maze.cellIndex(this->position);
+        distances[starting_index] = 0;
+        queue.push(starting_index);
+
+        while (!queue.empty()) {
+            const int index = queue.front();
+            queue.pop();
+            if (this->isFinishCell(this->maze.cellCoord(index))) {
+                return distances[index];
+            }
+
+            const auto open_mask = this->walls.openMask(index);
+            for (int d = 0; d < 4; ++d) {
+                const int neighbour =
+                    this->maze.neighbourIndex(index, static_cast<Dir4>(d));
+                if ((open_mask >> d & 1) && distances[neighbour] == -1) {
+                    distances[neighbour] = distances[index] + 1;
+                    queue.push(neighbour);
+                }
+            }
+        }
+
+        return -1;
+    }
+
+    /**
+     * @brief Checks that `route` leads from the current cell to a finishing
+     * cell over known open edges.
+     */
+    [[nodiscard]] bool isRouteKnownOpen() const {
+        int index = this->maze.cellIndex(this->position);
+        for (int i = 0; i < this->route.size(); ++i) {
+            if (!this->walls.isOpen(index, this->route[i])) {
+                return false;
+            }
+            index = this->maze.neighbourIndex(index, this->route[i]);
+        }
+
+        return this->isFinishCell(this->maze.cellCoord(index));
+    }
+
+    /**
+     * @brief Plans the route and checks it.
+     */
+    bool planRoute() override {
+        const auto previous_route = this->route;
+        const bool found = AStarMouse<S, C, E, Hw>::planRoute();
+        const int shortest = knownDistanceToFinish();
+
+        ++num_plans;
+        if (found) {
+            shortest_routes &= this->route.size() == shortest;
+            shortest_routes &= isRouteKnownOpen();
+        } else {
+            shortest_routes &= shortest == -1;
+            shortest_routes &= sameRoute(previous_route);
+        }
+
+        return found;
+    }
+
+    [[nodiscard]] bool sameRoute(
+        const typename AStarMouse<S, C, E, Hw>::Path& path) const {
+        if (path.size() != this->route.size()) {
+            return false;
+        }
+        for (int i = 0; i < path.size(); ++i) {
+            if (path[i] != this->route[i]) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    int num_plans{ 0 };
+
+    bool shortest_routes{ true };
+};
+
+/**
+ * @brief Runs a mouse through its rush and checks the planned route.
+ */
+template <int S>
+void checkRushRoute(
+    const int width, const int height, const int seed,
+    const ExplorationMode mode) {
+    SimulationMaze real_maze(width, height);
+    generateMaze(real_maze, seed, MazeAlgorithm::Competition);
+
+    auto simulation =
+        makeProbedSimulation<ProbedAStarMouse, S, AStarCell>(real_maze);
+    simulation.exploration_mode = mode;
+    const auto metrics = simulation.run();
+    CHECK(metrics.finished);
+    CHECK(simulation.num_plans == 1);
+    CHECK(simulation.shortest_routes);
+}
+
+/**
+ * @brief Plans before the finish is known to be reachable, which must fail
+ * and leave the route alone.
+ */
+template <int S>
+void checkNoKnownRoute(
+    const int width, const int height, const int numCycles) {
+    SimulationMaze real_maze(width, height);
+    generateMaze(real_maze, width + height, MazeAlgorithm::Competition);
+
+    auto simulation =
+        makeProbedSimulation<ProbedAStarMouse, S, AStarCell>(real_maze);
+    simulation.exploration_mode = ExplorationMode::FloodFill;
+    simulation.start();
+    for (int i = 0; i < numCycles; ++i) {
+        simulation.step();
+    }
+
+    simulation.route.clear();
+    simulation.route.push_back(Dir4::Right);
+    simulation.route.push_back(Dir4::Up);
+    CHECK(!simulation.planRoute());
+    CHECK(simulation.route.size() == 2);
+    CHECK(simulation.shortest_routes);
+}
+
+}  // namespace
+
+int main() {
+    for (int seed = 0; seed < 20; ++seed) {
+        for (const auto mode :
+             { ExplorationMode::LeastVisited, ExplorationMode::FloodFill,
+               ExplorationMode::FloodFillUntilOptimal }) {
+            checkRushRoute<16>(16, 16, seed, mode);
+            checkRushRoute<DYNAMIC_SIZE>(32, 32, seed, mode);
+            checkRushRoute<DYNAMIC_SIZE>(12, 20, seed, mode);
+        }
+    }
+
+    checkNoKnownRoute<16>(16, 16, 0);
+    checkNoKnownRoute<16>(16, 16, 5);
+    checkNoKnownRoute<DYNAMIC_SIZE>(12, 20, 5);
+
+    return checkResult("AStarMouseTest");
+}
@@ -0,0 +1,126 @@
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <utility>
+#include <vector>
+#include "../src/Maze/MazeGenerator.hpp"
+#include "../src/Mouse/AStarMouse.hpp"
+#include "../src/Mouse/TimeOptimalMouse.hpp"
+#include "../src/Simulation/Tournament.hpp"
+#include "Check.hpp"
+
+using namespace Mazemouse;
+
+namespace {
+
+/**
+ * The number of heap allocations made by the program so far.
+ */
+long num_allocations = 0;
+
+}  // namespace
+
+void* operator new(const std::size_t size) {
+    ++num_allocations;
+    if (void* pointer = std::malloc(size == 0 ? 1 : size)) {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+// Kept out of line, since GCC mistakes an inlined free() for a mismatch with
+// the operator new above
+[[gnu::noinline]] void operator delete(void* pointer) noexcept {
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t /* size */) noexcept {
+    ::operator delete(pointer);
+}
+
+namespace {
+
+/**
+ * @brief Runs a mouse in every maze with both hardware bindings and checks
+ * that it makes no heap allocation once constructed.
+ *
+ * @param checkedMice The name of the mouse is added to it.
+ */
+template <
+    template <int, typename, typename, typename> class M, typename C,
+    typename Setup = NoMouseSetup>
+void checkNoRunAllocations(
+    const std::string& name, const std::vector<SimulationMaze>& mazes,
+    std::vector<std::string>& checkedMice, Setup setup = {}) {
+    long allocations_before_run = 0;
+    const auto setupAndCount = [&](auto& mouse) {
+        setup(mouse);
+        allocations_before_run = num_allocations;
+    };
+
+    for (const auto& maze : mazes) {
+        simulate<M, C, Edge, StaticHardware>(
+            maze, SIMULATION_MAX_CYCLES, setupAndCount);
+        CHECK(num_allocations == allocations_before_run);
+
+        simulate<M, C, Edge, MouseHardwareInterface>(
+            maze, SIMULATION_MAX_CYCLES, setupAndCount);
+        CHECK(num_allocations == allocations_before_run);
+    }
+
+    checkedMice.push_back(name);
+}
+
+}  // namespace
+
+int main() {
+    // The static size and two runtime sizes, one of them not square
+    std::vector<SimulationMaze> mazes;
+    std::vector<int> seeds;
+    for (const auto& [width, height] :
+         std::vector<std::pair<int, int>>{
+             { TOURNAMENT_STATIC_SIZE, TOURNAMENT_STATIC_SIZE },
+             { 32, 32 },
+             { 12, 20 } }) {
+        for (const auto algorithm :
+             { MazeAlgorithm::DepthFirst, MazeAlgorithm::Competition }) {
+            for (int seed = 0; seed < 3; ++seed) {
+                mazes.emplace_back(width, height);
+                generateMaze(mazes.back(), seed, algorithm);
+            }
+        }
+    }
+
+    const auto flood_fill = [](auto& mouse) {
+        mouse.exploration_mode = ExplorationMode::FloodFill;
+    };
+    const auto until_optimal = [](auto& mouse) {
+        mouse.exploration_mode = ExplorationMode::FloodFillUntilOptimal;
+    };
+
+    std::vector<std::string> checked_mice;
+    checkNoRunAllocations<FloodFillMouse, FloodFillCell>(
+        "flood-fill", mazes, checked_mice);
+    checkNoRunAllocations<FloodFillMouse, FloodFillCell>(
+        "flood-fill-distance", mazes, checked_mice, flood_fill);
+    checkNoRunAllocations<FloodFillMouse, FloodFillCell>(
+        "flood-fill-optimal", mazes, checked_mice, until_optimal);
+    checkNoRunAllocations<AStarMouse, AStarCell>(
+        "astar", mazes, checked_mice);
+    checkNoRunAllocations<AStarMouse, AStarCell>(
+        "astar-flood-fill", mazes, checked_mice, flood_fill);
+    checkNoRunAllocations<AStarMouse, AStarCell>(
+        "astar-optimal", mazes, checked_mice, until_optimal);
+    checkNoRunAllocations<TimeOptimalMouse, AStarCell>(
+        "time-optimal", mazes, checked_mice, flood_fill);
+
+    // A mouse registered in the tournament but missing here fails the test
+    const Tournament tournament{ TournamentOptions{} };
+    std::vector<std::string> registered_mice;
+    for (const auto& entry : tournament.getEntries()) {
+        registered_mice.push_back(entry.name);
+    }
+    CHECK(checked_mice == registered_mice);
+
+    return checkResult("AllocationTest");
+}
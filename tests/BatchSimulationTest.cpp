@@ -0,0 +1,88 @@
+#include <stdexcept>
+#include <vector>
+#include "../src/Maze/MazeGenerator.hpp"
+#include "../src/Simulation/BatchSimulation.hpp"
+#include "../src/Simulation/Tournament.hpp"
+#include "Check.hpp"
+
+using namespace Mazemouse;
+
+namespace {
+
+bool sameMetrics(const SimulationMetrics& a, const SimulationMetrics& b) {
+    return a.cycles == b.cycles && a.explorationCells == b.explorationCells &&
+           a.returnCells == b.returnCells && a.rushCells == b.rushCells &&
+           a.rushMoves == b.rushMoves && a.turns == b.turns &&
+           a.rushTime == b.rushTime && a.crashed == b.crashed &&
+           a.finished == b.finished;
+}
+
+/**
+ * @brief Checks every lane of a batch, run with either kernel, against a
+ * `Simulation` of the same mouse in the same maze.
+ *
+ * @param numLanes The number of lanes; several blocks exercise compaction.
+ * @param maxCycles The cycle limit; a small one stops lanes mid-run.
+ */
+void checkLanes(
+    const int width, const int height, const MazeAlgorithm algorithm,
+    const int numLanes, const long maxCycles) {
+    std::vector<SimulationMaze> mazes;
+    for (int i = 0; i < numLanes; ++i) {
+        mazes.emplace_back(width, height);
+        generateMaze(mazes.back(), width * 1000 + height * 7 + i, algorithm);
+    }
+
+    std::vector<SimulationMetrics> expected;
+    for (const auto& maze : mazes) {
+        expected.push_back(
+            simulate<FloodFillMouse, FloodFillCell, Edge>(maze, maxCycles));
+    }
+
+    for (const bool use_avx2 : { true, false }) {
+        BatchSimulation batch(mazes, { 0, height - 1 }, Dir4::Up);
+        batch.setUseAvx2(use_avx2);
+        batch.run(maxCycles);
+
+        bool same = batch.numLanes() == numLanes;
+        for (int lane = 0; lane < numLanes; ++lane) {
+            same &= sameMetrics(batch.getMetrics(lane), expected[lane]);
+        }
+        CHECK(same);
+    }
+}
+
+void checkSizeMismatch() {
+    std::vector<SimulationMaze> mazes;
+    mazes.emplace_back(16, 16);
+    mazes.emplace_back(16, 8);
+
+    bool thrown = false;
+    try {
+        const BatchSimulation batch(mazes, { 0, 15 }, Dir4::Up);
+    } catch (const std::invalid_argument&) {
+        thrown = true;
+    }
+    CHECK(thrown);
+}
+
+}  // namespace
+
+int main() {
+    for (const auto& [width, height] :
+         { std::pair{ 16, 16 }, { 2, 2 }, { 3, 5 }, { 12, 20 }, { 32, 32 } }) {
+        for (const auto algorithm :
+             { MazeAlgorithm::DepthFirst, MazeAlgorithm::Prim,
+               MazeAlgorithm::Competition }) {
+            for (const int num_lanes : { 1, 8, 13, 40, 100 }) {
+                checkLanes(
+                    width, height, algorithm, num_lanes,
+                    SIMULATION_MAX_CYCLES);
+                checkLanes(width, height, algorithm, num_lanes, 37);
+            }
+        }
+    }
+    checkSizeMismatch();
+
+    return checkResult("BatchSimulationTest");
+}
@@ -0,0 +1,190 @@
+#include <queue>
+#include <random>
+#include <vector>
+#include "../src/Maze/BitFlood.hpp"
+#include "../src/Maze/MazeGenerator.hpp"
+#include "Check.hpp"
+
+using namespace Mazemouse;
+
+namespace {
+
+using RealMaze = Maze<DYNAMIC_SIZE, Cell, Edge>;
+
+/**
+ * @brief An edge of a maze the mouse has sensed.
+ */
+struct KnownEdge {
+    int index;
+    Dir4 dir;
+    bool open;
+};
+
+/**
+ * @brief Picks the edges of a real maze a mouse would know after exploring
+ * part of it.
+ */
+std::vector<KnownEdge> senseEdges(
+    const RealMaze& maze, std::mt19937& rng, const int knownPercent) {
+    std::vector<KnownEdge> edges;
+    for (int i = 0; i < maze.numCells(); ++i) {
+        for (const auto dir : { Dir4::Right, Dir4::Down }) {
+            if (maze.withinBounds(maze.cellCoord(i), dir) &&
+                static_cast<int>(rng() % 100) < knownPercent) {
+                edges.push_back({ i, dir, maze.isOpenAt(i, dir) });
+            }
+        }
+    }
+
+    return edges;
+}
+
+template <int S>
+WallBitboard<S> learnWalls(
+    const MazeGeometry<S>& geometry, const std::vector<KnownEdge>& edges) {
+    auto walls = WallBitboard<S>::unknown(geometry);
+    for (const auto& edge : edges) {
+        walls.setOpenAt(edge.index, edge.dir, edge.open);
+    }
+
+    return walls;
+}
+
+/**
+ * @brief Floods with one queue operation per cell, the way the mice did
+ * before the bit-parallel flood.
+ */
+std::vector<int> floodCells(
+    const WallBitboard<DYNAMIC_SIZE>& walls, const WallView view,
+    const std::vector<int>& sources) {
+    const int num_cells = walls.numCells();
+    std::vector<int> distances(num_cells, num_cells);
+    std::queue<int> queue;
+    for (const int source : sources) {
+        distances[source] = 0;
+        queue.push(source);
+    }
+
+    while (!queue.empty()) {
+        const int index = queue.front();
+        queue.pop();
+        const int open_mask = view == WallView::Optimistic
+                                  ? walls.mayBeOpenMask(index)
+                                  : walls.openMask(index);
+        for (int d = 0; d < 4; ++d) {
+            const int neighbour =
+                walls.neighbourIndex(index, static_cast<Dir4>(d));
+            if ((open_mask >> d & 1) &&
+                distances[neighbour] > distances[index] + 1) {
+                distances[neighbour] = distances[index] + 1;
+                queue.push(neighbour);
+            }
+        }
+    }
+
+    return distances;
+}
+
+template <int S>
+std::vector<int> floodBits(
+    BitFlood<S>& flood, const WallBitboard<S>& walls, const WallView view,
+    const std::vector<int>& sources, int& numReached) {
+    typename WallBitboard<S>::Plane plane(walls.numCells());
+    for (const int source : sources) {
+        plane.set(source);
+    }
+
+    std::vector<int> distances(walls.numCells(), walls.numCells());
+    numReached = flood.run(walls, view, plane, [&](int distance, auto& level) {
+        level.forEach([&](const int i) { distances[i] = distance; });
+    });
+
+    return distances;
+}
+
+int countReached(const std::vector<int>& distances) {
+    int num_reached = 0;
+    for (const int distance : distances) {
+        num_reached += distance < static_cast<int>(distances.size());
+    }
+
+    return num_reached;
+}
+
+/**
+ * @brief Checks the 256-bit kernel of a 16x16 flood against the portable
+ * kernel, which every runtime-sized flood uses, and against a queue.
+ */
+void checkKernelsAgree(const int seed, const MazeAlgorithm algorithm) {
+    RealMaze maze(16, 16);
+    generateMaze(maze, seed, algorithm);
+
+    std::mt19937 rng(seed);
+    const auto edges = senseEdges(maze, rng, static_cast<int>(rng() % 101));
+    const auto static_walls = learnWalls(MazeGeometry<16>{}, edges);
+    const auto dynamic_walls = learnWalls(maze, edges);
+
+    BitFlood<16> static_flood;
+    BitFlood<DYNAMIC_SIZE> dynamic_flood(maze);
+    std::vector<int> sources{ static_cast<int>(rng() % 256) };
+    if (seed % 2 == 0) {
+        sources.push_back(static_cast<int>(rng() % 256));
+    }
+
+    for (const auto view : { WallView::Pessimistic, WallView::Optimistic }) {
+        int static_reached = 0, dynamic_reached = 0;
+        const auto expected = floodCells(dynamic_walls, view, sources);
+        const auto static_distances = floodBits(
+            static_flood, static_walls, view, sources, static_reached);
+        const auto dynamic_distances = floodBits(
+            dynamic_flood, dynamic_walls, view, sources, dynamic_reached);
+
+        CHECK(static_distances == expected);
+        CHECK(dynamic_distances == expected);
+        CHECK(static_reached == countReached(expected));
+        CHECK(dynamic_reached == countReached(expected));
+    }
+}
+
+/**
+ * @brief Checks the portable kernel on sizes whose rows do not line up with
+ * the words of a plane.
+ */
+void checkPortableKernel(const int width, const int height, const int seed) {
+    RealMaze maze(width, height);
+    generateMaze(maze, seed, MazeAlgorithm::Competition);
+
+    std::mt19937 rng(seed);
+    const auto walls = learnWalls(maze, senseEdges(maze, rng, 70));
+    BitFlood<DYNAMIC_SIZE> flood(maze);
+    const std::vector sources{ static_cast<int>(rng() % maze.numCells()) };
+
+    for (const auto view : { WallView::Pessimistic, WallView::Optimistic }) {
+        int num_reached = 0;
+        const auto expected = floodCells(walls, view, sources);
+        CHECK(floodBits(flood, walls, view, sources, num_reached) == expected);
+        CHECK(num_reached == countReached(expected));
+    }
+}
+
+}  // namespace
+
+int main() {
+    if (!hasAvx2()) {
+        std::cout << "BitFloodTest: no AVX2, so both floods use the portable "
+                     "kernel\n";
+    }
+
+    for (int seed = 0; seed < 500; ++seed) {
+        checkKernelsAgree(seed, static_cast<MazeAlgorithm>(seed % 5));
+    }
+
+    for (const auto& [width, height] :
+         { std::pair{ 2, 2 }, { 3, 5 }, { 12, 20 }, { 31, 7 }, { 33, 33 } }) {
+        for (int seed = 0; seed < 20; ++seed) {
+            checkPortableKernel(width, height, seed);
+        }
+    }
+
+    return checkResult("BitFloodTest");
+}
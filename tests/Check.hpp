@@ -0,0 +1,52 @@
+#ifndef CHECK_HPP
+#define CHECK_HPP
+
+#include <iostream>
+
+namespace Mazemouse {
+
+/**
+ * @brief Returns the number of failed checks so far.
+ */
+inline int& numFailedChecks() {
+    static int num_failed = 0;
+    return num_failed;
+}
+
+/**
+ * @brief Reports a failed check and counts it.
+ */
+inline void reportFailedCheck(
+    const char* condition, const char* file, const int line) {
+    std::cerr << file << ":" << line << ": check failed: " << condition
+              << "\n";
+    ++numFailedChecks();
+}
+
+/**
+ * @brief Prints the outcome of a test program.
+ *
+ * @return The exit status of the program: 0 if every check passed.
+ */
+inline int checkResult(const char* name) {
+    if (numFailedChecks() > 0) {
+        std::cerr << name << ": " << numFailedChecks() << " checks failed\n";
+        return 1;
+    }
+
+    std::cout << name << ": passed\n";
+    return 0;
+}
+
+}  // namespace Mazemouse
+
+/**
+ * Checks a condition and reports it with its location if it fails; the test
+ * goes on with the next check.
+ */
+#define CHECK(condition)                                                    \
+    ((condition) ? void(0)                                                  \
+                 : ::Mazemouse::reportFailedCheck(                          \
+                       #condition, __FILE__, __LINE__))
+
+#endif
@@ -0,0 +1,263 @@
+#include <algorithm>
+#include <queue>
+#include <vector>
+#include "../src/Maze/BitFlood.hpp"
+#include "../src/Maze/MazeGenerator.hpp"
+#include "../src/Mouse/FloodFillMouse.hpp"
+#include "../src/Simulation/Simulation.hpp"
+#include "Check.hpp"
+#include "ProbedSimulation.hpp"
+
+using namespace Mazemouse;
+
+namespace {
+
+/**
+ * @brief A `FloodFillMouse` that compares its incrementally repaired
+ * distances with a full flood.
+ */
+template <
+    int S, DerivedFromFloodFillCell C, DerivedFromEdge E,
+    typename Hw = MouseHardwareInterface>
+struct ProbedFloodFillMouse : FloodFillMouse<S, C, E, Hw> {
+    using FloodFillMouse<S, C, E, Hw>::FloodFillMouse;
+
+    /**
+     * @brief Checks that every distance equals the one a full flood from the
+     * current target cells computes.
+     */
+    [[nodiscard]] bool hasFloodedDistances() {
+        BitFlood<S> flood(this->maze);
+        std::vector<int> expected(this->maze.numCells());
+        flood.distances(
+            this->walls, WallView::Optimistic,
+            this->flooding_to_start ? this->starting_cell : this->finish_cells,
+            [&](const int i) -> int& { return expected[i]; });
+
+        for (int i = 0; i < this->maze.numCells(); ++i) {
+            if (static_cast<int>(this->maze.cellAt(i).distance) !=
+                expected[i]) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    /**
+     * @brief Returns the number of distances that rose since the last call,
+     * which is the number of cells a repair raises.
+     */
+    int countRaisedDistances() {
+        last_distances.resize(this->maze.numCells());
+        int num_raised = 0;
+        for (int i = 0; i < this->maze.numCells(); ++i) {
+            const int distance = this->maze.cellAt(i).distance;
+            num_raised += distance > last_distances[i];
+            last_distances[i] = distance;
+        }
+
+        return num_raised;
+    }
+
+    /**
+     * @brief Returns the distance of every cell from the starting cell over a
+     * view of the walls.
+     */
+    [[nodiscard]] std::vector<int> floodFromStart(const WallView view) {
+        BitFlood<S> flood(this->maze);
+        std::vector<int> distances(this->maze.numCells());
+        flood.distances(
+            this->walls, view, this->starting_cell,
+            [&](const int i) -> int& { return distances[i]; });
+
+        return distances;
+    }
+
+    /**
+     * @brief Returns the length of the shortest route from the starting cell
+     * to the finish over a view of the walls.
+     */
+    [[nodiscard]] int routeLength(const WallView view) {
+        const auto distances = floodFromStart(view);
+        int length = this->maze.numCells();
+        for (const int index : this->finishCellIndices()) {
+            length = std::min(length, distances[index]);
+        }
+
+        return length;
+    }
+
+    /**
+     * @brief Checks that every `known_distance` equals the distance from the
+     * starting cell over the known open edges.
+     */
+    [[nodiscard]] bool hasKnownDistances() {
+        const auto expected = floodFromStart(WallView::Pessimistic);
+        for (int i = 0; i < this->maze.numCells(); ++i) {
+            if (this->maze.cellAt(i).known_distance != expected[i]) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    /**
+     * @brief Returns the distance from the current cell to the starting cell
+     * over the known open edges.
+     */
+    [[nodiscard]] int knownDistanceToStart() {
+        return floodFromStart(
+            WallView::Pessimistic)[this->maze.cellIndex(this->position)];
+    }
+
+    std::vector<int> last_distances{};
+};
+
+/**
+ * @brief Runs a `ExplorationMode::FloodFill` mouse and checks its distances
+ * against a full flood after every cycle.
+ *
+ * @return The number of cycles whose repair raised more cells than it has
+ * room for, and so fell back to a full flood.
+ */
+template <int S>
+int checkIncrementalFlood(
+    const int width, const int height, const int seed,
+    const MazeAlgorithm algorithm) {
+    SimulationMaze real_maze(width, height);
+    generateMaze(real_maze, seed, algorithm);
+
+    auto simulation =
+        makeProbedSimulation<ProbedFloodFillMouse, S, FloodFillCell>(real_maze);
+    simulation.exploration_mode = ExplorationMode::FloodFill;
+    simulation.countRaisedDistances();
+
+    // Wrong distances can lead the mouse in circles
+    const long max_cycles = 50L * width * height;
+    const int room = width * height / REFLOOD_FRACTION;
+    int num_refloods = 0;
+    bool flooded = simulation.hasFloodedDistances();
+    simulation.start();
+    while (simulation.getMetrics().cycles < max_cycles && simulation.step()) {
+        flooded &= simulation.hasFloodedDistances();
+        num_refloods += simulation.countRaisedDistances() > room;
+    }
+    CHECK(flooded);
+    CHECK(
+        simulation.state == MouseState::Stopped &&
+        !simulation.getMetrics().crashed);
+
+    return num_refloods;
+}
+
+/**
+ * @brief Returns the length of the shortest route from the starting cell to
+ * the finish in a real maze.
+ */
+int shortestRouteLength(const SimulationMaze& maze) {
+    std::vector<int> distances(maze.numCells(), -1);
+    std::queue<int> queue;
+    queue.push(maze.cellIndex({ 0, maze.height() - 1 }));
+    distances[queue.front()] = 0;
+
+    const int ax = maze.width() / 2, ay = maze.height() / 2;
+    while (!queue.empty()) {
+        const int index = queue.front();
+        queue.pop();
+        const auto coord = maze.cellCoord(index);
+        if ((coord.x == ax || coord.x == ax - 1) &&
+            (coord.y == ay || coord.y == ay - 1)) {
+            return distances[index];
+        }
+
+        for (int d = 0; d < 4; ++d) {
+            const auto dir = static_cast<Dir4>(d);
+            const int neighbour = maze.neighbourIndex(index, dir);
+            if (neighbour != NO_NEIGHBOUR && maze.isOpenAt(index, dir) &&
+                distances[neighbour] == -1) {
+                distances[neighbour] = distances[index] + 1;
+                queue.push(neighbour);
+            }
+        }
+    }
+
+    return -1;
+}
+
+/**
+ * @brief Runs a `ExplorationMode::FloodFillUntilOptimal` mouse and checks
+ * that it stops exploring only once its route is provably the shortest, then
+ * returns along the best known path and rushes along the shortest route.
+ */
+template <int S>
+void checkExploreUntilOptimal(
+    const int width, const int height, const int seed,
+    const MazeAlgorithm algorithm) {
+    SimulationMaze real_maze(width, height);
+    generateMaze(real_maze, seed, algorithm);
+
+    auto simulation =
+        makeProbedSimulation<ProbedFloodFillMouse, S, FloodFillCell>(real_maze);
+    simulation.exploration_mode = ExplorationMode::FloodFillUntilOptimal;
+
+    const long max_cycles = 50L * width * height;
+    bool known = true;
+    int num_stops = 0, return_length = -1;
+    simulation.start();
+    while (simulation.getMetrics().cycles < max_cycles) {
+        const auto state = simulation.state;
+        if (!simulation.step()) {
+            break;
+        }
+        known &= simulation.hasKnownDistances();
+        if (state == MouseState::Exploring &&
+            simulation.state == MouseState::ReturningToStart) {
+            ++num_stops;
+            CHECK(
+                simulation.routeLength(WallView::Pessimistic) ==
+                simulation.routeLength(WallView::Optimistic));
+            return_length = simulation.knownDistanceToStart();
+        }
+    }
+    CHECK(known);
+    CHECK(num_stops == 1);
+
+    const auto& metrics = simulation.getMetrics();
+    CHECK(simulation.state == MouseState::Stopped && !metrics.crashed);
+    CHECK(metrics.returnCells == return_length);
+    CHECK(metrics.rushCells == shortestRouteLength(real_maze));
+}
+
+}  // namespace
+
+int main() {
+    for (int seed = 0; seed < 20; ++seed) {
+        for (const auto algorithm :
+             { MazeAlgorithm::Competition, MazeAlgorithm::DepthFirst }) {
+            checkIncrementalFlood<16>(16, 16, seed, algorithm);
+            checkIncrementalFlood<32>(32, 32, seed, algorithm);
+            checkIncrementalFlood<DYNAMIC_SIZE>(12, 20, seed, algorithm);
+        }
+    }
+
+    // Small mazes have little room for a repair, so some fall back
+    int num_refloods = 0;
+    for (int seed = 0; seed < 20; ++seed) {
+        num_refloods += checkIncrementalFlood<DYNAMIC_SIZE>(
+            4, 4, seed, MazeAlgorithm::Competition);
+    }
+    CHECK(num_refloods > 0);
+
+    for (int seed = 0; seed < 20; ++seed) {
+        for (const auto algorithm :
+             { MazeAlgorithm::Competition, MazeAlgorithm::DepthFirst }) {
+            checkExploreUntilOptimal<16>(16, 16, seed, algorithm);
+            checkExploreUntilOptimal<32>(32, 32, seed, algorithm);
+            checkExploreUntilOptimal<DYNAMIC_SIZE>(12, 20, seed, algorithm);
+        }
+    }
+
+    return checkResult("FloodFillMouseTest");
+}
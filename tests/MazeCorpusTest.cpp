@@ -0,0 +1,279 @@
+#include <filesystem>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "../src/Maze/MazeCorpus.hpp"
+#include "../src/Maze/MazeGenerator.hpp"
+#include "../src/Simulation/Tournament.hpp"
+#include "Check.hpp"
+
+using namespace Mazemouse;
+
+namespace {
+
+using RealMaze = Maze<DYNAMIC_SIZE, Cell, Edge>;
+
+bool sameWalls(const RealMaze& a, const RealMaze& b) {
+    if (a.width() != b.width() || a.height() != b.height()) {
+        return false;
+    }
+    for (int i = 0; i < a.numEdges(); ++i) {
+        if (a.edges[i].hasWall != b.edges[i].hasWall) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool sameGoal(const MazeGoal& a, const MazeGoal& b) {
+    return a.position == b.position && a.size == b.size;
+}
+
+/**
+ * @brief Returns a path for a scratch file in the temporary directory.
+ */
+std::string scratchPath(const std::string& name) {
+    return (std::filesystem::temp_directory_path() / name).string();
+}
+
+/**
+ * @brief Draws a maze in the text format `importTextMaze()` reads.
+ */
+std::string drawMaze(const RealMaze& maze, const MazeGoal& goal) {
+    const int width = maze.width(), height = maze.height();
+    const auto is_goal = [&](const int x, const int y) {
+        return x >= goal.position.x && x < goal.position.x + goal.size.x &&
+               y >= goal.position.y && y < goal.position.y + goal.size.y;
+    };
+
+    std::ostringstream os;
+    for (int x = 0; x < width; ++x) {
+        os << "o---";
+    }
+    os << "o\n";
+    for (int y = 0; y < height; ++y) {
+        os << "|";
+        for (int x = 0; x < width; ++x) {
+            const bool wall =
+                x == width - 1 || !maze.isOpen({ x, y }, Dir4::Right);
+            os << (is_goal(x, y) ? " G " : "   ") << (wall ? "|" : " ");
+        }
+        os << "\no";
+        for (int x = 0; x < width; ++x) {
+            const bool wall =
+                y == height - 1 || !maze.isOpen({ x, y }, Dir4::Down);
+            os << (wall ? "---" : "   ") << "o";
+        }
+        os << "\n";
+    }
+
+    return os.str();
+}
+
+/**
+ * @brief Encodes a square maze in the `.maz` format `importMazMaze()` reads.
+ */
+std::string encodeMaz(const RealMaze& maze) {
+    const int size = maze.width();
+    std::string cells(size * size, '\0');
+    for (int x = 0; x < size; ++x) {
+        for (int y = 0; y < size; ++y) {
+            int walls = 0;
+            for (int d = 0; d < 4; ++d) {
+                const auto dir = static_cast<Dir4>(d);
+                if (!maze.withinBounds({ x, y }, dir) ||
+                    !maze.isOpen({ x, y }, dir)) {
+                    walls |= 1 << d;
+                }
+            }
+            cells[x * size + (size - 1 - y)] = static_cast<char>(walls);
+        }
+    }
+
+    return cells;
+}
+
+void checkImport() {
+    for (const auto& [width, height] :
+         { std::pair{ 2, 2 }, { 5, 3 }, { 16, 16 }, { 7, 19 } }) {
+        RealMaze maze(width, height);
+        generateMaze(maze, width * height, MazeAlgorithm::Competition);
+
+        const MazeGoal goal{ { 0, 0 }, { 1, 2 } };
+        std::istringstream text(drawMaze(maze, goal));
+        const auto from_text = importTextMaze(text);
+        CHECK(sameWalls(from_text.maze, maze));
+        CHECK(sameGoal(from_text.goal, goal));
+
+        if (width == height) {
+            std::istringstream maz(encodeMaz(maze));
+            const auto from_maz = importMazMaze(maz);
+            CHECK(sameWalls(from_maz.maze, maze));
+            CHECK(sameGoal(from_maz.goal, centerGoal(width, height)));
+        }
+    }
+
+    // Line endings from Windows are fine
+    RealMaze maze(4, 3);
+    generateMaze(maze, 7, MazeAlgorithm::DepthFirst);
+    const auto drawn = drawMaze(maze, centerGoal(4, 3));
+    std::string crlf;
+    for (const char c : drawn) {
+        crlf += c == '\n' ? "\r\n" : std::string(1, c);
+    }
+    std::istringstream crlf_text(crlf);
+    CHECK(sameWalls(importTextMaze(crlf_text).maze, maze));
+
+    // Not a maze, a file cut in its last line, a cell line without its last
+    // post, a post line with a post too many, and line endings mangled twice
+    std::string mangled;
+    for (const char c : drawn) {
+        mangled += c == '\n' ? "\r\r\n" : std::string(1, c);
+    }
+    std::string no_last_post = drawn;
+    no_last_post.erase(no_last_post.find("|\n"), 1);
+    for (const auto& text :
+         { std::string("hello\n"), drawn.substr(0, drawn.size() - 3),
+           no_last_post, "o---" + drawn, mangled }) {
+        std::istringstream is(text);
+        bool thrown = false;
+        try {
+            static_cast<void>(importTextMaze(is));
+        } catch (const std::invalid_argument&) {
+            thrown = true;
+        }
+        CHECK(thrown);
+    }
+}
+
+/**
+ * @brief Writes mazes of several sizes into a corpus and reads them back.
+ */
+void checkRoundTrip() {
+    const auto path = scratchPath("mazemouse_corpus_test.mzc");
+    std::vector<RealMaze> mazes;
+    std::vector<MazeGoal> goals;
+    for (int i = 0; i < 30; ++i) {
+        const int width = 2 + i % 15, height = 2 + i * 7 % 15;
+        mazes.emplace_back(width, height);
+        generateMaze(mazes.back(), i, static_cast<MazeAlgorithm>(i % 5));
+        goals.push_back(
+            i % 2 == 0 ? centerGoal(width, height)
+                       : MazeGoal{ { width - 1, 0 }, { 1, 1 } });
+    }
+
+    MazeCorpusWriter writer(path, 16, 16);
+    for (std::size_t i = 0; i < mazes.size(); ++i) {
+        writer.write(mazes[i], goals[i], static_cast<std::uint32_t>(i * 3));
+    }
+    CHECK(writer.size() == mazes.size());
+    writer.close();
+
+    {
+        const MazeCorpus corpus(path);
+        CHECK(corpus.size() == mazes.size());
+        CHECK(corpus.getHeader().maxWidth == 16);
+        CHECK(corpus.getHeader().maxHeight == 16);
+        for (std::size_t i = 0; i < corpus.size(); ++i) {
+            const auto view = corpus.at(i);
+            CHECK(view.width() == mazes[i].width());
+            CHECK(view.height() == mazes[i].height());
+            CHECK(view.getSeed() == i * 3);
+            CHECK(sameGoal(view.getGoal(), goals[i]));
+
+            RealMaze copy(view.width(), view.height());
+            view.writeTo(copy);
+            CHECK(sameWalls(copy, mazes[i]));
+
+            bool same_view = true;
+            for (int cell = 0; cell < copy.numCells(); ++cell) {
+                for (int d = 0; d < 4; ++d) {
+                    const auto dir = static_cast<Dir4>(d);
+                    same_view &= view.isOpenAt(cell, dir) ==
+                                 (copy.neighbourIndex(cell, dir) !=
+                                      NO_NEIGHBOUR &&
+                                  copy.isOpenAt(cell, dir));
+                }
+            }
+            CHECK(same_view);
+        }
+
+        bool thrown = false;
+        try {
+            static_cast<void>(corpus.at(corpus.size()));
+        } catch (const std::invalid_argument&) {
+            thrown = true;
+        }
+        CHECK(thrown);
+    }
+
+    // A maze larger than the records cannot be written
+    MazeCorpusWriter small_writer(path, 4, 4);
+    bool thrown = false;
+    try {
+        small_writer.write(RealMaze(5, 4));
+    } catch (const std::invalid_argument&) {
+        thrown = true;
+    }
+    CHECK(thrown);
+    small_writer.close();
+    std::filesystem::remove(path);
+}
+
+void checkNotACorpus() {
+    const auto path = scratchPath("mazemouse_corpus_test.txt");
+    {
+        std::ofstream file(path);
+        file << "this is not a maze corpus, but it is long enough to have "
+                "a header\n";
+    }
+
+    bool thrown = false;
+    try {
+        const MazeCorpus corpus(path);
+    } catch (const std::invalid_argument&) {
+        thrown = true;
+    }
+    CHECK(thrown);
+    std::filesystem::remove(path);
+}
+
+/**
+ * @brief Checks that a tournament in a corpus of generated mazes gives the
+ * same results as a tournament that generates them.
+ */
+void checkTournament() {
+    const auto path = scratchPath("mazemouse_corpus_tournament.mzc");
+    TournamentOptions options;
+    options.numMazes = 6;
+    options.width = 11;
+    options.height = 9;
+
+    MazeCorpusWriter writer(path, options.width, options.height);
+    for (int i = 0; i < options.numMazes; ++i) {
+        const RealMaze maze(options.width, options.height);
+        generateMaze(maze, options.seed + i, options.algorithm);
+        writer.write(maze, static_cast<std::uint32_t>(options.seed + i));
+    }
+    writer.close();
+
+    std::ostringstream generated, from_corpus;
+    Tournament::writeCsv(generated, Tournament(options).run());
+    options.corpusPath = path;
+    Tournament::writeCsv(from_corpus, Tournament(options).run());
+    CHECK(from_corpus.str() == generated.str());
+    std::filesystem::remove(path);
+}
+
+}  // namespace
+
+int main() {
+    checkImport();
+    checkRoundTrip();
+    checkNotACorpus();
+    checkTournament();
+
+    return checkResult("MazeCorpusTest");
+}
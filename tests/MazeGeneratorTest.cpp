@@ -0,0 +1,199 @@
+#include <queue>
+#include <stdexcept>
+#include <vector>
+#include "../src/Maze/MazeGenerator.hpp"
+#include "Check.hpp"
+
+using namespace Mazemouse;
+
+namespace {
+
+using RealMaze = Maze<DYNAMIC_SIZE, Cell, Edge>;
+
+constexpr MazeAlgorithm ALGORITHMS[] = {
+    MazeAlgorithm::DepthFirst, MazeAlgorithm::Prim, MazeAlgorithm::Kruskal,
+    MazeAlgorithm::Wilson,     MazeAlgorithm::Competition,
+};
+
+/**
+ * @brief Returns the number of cells reachable from the starting cell.
+ */
+template <int S>
+int countReachable(const Maze<S, Cell, Edge>& maze) {
+    std::vector<bool> reached(maze.numCells(), false);
+    std::queue<int> queue;
+    queue.push(startingCellIndex(maze));
+    reached[queue.front()] = true;
+
+    int num_reached = 0;
+    while (!queue.empty()) {
+        const int index = queue.front();
+        queue.pop();
+        ++num_reached;
+        for (int d = 0; d < 4; ++d) {
+            const auto dir = static_cast<Dir4>(d);
+            const int neighbour = maze.neighbourIndex(index, dir);
+            if (neighbour != NO_NEIGHBOUR && maze.isOpenAt(index, dir) &&
+                !reached[neighbour]) {
+                reached[neighbour] = true;
+                queue.push(neighbour);
+            }
+        }
+    }
+
+    return num_reached;
+}
+
+template <int S>
+int countOpenEdges(const Maze<S, Cell, Edge>& maze) {
+    int num_open = 0;
+    for (int i = 0; i < maze.numEdges(); ++i) {
+        num_open += !maze.edges[i].hasWall;
+    }
+
+    return num_open;
+}
+
+template <int S1, int S2>
+bool sameWalls(const Maze<S1, Cell, Edge>& a, const Maze<S2, Cell, Edge>& b) {
+    if (a.width() != b.width() || a.height() != b.height()) {
+        return false;
+    }
+    for (int i = 0; i < a.numEdges(); ++i) {
+        if (a.edges[i].hasWall != b.edges[i].hasWall) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void checkMaze(const RealMaze& maze, const MazeAlgorithm algorithm) {
+    CHECK(countReachable(maze) == maze.numCells());
+
+    // The centre cells open into each other
+    const auto centers = centerCells(maze);
+    for (int i = 0; i < 4; ++i) {
+        const auto& center = centers[i];
+        const auto& next = centers[(i + 1) % 4];
+        const auto dir = next.x > center.x   ? Dir4::Right
+                         : next.x < center.x ? Dir4::Left
+                         : next.y > center.y ? Dir4::Down
+                                             : Dir4::Up;
+        CHECK(maze.isOpen(center, dir));
+    }
+
+    if (algorithm != MazeAlgorithm::Competition) {
+        // A spanning tree, plus at most the walls of the centre it opened
+        CHECK(countOpenEdges(maze) >= maze.numCells() - 1);
+        CHECK(countOpenEdges(maze) <= maze.numCells() + 3);
+    } else if (maze.width() >= 4 && maze.height() >= 4) {
+        CHECK(!maze.isOpenAt(startingCellIndex(maze), Dir4::Right));
+    }
+}
+
+void checkSize(const int width, const int height) {
+    for (const auto algorithm : ALGORITHMS) {
+        std::vector<RealMaze> mazes;
+        std::vector<int> seeds;
+        for (int seed = 0; seed < 40; ++seed) {
+            mazes.emplace_back(width, height);
+            seeds.push_back(seed * 7919 + width);
+        }
+        generateBatch(mazes, seeds, 4, algorithm);
+
+        for (std::size_t i = 0; i < mazes.size(); ++i) {
+            checkMaze(mazes[i], algorithm);
+
+            // A maze depends on its seed only, not on the batch
+            const RealMaze maze(width, height);
+            generateMaze(maze, seeds[i], algorithm);
+            CHECK(sameWalls(maze, mazes[i]));
+        }
+    }
+}
+
+/**
+ * @brief Checks that a compile-time sized maze, which keeps the working
+ * storage inline, carves the same maze as a runtime-sized one.
+ */
+void checkStaticSize() {
+    for (const auto algorithm : ALGORITHMS) {
+        for (int seed = 0; seed < 20; ++seed) {
+            const Maze<16, Cell, Edge> static_maze;
+            const RealMaze dynamic_maze(16, 16);
+            generateMaze(static_maze, seed, algorithm);
+            generateMaze(dynamic_maze, seed, algorithm);
+            CHECK(countReachable(static_maze) == static_maze.numCells());
+            CHECK(sameWalls(static_maze, dynamic_maze));
+        }
+    }
+}
+
+/**
+ * @brief An edge whose wall throws when it is opened if it is marked to
+ * fail, to carve a maze that fails within a batch.
+ */
+struct FailingEdge : Edge {
+    struct Wall {
+        mutable bool value{ true };
+
+        mutable bool fails{ false };
+
+        operator bool() const { return value; }
+
+        const Wall& operator=(const bool hasWall) const {
+            if (fails && !hasWall) {
+                throw std::runtime_error("FailingEdge: the wall failed");
+            }
+            value = hasWall;
+            return *this;
+        }
+    };
+
+    Wall hasWall{};
+};
+
+/**
+ * @brief Checks that a maze that fails to carve fails the whole batch with
+ * its exception, after the other mazes are carved, instead of terminating.
+ */
+void checkFailingMaze() {
+    using FailingMaze = Maze<DYNAMIC_SIZE, Cell, FailingEdge>;
+    std::vector<FailingMaze> mazes;
+    std::vector<int> seeds;
+    for (int seed = 0; seed < 40; ++seed) {
+        mazes.emplace_back(8, 8);
+        seeds.push_back(seed);
+    }
+    for (int edge = 0; edge < mazes[13].numEdges(); ++edge) {
+        mazes[13].edges[edge].hasWall.fails = true;
+    }
+
+    for (const unsigned num_threads : { 1u, 4u }) {
+        bool rethrown = false;
+        try {
+            generateBatch(mazes, seeds, num_threads);
+        } catch (const std::runtime_error&) {
+            rethrown = true;
+        }
+        CHECK(rethrown);
+        CHECK(mazes.back().isOpen({ 0, 7 }, Dir4::Up) ||
+              mazes.back().isOpen({ 0, 7 }, Dir4::Right));
+    }
+}
+
+}  // namespace
+
+int main() {
+    for (const auto& [width, height] :
+         { std::pair{ 2, 2 }, { 2, 3 }, { 3, 2 }, { 2, 4 }, { 4, 2 }, { 3, 3 },
+           { 5, 5 }, { 7, 12 }, { 12, 7 }, { 16, 16 }, { 31, 17 },
+           { 32, 32 } }) {
+        checkSize(width, height);
+    }
+    checkStaticSize();
+    checkFailingMaze();
+
+    return checkResult("MazeGeneratorTest");
+}
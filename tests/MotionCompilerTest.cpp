@@ -0,0 +1,238 @@
+#include <cmath>
+#include <random>
+#include <vector>
+#include "../src/Container/PackedDirs.hpp"
+#include "../src/Mouse/MotionPrimitive.hpp"
+#include "Check.hpp"
+
+using namespace Mazemouse;
+
+namespace {
+
+/**
+ * The relative error allowed in the `float` kinematics.
+ */
+constexpr float TOLERANCE = 1e-4f;
+
+bool atMost(const float value, const double limit) {
+    return value <= limit * (1 + TOLERANCE) + TOLERANCE;
+}
+
+bool isTurn(const MotionPrimitive& primitive) {
+    return primitive.kind == MotionKind::SmoothTurn ||
+           primitive.kind == MotionKind::Diagonal;
+}
+
+bool samePrimitive(const MotionPrimitive& a, const MotionPrimitive& b) {
+    return a.kind == b.kind && a.dir == b.dir &&
+           a.alternateDir == b.alternateDir && a.turn == b.turn &&
+           a.cells == b.cells && a.length == b.length &&
+           a.entrySpeed == b.entrySpeed && a.peakSpeed == b.peakSpeed &&
+           a.exitSpeed == b.exitSpeed && a.duration == b.duration;
+}
+
+/**
+ * @brief Compiles a route and checks the plan against the route and the
+ * limits of the profile.
+ */
+void checkPlan(
+    const std::vector<Dir4>& route, const Dir4 orientation,
+    const MotionProfile& profile) {
+    std::vector<MotionPrimitive> plan;
+    compileMotion(route, orientation, profile, plan);
+    const int num_primitives = static_cast<int>(plan.size());
+    if (route.empty()) {
+        CHECK(plan.empty());
+        return;
+    }
+
+    // Starts and ends at rest
+    CHECK(num_primitives > 0);
+    CHECK(plan.front().entrySpeed == 0);
+    CHECK(plan.back().exitSpeed == 0);
+
+    std::vector<bool> in_place_turns(route.size(), false);
+    int step = 0;
+    for (int p = 0; p < num_primitives; ++p) {
+        const auto& primitive = plan[p];
+
+        // The primitive enters the next cells of the route
+        bool follows_route = step + primitive.cells <=
+                             static_cast<int>(route.size());
+        for (int i = 0; follows_route && i < primitive.cells; ++i) {
+            follows_route = primitive.cellDir(i) == route[step + i];
+        }
+        CHECK(follows_route);
+
+        // Only a reversal, or a start away from the orientation, turns in
+        // place
+        if (primitive.kind == MotionKind::InPlaceTurn) {
+            const Dir4 heading = step == 0 ? orientation : route[step - 1];
+            CHECK(step == 0 || primitive.turn == Dir4::Down);
+            CHECK(primitive.cells == 0);
+            CHECK(primitive.dir == route[step]);
+            CHECK(primitive.turn == route[step] - heading);
+            CHECK(primitive.entrySpeed == 0 && primitive.exitSpeed == 0);
+            in_place_turns[step] = true;
+        }
+
+        // Consecutive primitives meet at the same speed
+        if (p + 1 < num_primitives) {
+            CHECK(primitive.exitSpeed == plan[p + 1].entrySpeed);
+        }
+
+        CHECK(primitive.entrySpeed >= 0 && primitive.exitSpeed >= 0);
+        CHECK(atMost(primitive.entrySpeed, profile.maxSpeed));
+        CHECK(atMost(primitive.peakSpeed, profile.maxSpeed));
+        CHECK(atMost(primitive.exitSpeed, profile.maxSpeed));
+        if (isTurn(primitive)) {
+            CHECK(atMost(primitive.entrySpeed, profile.smoothTurnSpeed));
+            CHECK(atMost(primitive.exitSpeed, profile.smoothTurnSpeed));
+        }
+        if (primitive.kind == MotionKind::SmoothTurn) {
+            CHECK(primitive.peakSpeed == primitive.entrySpeed);
+        }
+
+        // Every speed change fits in the ramp length of the primitive
+        const float ramp_length =
+            primitive.kind == MotionKind::SmoothTurn ? 0 : primitive.length;
+        const float entry_squared = primitive.entrySpeed * primitive.entrySpeed;
+        const float exit_squared = primitive.exitSpeed * primitive.exitSpeed;
+        CHECK(atMost(
+            std::abs(exit_squared - entry_squared),
+            2 * profile.acceleration * ramp_length));
+        CHECK(std::isfinite(primitive.duration) && primitive.duration >= 0);
+
+        step += primitive.cells;
+    }
+    CHECK(step == static_cast<int>(route.size()));
+    for (int i = 0; i < static_cast<int>(route.size()); ++i) {
+        const Dir4 heading = i == 0 ? orientation : route[i - 1];
+        if (route[i] != heading) {
+            CHECK(in_place_turns[i] == (i == 0 || route[i] - heading ==
+                                                      Dir4::Down));
+        }
+    }
+
+    // Streaming the primitives one at a time, from the packed route a mouse
+    // keeps, gives the same plan
+    PackedDirs<DYNAMIC_SIZE> packed(static_cast<int>(route.size()));
+    for (const auto dir : route) {
+        packed.push_back(dir);
+    }
+    MotionCompiler compiler;
+    compiler.start(orientation, profile);
+    int num_streamed = 0;
+    bool same_plan = true;
+    for (MotionPrimitive primitive; compiler.next(packed, primitive);
+         ++num_streamed) {
+        same_plan &= num_streamed < num_primitives &&
+                     samePrimitive(primitive, plan[num_streamed]);
+    }
+    CHECK(same_plan);
+    CHECK(num_streamed == num_primitives);
+}
+
+/**
+ * @brief Returns a random route of straights, turns, zigzags and, if
+ * allowed, reversals.
+ */
+std::vector<Dir4> randomRoute(
+    std::mt19937& rng, const int length, const bool reversals) {
+    std::vector<Dir4> route;
+    Dir4 dir = static_cast<Dir4>(rng() % 4);
+    for (int i = 0; i < length; ++i) {
+        const auto roll = rng() % 16;
+        if (roll < 3) {
+            dir = dir + Dir4::Right;
+        } else if (roll < 6) {
+            dir = dir + Dir4::Left;
+        } else if (roll < 7 && reversals) {
+            dir = dir + Dir4::Down;
+        }
+        route.push_back(dir);
+    }
+
+    return route;
+}
+
+std::vector<Dir4> parseRoute(const char* dirs) {
+    std::vector<Dir4> route;
+    for (; *dirs != '\0'; ++dirs) {
+        switch (*dirs) {
+            case 'U':
+                route.push_back(Dir4::Up);
+                break;
+            case 'R':
+                route.push_back(Dir4::Right);
+                break;
+            case 'D':
+                route.push_back(Dir4::Down);
+                break;
+            default:
+                route.push_back(Dir4::Left);
+                break;
+        }
+    }
+
+    return route;
+}
+
+/**
+ * @brief Checks that a route that reverses once turns in place where it
+ * reverses, at rest.
+ */
+void checkReversal() {
+    const auto route = parseRoute("UUUUDDDRR");
+    std::vector<MotionPrimitive> plan;
+    compileMotion(route, Dir4::Up, MotionProfile{}, plan);
+
+    int step = 0, num_u_turns = 0;
+    for (const auto& primitive : plan) {
+        if (primitive.kind == MotionKind::InPlaceTurn) {
+            CHECK(step == 4);
+            CHECK(primitive.turn == Dir4::Down);
+            CHECK(primitive.entrySpeed == 0);
+            ++num_u_turns;
+        }
+        step += primitive.cells;
+    }
+    CHECK(num_u_turns == 1);
+}
+
+}  // namespace
+
+int main() {
+    MotionProfile slow;
+    slow.acceleration = 2;
+    slow.maxSpeed = 2;
+    slow.smoothTurnSpeed = 1;
+    MotionProfile fast;
+    fast.acceleration = 80;
+    fast.maxSpeed = 40;
+    fast.smoothTurnSpeed = 40;
+    MotionProfile sharp;
+    sharp.acceleration = 10;
+    sharp.maxSpeed = 20;
+    sharp.smoothTurnSpeed = 0.5;
+
+    checkReversal();
+
+    for (const auto& profile : { MotionProfile{}, slow, fast, sharp }) {
+        for (const char* dirs :
+             { "", "U", "D", "R", "UUUUUUUUUUUUUUU", "URURURURUR", "ULLURRUL",
+               "UUURUUULLL", "UD", "UUDDRRLL", "RLRL" }) {
+            for (int d = 0; d < 4; ++d) {
+                checkPlan(parseRoute(dirs), static_cast<Dir4>(d), profile);
+            }
+        }
+
+        std::mt19937 rng(10086);
+        for (int i = 0; i < 500; ++i) {
+            const auto route = randomRoute(rng, 1 + i % 60, i % 3 == 0);
+            checkPlan(route, static_cast<Dir4>(rng() % 4), profile);
+        }
+    }
+
+    return checkResult("MotionCompilerTest");
+}
@@ -0,0 +1,40 @@
+#ifndef PROBED_SIMULATION_HPP
+#define PROBED_SIMULATION_HPP
+
+#include "../src/Simulation/Simulation.hpp"
+
+namespace Mazemouse {
+
+/**
+ * @brief The simulation of a probed mouse, a test subclass of a mouse
+ * template that reaches its protected members.
+ */
+template <
+    template <int, typename, typename, typename> class M, int S, typename C>
+using ProbedSimulation = Simulation<M<S, C, Edge, StaticHardware>>;
+
+/**
+ * @brief Creates the simulation of a probed mouse in a real maze, starting
+ * like `simulate()` at the bottom-left cell facing up.
+ *
+ * @tparam S The size of the mouse's maze, or `DYNAMIC_SIZE` for one sized
+ * like the real maze.
+ */
+template <
+    template <int, typename, typename, typename> class M, int S, typename C>
+ProbedSimulation<M, S, C> makeProbedSimulation(
+    const SimulationMaze& realMaze) {
+    const Vector2 starting_position{ 0, realMaze.height() - 1 };
+    if constexpr (S == DYNAMIC_SIZE) {
+        return ProbedSimulation<M, S, C>(
+            realMaze, starting_position, MOUSE_STARTING_ORIENTATION,
+            Maze<DYNAMIC_SIZE, C, Edge>(realMaze.width(), realMaze.height()));
+    } else {
+        return ProbedSimulation<M, S, C>(
+            realMaze, starting_position, MOUSE_STARTING_ORIENTATION);
+    }
+}
+
+}  // namespace Mazemouse
+
+#endif
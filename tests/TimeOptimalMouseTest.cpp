@@ -0,0 +1,128 @@
+#include <cmath>
+#include <limits>
+#include "../src/Maze/MazeGenerator.hpp"
+#include "../src/Mouse/TimeOptimalMouse.hpp"
+#include "Check.hpp"
+#include "ProbedSimulation.hpp"
+
+using namespace Mazemouse;
+
+namespace {
+
+/**
+ * The relative error allowed between the planned and the compiled times,
+ * which are summed in `float`.
+ */
+constexpr double TOLERANCE = 1e-4;
+
+/**
+ * @brief A `TimeOptimalMouse` that times every route it plans with the
+ * motion compiler, and the shortest known route along with it.
+ */
+template <
+    int S, DerivedFromAStarCell C, DerivedFromEdge E,
+    typename Hw = MouseHardwareInterface>
+struct ProbedTimeOptimalMouse : TimeOptimalMouse<S, C, E, Hw> {
+    using TimeOptimalMouse<S, C, E, Hw>::TimeOptimalMouse;
+
+    /**
+     * @brief Returns the duration of the rush along `route`, compiled from
+     * the current cell and orientation.
+     */
+    [[nodiscard]] double rushTime() const {
+        MotionCompiler compiler;
+        compiler.start(this->orientation, this->motion_profile);
+        double time = 0;
+        for (MotionPrimitive primitive;
+             compiler.next(this->route, primitive);) {
+            time += primitive.duration;
+        }
+
+        return time;
+    }
+
+    /**
+     * @brief Plans the shortest known route like an `AStarMouse`, then the
+     * fastest one, and checks the fastest.
+     */
+    bool planRoute() override {
+        const double shortest_time = AStarMouse<S, C, E, Hw>::planRoute()
+                                         ? rushTime()
+                                         : std::numeric_limits<double>::max();
+        const bool found = TimeOptimalMouse<S, C, E, Hw>::planRoute();
+
+        ++num_plans;
+        if (found) {
+            const double time = rushTime();
+            exact_costs &=
+                std::abs(this->plannedTime() - time) <= TOLERANCE * time;
+            never_slower &= time <= shortest_time * (1 + TOLERANCE);
+        } else {
+            never_slower &= shortest_time == std::numeric_limits<double>::max();
+        }
+
+        return found;
+    }
+
+    int num_plans{ 0 };
+
+    bool exact_costs{ true };
+
+    bool never_slower{ true };
+};
+
+/**
+ * @brief Runs a mouse through its rush and checks the planned route.
+ *
+ * @param exact Whether the profile reaches its turn speed within half a
+ * cell, so that the planned costs are the compiled durations.
+ */
+template <int S>
+void checkRush(
+    const int width, const int height, const int seed,
+    const MazeAlgorithm algorithm, const ExplorationMode mode,
+    const MotionProfile& profile, const bool exact) {
+    SimulationMaze real_maze(width, height);
+    generateMaze(real_maze, seed, algorithm);
+
+    auto simulation =
+        makeProbedSimulation<ProbedTimeOptimalMouse, S, AStarCell>(real_maze);
+    simulation.exploration_mode = mode;
+    simulation.motion_profile = profile;
+    const auto metrics = simulation.run();
+    CHECK(metrics.finished);
+    CHECK(simulation.num_plans == 1);
+    CHECK(!exact || simulation.exact_costs);
+    CHECK(simulation.never_slower);
+}
+
+}  // namespace
+
+int main() {
+    // Reaches its turn speed within half a cell, and saturates late
+    MotionProfile fast;
+    fast.acceleration = 25;
+    fast.maxSpeed = 20;
+
+    // Too slow to reach its turn speed within half a cell
+    MotionProfile slow;
+    slow.acceleration = 4;
+
+    for (int seed = 0; seed < 12; ++seed) {
+        for (const auto algorithm :
+             { MazeAlgorithm::Competition, MazeAlgorithm::DepthFirst }) {
+            for (const auto mode :
+                 { ExplorationMode::FloodFill,
+                   ExplorationMode::FloodFillUntilOptimal }) {
+                checkRush<16>(
+                    16, 16, seed, algorithm, mode, MotionProfile{}, true);
+                checkRush<16>(16, 16, seed, algorithm, mode, fast, true);
+                checkRush<16>(16, 16, seed, algorithm, mode, slow, false);
+                checkRush<DYNAMIC_SIZE>(
+                    12, 20, seed, algorithm, mode, MotionProfile{}, true);
+            }
+        }
+    }
+
+    return checkResult("TimeOptimalMouseTest");
+}
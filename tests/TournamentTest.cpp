@@ -0,0 +1,111 @@
+#include <atomic>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+#include "../src/Simulation/ThreadPool.hpp"
+#include "../src/Simulation/Tournament.hpp"
+#include "Check.hpp"
+
+using namespace Mazemouse;
+
+namespace {
+
+/**
+ * @brief Runs a tournament and returns its CSV and JSON output.
+ */
+std::string runTournament(TournamentOptions options, const unsigned threads) {
+    options.numThreads = threads;
+    const Tournament tournament(options);
+    const auto results = tournament.run();
+    CHECK(
+        results.size() == static_cast<std::size_t>(options.numMazes) *
+                              tournament.getEntries().size());
+
+    std::ostringstream os;
+    Tournament::writeCsv(os, results);
+    Tournament::writeJson(os, results);
+
+    return os.str();
+}
+
+void checkThreadCounts(const int width, const int height) {
+    TournamentOptions options;
+    options.numMazes = 12;
+    options.width = width;
+    options.height = height;
+    options.algorithm = MazeAlgorithm::Competition;
+
+    const auto expected = runTournament(options, 1);
+    CHECK(runTournament(options, 4) == expected);
+    CHECK(runTournament(options, 13) == expected);
+}
+
+/**
+ * @brief Checks that running the batched mice in batches changes no result,
+ * over more mazes than one batch holds.
+ */
+void checkBatch(const int width, const int height) {
+    TournamentOptions options;
+    options.numMazes = TOURNAMENT_BATCH_MAZES + 21;
+    options.width = width;
+    options.height = height;
+    options.maxCycles = 5000;
+
+    const auto expected = runTournament(options, 4);
+    options.batch = true;
+    CHECK(runTournament(options, 4) == expected);
+}
+
+void checkParallelFor() {
+    ThreadPool pool(4);
+    for (const int count : { 0, 1, 5, 16, 1000 }) {
+        std::vector<std::atomic<int>> calls(count);
+        pool.parallelFor(count, [&](const int i) { ++calls[i]; });
+
+        bool once_each = true;
+        for (const auto& call : calls) {
+            once_each &= call == 1;
+        }
+        CHECK(once_each);
+    }
+}
+
+void checkTaskException() {
+    ThreadPool pool(3);
+    std::atomic<int> num_run{ 0 };
+    for (int i = 0; i < 20; ++i) {
+        pool.submit([&num_run, i] {
+            ++num_run;
+            if (i == 7) {
+                throw std::runtime_error("task failed");
+            }
+        });
+    }
+
+    bool rethrown = false;
+    try {
+        pool.wait();
+    } catch (const std::runtime_error&) {
+        rethrown = true;
+    }
+    CHECK(rethrown);
+    CHECK(num_run == 20);
+
+    // The error is reported once, and the pool keeps working
+    pool.submit([&num_run] { ++num_run; });
+    pool.wait();
+    CHECK(num_run == 21);
+}
+
+}  // namespace
+
+int main() {
+    checkThreadCounts(16, 16);
+    checkThreadCounts(9, 13);
+    checkBatch(16, 16);
+    checkBatch(9, 13);
+    checkParallelFor();
+    checkTaskException();
+
+    return checkResult("TournamentTest");
+}
@@ -0,0 +1,184 @@
+#include <random>
+#include <stdexcept>
+#include <vector>
+#include "../src/Maze/WallBitboard.hpp"
+#include "Check.hpp"
+
+using namespace Mazemouse;
+
+namespace {
+
+/**
+ * @brief The state of an edge in the reference model.
+ */
+enum class EdgeState { Unknown, Wall, Open };
+
+/**
+ * @brief A plain model of the edges of a maze, one state per edge on the
+ * right of and below every cell.
+ */
+struct EdgeModel {
+    int width;
+
+    int height;
+
+    std::vector<EdgeState> east;
+
+    std::vector<EdgeState> south;
+
+    EdgeModel(const int width, const int height) :
+        width(width), height(height),
+        east(width * height, EdgeState::Unknown),
+        south(width * height, EdgeState::Unknown) {}
+
+    /**
+     * @brief Returns the state of an edge of a cell; border edges are known
+     * walls.
+     */
+    [[nodiscard]] EdgeState at(const int index, const Dir4 dir) const {
+        const int x = index % width, y = index / width;
+        switch (dir) {
+            case Dir4::Up:
+                return y == 0 ? EdgeState::Wall : south[index - width];
+            case Dir4::Right:
+                return x == width - 1 ? EdgeState::Wall : east[index];
+            case Dir4::Down:
+                return y == height - 1 ? EdgeState::Wall : south[index];
+            case Dir4::Left:
+                return x == 0 ? EdgeState::Wall : east[index - 1];
+        }
+        return EdgeState::Wall;
+    }
+
+    void set(const int index, const Dir4 dir, const bool open) {
+        const auto state = open ? EdgeState::Open : EdgeState::Wall;
+        switch (dir) {
+            case Dir4::Up:
+                south[index - width] = state;
+                break;
+            case Dir4::Right:
+                east[index] = state;
+                break;
+            case Dir4::Down:
+                south[index] = state;
+                break;
+            case Dir4::Left:
+                east[index - 1] = state;
+                break;
+        }
+    }
+};
+
+/**
+ * @brief Checks every query of a bitboard against the model.
+ */
+template <int S>
+void checkMatches(const WallBitboard<S>& walls, const EdgeModel& model) {
+    bool matches = true;
+    for (int d = 0; d < 4; ++d) {
+        const auto dir = static_cast<Dir4>(d);
+        const auto open_towards = walls.openTowards(dir);
+        const auto may_be_open_towards = walls.mayBeOpenTowards(dir);
+        for (int i = 0; i < walls.numCells(); ++i) {
+            const auto state = model.at(i, dir);
+            const bool open = state == EdgeState::Open;
+            const bool may_be_open = state != EdgeState::Wall;
+            matches &= walls.isOpen(i, dir) == open;
+            matches &= walls.isKnown(i, dir) == (state != EdgeState::Unknown);
+            matches &= walls.mayBeOpen(i, dir) == may_be_open;
+            matches &= (walls.openMask(i) >> d & 1) == open;
+            matches &= (walls.mayBeOpenMask(i) >> d & 1) == may_be_open;
+            matches &= open_towards.test(i) == open;
+            matches &= may_be_open_towards.test(i) == may_be_open;
+        }
+    }
+    CHECK(matches);
+}
+
+/**
+ * @brief Moves random inner edges through the unknown, open and wall states
+ * with `setOpenAt()` from either side, checking the bitboard after each.
+ */
+template <int S>
+void checkTransitions(const MazeGeometry<S>& geometry, const int seed) {
+    auto walls = WallBitboard<S>::unknown(geometry);
+    EdgeModel model(geometry.width(), geometry.height());
+    checkMatches(walls, model);
+
+    // Every border edge is a known wall, and every inner edge is unknown
+    const int last = geometry.numCells() - 1;
+    CHECK(walls.openMask(0) == 0);
+    CHECK(walls.mayBeOpenMask(0) == (1 << static_cast<int>(Dir4::Right) |
+                                     1 << static_cast<int>(Dir4::Down)));
+    CHECK(walls.mayBeOpenMask(last) == (1 << static_cast<int>(Dir4::Up) |
+                                        1 << static_cast<int>(Dir4::Left)));
+
+    std::mt19937 rng(seed);
+    for (int n = 0; n < 4 * geometry.numCells(); ++n) {
+        const int index = static_cast<int>(rng() % geometry.numCells());
+        const auto dir = static_cast<Dir4>(rng() % 4);
+        if (!geometry.withinBounds(geometry.cellCoord(index), dir)) {
+            continue;
+        }
+
+        const bool open = rng() % 2 == 0;
+        walls.setOpenAt(index, dir, open);
+        model.set(index, dir, open);
+        if (n % 7 == 0) {
+            checkMatches(walls, model);
+        }
+    }
+    checkMatches(walls, model);
+
+    // Open, then closed again, from the other side of the edge
+    const int inner = geometry.cellIndex({ 1, 1 });
+    walls.setOpenAt(inner, Dir4::Up, true);
+    CHECK(walls.isOpen(inner - geometry.width(), Dir4::Down));
+    walls.setOpenAt(inner - geometry.width(), Dir4::Down, false);
+    CHECK(!walls.mayBeOpen(inner, Dir4::Up));
+    CHECK(walls.isKnown(inner, Dir4::Up));
+
+    bool rejected = false;
+    try {
+        walls.setOpen({ 0, 0 }, Dir4::Left, true);
+    } catch (const std::invalid_argument&) {
+        rejected = true;
+    }
+    CHECK(rejected);
+}
+
+/**
+ * @brief Checks that a new bitboard has every edge a known wall, and
+ * `allOpen()` every inner edge open.
+ */
+template <int S>
+void checkInitialStates(const MazeGeometry<S>& geometry) {
+    EdgeModel model(geometry.width(), geometry.height());
+    for (auto* states : { &model.east, &model.south }) {
+        states->assign(states->size(), EdgeState::Wall);
+    }
+    checkMatches(WallBitboard<S>(geometry), model);
+
+    for (auto* states : { &model.east, &model.south }) {
+        states->assign(states->size(), EdgeState::Open);
+    }
+    checkMatches(WallBitboard<S>::allOpen(geometry), model);
+}
+
+}  // namespace
+
+int main() {
+    checkInitialStates(MazeGeometry<16>{});
+    checkInitialStates(MazeGeometry<DYNAMIC_SIZE>(12, 20));
+    checkInitialStates(MazeGeometry<DYNAMIC_SIZE>(2, 2));
+
+    for (int seed = 0; seed < 5; ++seed) {
+        checkTransitions(MazeGeometry<4>{}, seed);
+        checkTransitions(MazeGeometry<16>{}, seed);
+        checkTransitions(MazeGeometry<DYNAMIC_SIZE>(2, 3), seed);
+        checkTransitions(MazeGeometry<DYNAMIC_SIZE>(12, 20), seed);
+        checkTransitions(MazeGeometry<DYNAMIC_SIZE>(33, 9), seed);
+    }
+
+    return checkResult("WallBitboardTest");
+}